@@ -4,6 +4,8 @@
 #include "Engine/Platform/Window.h"
 #include "Engine/System/File/FileSystem.h"
 #include "Engine/System/Thread/JobSystem.h"
+#include "Engine/System/Memory/FrameArena.h"
+#include "Engine/System/Memory/MemoryTracker.h"
 #include "Engine/Application/AppLoop.h"
 #include "Engine/Application/Rendering/Renderer.h"
 
@@ -32,6 +34,9 @@ namespace Engine {
 		INFO_MSG(u8"==> Job System");
 		jobSystem.Reset(MEMNEW(JobSystem()));
 
+		INFO_MSG(u8"==> Frame Arena");
+		frameArena.Reset(MEMNEW(FrameArena()));
+
 		INFO_MSG(u8"==> Window System");
 		windowSystem.Reset(MEMNEW(PLATFORM_SPECIFIC_CLASS_WINDOWMANAGER));
 
@@ -79,6 +84,9 @@ namespace Engine {
 	JobSystem* Engine::GetJobSystem() const {
 		return jobSystem.GetRaw();
 	}
+	FrameArena* Engine::GetFrameArena() const {
+		return frameArena.GetRaw();
+	}
 	Renderer* Engine::GetRenderer() const {
 		return renderer.GetRaw();
 	}
@@ -94,6 +102,8 @@ namespace Engine {
 		jobSystem->Start();
 		INFO_MSG(u8"Job system started.");
 
+		FrameArena::SetCurrent(frameArena.GetRaw());
+
 		appLoop->SetShouldRun(true);
 		appLoop->OnStart();
 		INFO_MSG(u8"App loop started.");
@@ -115,6 +125,8 @@ namespace Engine {
 			TimePoint now = Clock::now();
 
 			if (now >= nextUpdate) {
+				// Resume the jobs and tasks waiting for this frame.
+				jobSystem->AdvanceFrame();
 				windowSystem->Update();
 
 				time.unscaledDelta = std::chrono::duration_cast<Duration>(now - lastUpdate).count();
@@ -134,10 +146,17 @@ namespace Engine {
 				}
 #pragma endregion
 
+				// Transient data of the frame before the last one is gone from here on.
+				// Jobs still running may keep allocating, the frame they allocate from is not the one rewound.
+				frameArena->AdvanceFrame();
+				MemoryTracker::AdvanceFrame();
+
 				lastUpdate = now;
 				do {
 					nextUpdate += std::chrono::duration_cast<Clock::duration>(Duration(1.0 / GetTargetFps()));
 				} while (nextUpdate < lastUpdate);
+				// Background jobs stay out of the way of the next frame.
+				jobSystem->SetFrameDeadline(nextUpdate);
 
 				now = Clock::now();
 				std::this_thread::sleep_for(nextUpdate - now - Duration(0.005));
@@ -148,6 +167,7 @@ namespace Engine {
 #pragma region Stop
 		appLoop->OnStop();
 		jobSystem->Stop();
+		FrameArena::SetCurrent(nullptr);
 
 		INFO_MSG(u8"AppLoop finished running.");
 #pragma endregion
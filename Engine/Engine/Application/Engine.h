@@ -8,6 +8,7 @@ namespace Engine {
 	class WindowSystem;
 	class FileSystem;
 	class JobSystem;
+	class FrameArena;
 	class AppLoop;
 	class Renderer;
 
@@ -43,6 +44,8 @@ namespace Engine {
 		WindowSystem* GetWindowSystem() const;
 		FileSystem* GetFileSystem() const;
 		JobSystem* GetJobSystem() const;
+		/// @brief Get the arena for per-frame transient data. Rewound at the end of every frame.
+		FrameArena* GetFrameArena() const;
 		Renderer* GetRenderer() const;
 
 	private:
@@ -53,6 +56,7 @@ namespace Engine {
 		UniquePtr<WindowSystem> windowSystem;
 		UniquePtr<FileSystem> fileSystem;
 		UniquePtr<JobSystem> jobSystem;
+		UniquePtr<FrameArena> frameArena;
 		UniquePtr<Renderer> renderer;
 
 		float targetFps = 60;
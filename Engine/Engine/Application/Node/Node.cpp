@@ -28,7 +28,10 @@ namespace Engine {
 		return children.Get(index);
 	}
 	Node* Node::GetChildByName(const String& name) const {
-		if (name.GetCount() <= 0) {
+		return FindChildByName(name.GetU8StringView());
+	}
+	Node* Node::FindChildByName(std::u8string_view name) const {
+		if (name.empty()) {
 			return nullptr;
 		}
 		for (Node* child : children) {
@@ -200,15 +203,16 @@ namespace Engine {
 			split += 1;
 			String part = targetName.Substring(0, targetName.GetCount() - split);
 			for (uint32 i = 1; i <= 25565; i += 1) {
-				String candidate = String::Format(STRING_LITERAL("{0}{1}"), part, i);
+				// Most candidates are thrown away, keep them in the frame arena.
+				TransientString candidate = String::FormatTransient(STRING_LITERAL("{0}{1}"), part, i);
 				// Stop if the candidate name is the same as the original.
 				if (originalParent == targetParent && candidate == originalName) {
 					return originalName;
 				}
 				// Check if any node in targetParent is using the candidate name.
-				Node* node = targetParent->GetChildByName(candidate);
+				Node* node = targetParent->FindChildByName(candidate.GetU8StringView());
 				if (node == nullptr) {
-					return candidate;
+					return candidate.ToString();
 				}
 			}
 		}
@@ -2,7 +2,9 @@
 
 #include "Engine/System/Definition.h"
 #include "Engine/System/Object/Object.h"
+#include "Engine/System/Memory/ObjectPool.h"
 #include "Engine/System/Collection/List.h"
+#include "Engine/System/Collection/InlineList.h"
 #include "Engine/Application/Node/NodePath.h"
 
 namespace Engine {
@@ -11,6 +13,7 @@ namespace Engine {
 
 	class Node :public ManualObject {
 		REFLECTION_CLASS(::Engine::Node, ::Engine::ManualObject) {}
+		OBJECT_POOLED(::Engine::Node)
 
 	public:
 		Node();
@@ -131,7 +134,7 @@ namespace Engine {
 		String GetTreeStructureFormated(int32 level = 0) const;
 	private:
 		String name;
-		List<Node*> children{};
+		InlineList<Node*, 4> children{};
 		Node* parent = nullptr;
 		int index = -1;
 
@@ -144,6 +147,9 @@ namespace Engine {
 
 		friend class NodeTree;
 
+		/// @brief GetChildByName() without making a String, for names in the frame arena.
+		Node* FindChildByName(std::u8string_view name) const;
+
 		void SystemAssignTree(NodeTree* tree);
 		//void SystemRemoveFromTree();
 		void SystemUpdate(float delta);
@@ -7,6 +7,7 @@
 namespace Engine {
 	class Node2D :public Node {
 		REFLECTION_CLASS(::Engine::Node2D, ::Engine::Node) {}
+		OBJECT_POOLED(::Engine::Node2D)
 
 	public:
 		Vector2 GetPosition() const;
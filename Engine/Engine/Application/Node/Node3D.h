@@ -8,6 +8,7 @@
 namespace Engine {
 	class Node3D :public Node {
 		REFLECTION_CLASS(::Engine::Node3D, ::Engine::Node) {}
+		OBJECT_POOLED(::Engine::Node3D)
 
 	public:
 		Vector3 GetPosition() const;
@@ -1,6 +1,6 @@
 #pragma once
 
-#include "Engine/System/Collection/List.h"
+#include "Engine/System/Collection/InlineList.h"
 #include "Engine/System/Memory/SharedPtr.h"
 #include "Engine/System/String.h"
 
@@ -19,8 +19,8 @@ namespace Engine {
 	private:
 		struct Data {
 			bool absolute = false;
-			List<String> names{};
-			List<String> subnames{};
+			InlineList<String, 4> names{};
+			InlineList<String, 2> subnames{};
 		};
 		SharedPtr<Data> data;
 	};
@@ -0,0 +1,447 @@
+#pragma once
+#include "Engine/System/Definition.h"
+#include "Engine/System/Memory/Memory.h"
+#include <bit>
+#include <type_traits>
+
+namespace Engine {
+	class ParallelAlgorithm;
+
+	/// @brief Sorting and searching over contiguous elements, like List::GetRawElementPtr().\n
+	/// Every function takes a pointer to the first element and a count.
+	/// less(a, b) orders like a < b and must be a strict weak ordering, see Algorithm::Less.
+	class Algorithm final {
+	public:
+		STATIC_CLASS(Algorithm);
+
+		/// @brief Orders with operator<.
+		struct Less {
+			template<typename T>
+			bool operator()(const T& a, const T& b) const {
+				return a < b;
+			}
+		};
+		/// @brief Compares with operator==.
+		struct Equal {
+			template<typename T>
+			bool operator()(const T& a, const T& b) const {
+				return a == b;
+			}
+		};
+		/// @brief Uses the value itself as its radix sort key.
+		struct Identity {
+			template<typename T>
+			const T& operator()(const T& value) const {
+				return value;
+			}
+		};
+
+		/// @brief Ranges this short are insertion sorted.
+		static inline constexpr int32 InsertionSortThreshold = 16;
+		/// @brief Length of the runs StableSort() insertion sorts before merging them.
+		static inline constexpr int32 StableRunLength = 32;
+
+#pragma region Search
+		/// @brief Get the index of the first element not less than value, count if there is none. values must be sorted by less.
+		template<typename T, typename TValue, typename TLess = Less>
+		static int32 LowerBound(const T* values, int32 count, const TValue& value, TLess less = {}) {
+			int32 first = 0;
+			while (count > 0) {
+				int32 half = count / 2;
+				if (less(values[first + half], value)) {
+					first += half + 1;
+					count -= half + 1;
+				} else {
+					count = half;
+				}
+			}
+			return first;
+		}
+		/// @brief Get the index of the first element greater than value, count if there is none. values must be sorted by less.
+		template<typename T, typename TValue, typename TLess = Less>
+		static int32 UpperBound(const T* values, int32 count, const TValue& value, TLess less = {}) {
+			int32 first = 0;
+			while (count > 0) {
+				int32 half = count / 2;
+				if (!less(value, values[first + half])) {
+					first += half + 1;
+					count -= half + 1;
+				} else {
+					count = half;
+				}
+			}
+			return first;
+		}
+		/// @brief Find an element equivalent to value. values must be sorted by less.
+		/// @return The index of the first such element, -1 if there is none.
+		template<typename T, typename TValue, typename TLess = Less>
+		static int32 BinarySearch(const T* values, int32 count, const TValue& value, TLess less = {}) {
+			int32 index = LowerBound(values, count, value, less);
+			return index < count && !less(value, values[index]) ? index : -1;
+		}
+		template<typename T, typename TLess = Less>
+		static bool IsSorted(const T* values, int32 count, TLess less = {}) {
+			for (int32 i = 1; i < count; i += 1) {
+				if (less(values[i], values[i - 1])) {
+					return false;
+				}
+			}
+			return true;
+		}
+#pragma endregion
+
+#pragma region Rearrange
+		/// @brief Move the elements matching predicate to the front. Does not keep their order.
+		/// @return The count of matching elements, the index of the first one that does not match.
+		template<typename T, typename TPredicate>
+		static int32 Partition(T* values, int32 count, TPredicate predicate) {
+			int32 first = 0;
+			int32 last = count;
+			while (true) {
+				while (first < last && predicate(values[first])) {
+					first += 1;
+				}
+				do {
+					last -= 1;
+				} while (first < last && !predicate(values[last]));
+				if (first >= last) {
+					return first;
+				}
+				Swap(values[first], values[last]);
+				first += 1;
+			}
+		}
+		/// @brief Drop the elements equal to the one before them, keeping the first of each run.\n
+		/// Sort first to drop every duplicate. The elements behind the new count are left moved from.
+		/// @return The new count.
+		template<typename T, typename TEqual = Equal>
+		static int32 Unique(T* values, int32 count, TEqual equal = {}) {
+			if (count == 0) {
+				return 0;
+			}
+			int32 last = 0;
+			for (int32 i = 1; i < count; i += 1) {
+				if (!equal(values[last], values[i])) {
+					last += 1;
+					if (last != i) {
+						values[last] = Memory::Move(values[i]);
+					}
+				}
+			}
+			return last + 1;
+		}
+		template<typename T>
+		static void Reverse(T* values, int32 count) {
+			for (int32 i = 0, j = count - 1; i < j; i += 1, j -= 1) {
+				Swap(values[i], values[j]);
+			}
+		}
+		template<typename T>
+		static void Swap(T& a, T& b) {
+			T temp(Memory::Move(a));
+			a = Memory::Move(b);
+			b = Memory::Move(temp);
+		}
+#pragma endregion
+
+#pragma region Sort
+		/// @brief Sort in place, not stable. Introsort: quicksort with a median of three pivot,
+		/// falling back to heapsort when the partitions go bad, so O(n log n) in every case. Never allocates.
+		template<typename T, typename TLess = Less>
+		static void Sort(T* values, int32 count, TLess less = {}) {
+			if (count < 2) {
+				return;
+			}
+			IntroSort(values, values + count, 2 * static_cast<int32>(std::bit_width(static_cast<uint32>(count))), less);
+		}
+		/// @brief Sort in place, stable. O(n^2), only for short or nearly sorted ranges.
+		template<typename T, typename TLess = Less>
+		static void InsertionSort(T* values, int32 count, TLess less = {}) {
+			for (int32 i = 1; i < count; i += 1) {
+				if (!less(values[i], values[i - 1])) {
+					continue;
+				}
+				T value(Memory::Move(values[i]));
+				int32 j = i;
+				do {
+					values[j] = Memory::Move(values[j - 1]);
+					j -= 1;
+				} while (j > 0 && less(value, values[j - 1]));
+				values[j] = Memory::Move(value);
+			}
+		}
+		/// @brief Sort in place, not stable. O(n log n) in every case, never allocates.
+		template<typename T, typename TLess = Less>
+		static void HeapSort(T* values, int32 count, TLess less = {}) {
+			for (int32 i = count / 2 - 1; i >= 0; i -= 1) {
+				SiftDown(values, i, count, less);
+			}
+			for (int32 end = count - 1; end > 0; end -= 1) {
+				Swap(values[0], values[end]);
+				SiftDown(values, 0, end, less);
+			}
+		}
+		/// @brief Sort in place, elements which are equivalent keep their order.\n
+		/// Bottom-up merge sort over insertion sorted runs, allocates a buffer of count elements.
+		template<typename T, typename TLess = Less>
+		static void StableSort(T* values, int32 count, TLess less = {}) {
+			for (int32 i = 0; i < count; i += StableRunLength) {
+				InsertionSort(values + i, count - i < StableRunLength ? count - i : StableRunLength, less);
+			}
+			if (count <= StableRunLength) {
+				return;
+			}
+
+			T* buffer = (T*)Memory::Allocate(count * sizeof(T));
+			T* source = values;
+			T* target = buffer;
+			bool constructed = false;
+			for (int32 run = StableRunLength; run < count; run *= 2) {
+				for (int32 i = 0; i < count; i += run * 2) {
+					int32 middle = count - i < run ? count : i + run;
+					int32 end = count - i < run * 2 ? count : i + run * 2;
+					if (constructed) {
+						Merge<false>(source + i, middle - i, source + middle, end - middle, target + i, less);
+					} else {
+						Merge<true>(source + i, middle - i, source + middle, end - middle, target + i, less);
+					}
+				}
+				constructed = true;
+				T* swap = source;
+				source = target;
+				target = swap;
+			}
+
+			if (source == buffer) {
+				for (int32 i = 0; i < count; i += 1) {
+					values[i] = Memory::Move(buffer[i]);
+				}
+			}
+			FreeBuffer(buffer, count);
+		}
+		/// @brief Sort by integer or floating point keys, stable. LSD radix sort over bytes, O(n) for a fixed key size.\n
+		/// Passes over a byte which is the same in every key are skipped. Allocates a buffer of count elements.
+		/// Floating point keys sort like <, with -0 before 0. NaN keys end up at the ends.
+		/// @param keyOf Called as keyOf(const T&), returns the key, see Algorithm::Identity.
+		template<typename T, typename TKeyOf = Identity>
+		static void RadixSort(T* values, int32 count, TKeyOf keyOf = {}) {
+			using Key = decltype(ToRadixKey(keyOf(*values)));
+			constexpr int32 PassCount = sizeof(Key);
+			if (count < 2) {
+				return;
+			}
+			if (count <= InsertionSortThreshold) {
+				InsertionSort(values, count, [&keyOf](const T& a, const T& b) {
+					return ToRadixKey(keyOf(a)) < ToRadixKey(keyOf(b));
+				});
+				return;
+			}
+
+			// Count the digits of every pass at once.
+			int32 histograms[PassCount][RadixDigitCount] = {};
+			for (int32 i = 0; i < count; i += 1) {
+				Key key = ToRadixKey(keyOf(values[i]));
+				for (int32 pass = 0; pass < PassCount; pass += 1) {
+					histograms[pass][(key >> (pass * 8)) & (RadixDigitCount - 1)] += 1;
+				}
+			}
+
+			T* buffer = nullptr;
+			T* source = values;
+			T* target = nullptr;
+			bool constructed = false;
+			Key firstKey = ToRadixKey(keyOf(values[0]));
+			for (int32 pass = 0; pass < PassCount; pass += 1) {
+				int32* histogram = histograms[pass];
+				if (histogram[(firstKey >> (pass * 8)) & (RadixDigitCount - 1)] == count) {
+					continue;
+				}
+				if (buffer == nullptr) {
+					buffer = (T*)Memory::Allocate(count * sizeof(T));
+					target = buffer;
+				}
+
+				int32 offset = 0;
+				for (int32 digit = 0; digit < RadixDigitCount; digit += 1) {
+					int32 digitCount = histogram[digit];
+					histogram[digit] = offset;
+					offset += digitCount;
+				}
+				bool construct = target == buffer && !constructed;
+				for (int32 i = 0; i < count; i += 1) {
+					int32 digit = static_cast<int32>((ToRadixKey(keyOf(source[i])) >> (pass * 8)) & (RadixDigitCount - 1));
+					T* slot = target + histogram[digit];
+					histogram[digit] += 1;
+					if (construct) {
+						Memory::Construct(slot, Memory::Move(source[i]));
+					} else {
+						*slot = Memory::Move(source[i]);
+					}
+				}
+				constructed = constructed || construct;
+				T* swap = source;
+				source = target;
+				target = swap;
+			}
+
+			if (buffer == nullptr) {
+				return;
+			}
+			if (source == buffer) {
+				for (int32 i = 0; i < count; i += 1) {
+					values[i] = Memory::Move(buffer[i]);
+				}
+			}
+			FreeBuffer(buffer, count);
+		}
+		/// @brief Map a key to an unsigned integer ordered the same way.
+		template<typename TKey>
+		static auto ToRadixKey(TKey key) {
+			static_assert(std::is_arithmetic_v<TKey> && !std::is_same_v<TKey, bool>, "Radix sort keys are integers or floating point numbers.");
+			if constexpr (std::is_floating_point_v<TKey>) {
+				static_assert(sizeof(TKey) == 4 || sizeof(TKey) == 8, "Unsupported floating point key.");
+				using Bits = std::conditional_t<sizeof(TKey) == 4, uint32, uint64>;
+				constexpr Bits SignBit = static_cast<Bits>(1) << (sizeof(TKey) * 8 - 1);
+				Bits bits = std::bit_cast<Bits>(key);
+				// Negative numbers flip every bit so larger magnitudes come first, positive ones only the sign bit.
+				return bits ^ (static_cast<Bits>(0 - (bits >> (sizeof(TKey) * 8 - 1))) | SignBit);
+			} else {
+				using Bits = std::make_unsigned_t<TKey>;
+				Bits bits = static_cast<Bits>(key);
+				if constexpr (std::is_signed_v<TKey>) {
+					bits ^= static_cast<Bits>(static_cast<Bits>(1) << (sizeof(TKey) * 8 - 1));
+				}
+				return bits;
+			}
+		}
+#pragma endregion
+
+	private:
+		friend class ParallelAlgorithm;
+
+		static inline constexpr int32 RadixDigitCount = 256;
+
+		template<typename T, typename TLess>
+		static void IntroSort(T* first, T* last, int32 depth, TLess& less) {
+			while (last - first > InsertionSortThreshold) {
+				if (depth == 0) {
+					HeapSort(first, static_cast<int32>(last - first), less);
+					return;
+				}
+				depth -= 1;
+
+				T* cut = PartitionAroundPivot(first, last, less);
+				// Recurse into the smaller side, so the stack stays O(log n).
+				if (cut - first < last - cut) {
+					IntroSort(first, cut, depth, less);
+					first = cut;
+				} else {
+					IntroSort(cut, last, depth, less);
+					last = cut;
+				}
+			}
+			InsertionSort(first, static_cast<int32>(last - first), less);
+		}
+		/// @brief Move the median of three to the front as the pivot and partition the rest around it.\n
+		/// The smallest and largest of the three stop the scans, so they need no bounds checks.
+		/// @return The first element of the right side. Neither side is empty.
+		template<typename T, typename TLess>
+		static T* PartitionAroundPivot(T* first, T* last, TLess& less) {
+			T* a = first + 1;
+			T* b = first + (last - first) / 2;
+			T* c = last - 1;
+			if (less(*a, *b)) {
+				if (less(*b, *c)) {
+					Swap(*first, *b);
+				} else if (less(*a, *c)) {
+					Swap(*first, *c);
+				} else {
+					Swap(*first, *a);
+				}
+			} else if (less(*a, *c)) {
+				Swap(*first, *a);
+			} else if (less(*b, *c)) {
+				Swap(*first, *c);
+			} else {
+				Swap(*first, *b);
+			}
+
+			T* left = first + 1;
+			T* right = last;
+			while (true) {
+				while (less(*left, *first)) {
+					left += 1;
+				}
+				right -= 1;
+				while (less(*first, *right)) {
+					right -= 1;
+				}
+				if (left >= right) {
+					return left;
+				}
+				Swap(*left, *right);
+				left += 1;
+			}
+		}
+		template<typename T, typename TLess>
+		static void SiftDown(T* values, int32 index, int32 count, TLess& less) {
+			T value(Memory::Move(values[index]));
+			while (true) {
+				int32 child = index * 2 + 1;
+				if (child >= count) {
+					break;
+				}
+				if (child + 1 < count && less(values[child], values[child + 1])) {
+					child += 1;
+				}
+				if (!less(value, values[child])) {
+					break;
+				}
+				values[index] = Memory::Move(values[child]);
+				index = child;
+			}
+			values[index] = Memory::Move(value);
+		}
+		/// @brief Merge two sorted ranges into target, taking from a first on ties.
+		/// @tparam Construct Whether target is raw memory to construct the elements in, or holds elements to assign to.
+		template<bool Construct, typename T, typename TLess>
+		static void Merge(T* a, int32 aCount, T* b, int32 bCount, T* target, TLess& less) {
+			T* aEnd = a + aCount;
+			T* bEnd = b + bCount;
+			while (a < aEnd && b < bEnd) {
+				if (less(*b, *a)) {
+					Place<Construct>(target, *b);
+					b += 1;
+				} else {
+					Place<Construct>(target, *a);
+					a += 1;
+				}
+				target += 1;
+			}
+			for (; a < aEnd; a += 1, target += 1) {
+				Place<Construct>(target, *a);
+			}
+			for (; b < bEnd; b += 1, target += 1) {
+				Place<Construct>(target, *b);
+			}
+		}
+		/// @brief Destruct the elements of a sort buffer and free it.
+		template<typename T>
+		static void FreeBuffer(T* buffer, int32 count) {
+			if constexpr (Memory::IsDestructionNeeded<T>()) {
+				for (int32 i = 0; i < count; i += 1) {
+					Memory::Destruct(buffer + i);
+				}
+			}
+			Memory::Deallocate(buffer);
+		}
+		template<bool Construct, typename T>
+		static void Place(T* target, T& value) {
+			if constexpr (Construct) {
+				Memory::Construct(target, Memory::Move(value));
+			} else {
+				*target = Memory::Move(value);
+			}
+		}
+	};
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include "Engine/System/Collection/Dictionary.h"
+#include "Engine/System/Thread/ThreadUtil.h"
+
+namespace Engine {
+	/// @brief A hashmap shared between threads.\n
+	/// Keys are spread over ShardCount Dictionaries, each behind its own lock,
+	/// so threads touching different keys rarely wait for each other.
+	/// Values are copied in and out, nothing points into the map after a call returns.
+	/// @tparam TKey The key type. See Dictionary.
+	/// @tparam TValue The value type. See Dictionary.
+	/// @tparam ShardCount How many Dictionaries the keys are spread over. Must be a power of 2.
+	template<typename TKey, typename TValue, int32 ShardCount = 64>
+	class ConcurrentDictionary final {
+		static_assert(ShardCount > 0 && (ShardCount & (ShardCount - 1)) == 0, "ShardCount must be a power of 2.");
+	public:
+		/// @param capacity Entries expected in total, spread evenly over the shards.
+		ConcurrentDictionary(int32 capacity = 0) {
+			if (capacity <= 0) {
+				return;
+			}
+			int32 shardCapacity = (capacity + ShardCount - 1) / ShardCount;
+			for (Shard& shard : shards) {
+				shard.dictionary.SetCapacity(shardCapacity);
+			}
+		}
+
+		ConcurrentDictionary(const ConcurrentDictionary&) = delete;
+		ConcurrentDictionary& operator=(const ConcurrentDictionary&) = delete;
+
+		bool Add(const TKey& key, const TValue& value) {
+			int32 hashCode = ObjectUtil::GetHashCode(key);
+			Shard& shard = GetShard(hashCode);
+			auto lock = SimpleLock<Mutex>(shard.mutex);
+			return shard.dictionary.Add(key, value);
+		}
+		void Set(const TKey& key, const TValue& value) {
+			Shard& shard = GetShard(ObjectUtil::GetHashCode(key));
+			auto lock = SimpleLock<Mutex>(shard.mutex);
+			shard.dictionary.Set(key, value);
+		}
+		bool Remove(const TKey& key) {
+			Shard& shard = GetShard(ObjectUtil::GetHashCode(key));
+			auto lock = SimpleLock<Mutex>(shard.mutex);
+			return shard.dictionary.Remove(key);
+		}
+
+		bool ContainsKey(const TKey& key) const {
+			TValue ignored{};
+			return TryGet(key, ignored);
+		}
+		bool TryGet(const TKey& key, TValue& result) const {
+			int32 hashCode = ObjectUtil::GetHashCode(key);
+			const Shard& shard = GetShard(hashCode);
+			auto lock = SimpleLock<Mutex>(shard.mutex);
+			return shard.dictionary.TryGetWithHash(key, hashCode, result);
+		}
+
+		/// @brief Get the entry count. Only a snapshot while other threads keep changing it.
+		int32 GetCount() const {
+			int32 result = 0;
+			for (const Shard& shard : shards) {
+				auto lock = SimpleLock<Mutex>(shard.mutex);
+				result += shard.dictionary.GetCount();
+			}
+			return result;
+		}
+		void Clear() {
+			for (Shard& shard : shards) {
+				auto lock = SimpleLock<Mutex>(shard.mutex);
+				shard.dictionary.Clear();
+			}
+		}
+
+	private:
+		/// @brief Locks are held for a single lookup, a plain mutex is cheaper than a reader-writer one here.
+		struct alignas(ThreadUtil::CacheLineSize) Shard {
+			mutable Mutex mutex;
+			Dictionary<TKey, TValue> dictionary{};
+		};
+
+		/// @brief Pick the shard from the low bits, Dictionary picks slots from the top bits of its own mix.
+		Shard& GetShard(int32 hashCode) {
+			uint32 hash = static_cast<uint32>(hashCode);
+			return shards[(hash ^ (hash >> 16)) & (ShardCount - 1)];
+		}
+		const Shard& GetShard(int32 hashCode) const {
+			uint32 hash = static_cast<uint32>(hashCode);
+			return shards[(hash ^ (hash >> 16)) & (ShardCount - 1)];
+		}
+
+		Shard shards[ShardCount];
+	};
+}
@@ -1,138 +1,286 @@
 #pragma once
 #include "Engine/System/Definition.h"
-#include "Engine/System/Collection/List.h"
-#include "Engine/System/Memory/SharedPtr.h"
+#include "Engine/System/Memory/Memory.h"
+#include "Engine/System/Debug.h"
 
 namespace Engine {
+	/// @brief The default chunk size of Deque, chunks of about 512 bytes and at least 4 elements.
 	template<typename T>
+	inline constexpr int32 DequeChunkSize = sizeof(T) <= 4 ? 128 : sizeof(T) <= 8 ? 64 : sizeof(T) <= 16 ? 32 : sizeof(T) <= 32 ? 16 : sizeof(T) <= 64 ? 8 : 4;
+
+	/// @brief A double-ended queue with random access.\n
+	/// Elements live in fixed-size chunks, found through a power of 2 ring of chunk pointers.
+	/// Pushing at either end never moves elements, growing only copies the chunk pointers.
+	/// Chunks emptied by popping are kept for reuse, so a queue going round costs no allocation. ShrinkToFit() gives them back.
+	/// @tparam T The value type. Needs to be move-constructable, copying the deque also needs it to be copy-constructable.
+	/// @tparam Allocator Where the chunks live, see HeapAllocator.
+	/// @tparam ChunkSize Elements per chunk. Must be a power of 2.
+	template<typename T, typename Allocator = HeapAllocator, int32 ChunkSize = DequeChunkSize<T>>
 	class Deque final {
+		static_assert(ChunkSize > 0 && (ChunkSize & (ChunkSize - 1)) == 0, "ChunkSize must be a power of 2.");
+		static_assert(alignof(T) <= Memory::Alignment, "Allocator blocks are only aligned to Memory::Alignment.");
 	public:
+		TRIVIALLY_RELOCATABLE;
+
+		Deque() = default;
 		~Deque() {
-			Clear();
+			Destroy();
 		}
 
-		void PushFront(const T& value) {
-			int32 chunkIndex = PrepareChunk(GetChunkIndex(frontIndex));
-			SharedPtr<ElementChunk> chunk = chunks.Get(chunkIndex);
-			
-			T* ptr = chunk->elements + GetElementIndexInChunk(frontIndex);
-			Memory::Construct(ptr, value);
+		Deque(const Deque& obj) {
+			CopyFromOther(obj);
+		}
+		Deque& operator=(const Deque& obj) {
+			if (this == &obj) {
+				return *this;
+			}
 
-			frontIndex -= 1;
+			Destroy();
+			CopyFromOther(obj);
+
+			return *this;
 		}
-		void PushBack(const T& value) {
-			int32 chunkIndex = PrepareChunk(GetChunkIndex(backIndex));
-			SharedPtr<ElementChunk> chunk = chunks.Get(chunkIndex);
 
-			T* ptr = chunk->elements + GetElementIndexInChunk(backIndex);
-			Memory::Construct(ptr, value);
+		Deque(Deque&& obj) :chunks(obj.chunks), chunkCount(obj.chunkCount), head(obj.head), count(obj.count) {
+			obj.Reset();
+		}
+		Deque& operator=(Deque&& obj) {
+			if (this == &obj) {
+				return *this;
+			}
 
-			backIndex += 1;
+			Destroy();
+			chunks = obj.chunks;
+			chunkCount = obj.chunkCount;
+			head = obj.head;
+			count = obj.count;
+			obj.Reset();
+
+			return *this;
+		}
+
+		void PushFront(const T& value) {
+			EmplaceFront(value);
+		}
+		void PushFront(T&& value) {
+			EmplaceFront(Memory::Move(value));
+		}
+		void PushBack(const T& value) {
+			EmplaceBack(value);
+		}
+		void PushBack(T&& value) {
+			EmplaceBack(Memory::Move(value));
+		}
+		/// @brief Construct a new element at the front from the arguments.
+		/// @return The new element, valid until it is popped.
+		template<typename ... Args>
+		T& EmplaceFront(Args&& ... args) {
+			// Growing never moves elements, arguments pointing into this deque stay valid.
+			EnsureRoom();
+			int32 position = (head - 1) & GetPositionMask();
+			T* ptr = PrepareElementPtr(position);
+			Memory::Construct(ptr, Memory::Forward<Args>(args)...);
+			head = position;
+			count += 1;
+			return *ptr;
+		}
+		/// @brief Construct a new element at the back from the arguments.
+		/// @return The new element, valid until it is popped.
+		template<typename ... Args>
+		T& EmplaceBack(Args&& ... args) {
+			EnsureRoom();
+			T* ptr = PrepareElementPtr((head + count) & GetPositionMask());
+			Memory::Construct(ptr, Memory::Forward<Args>(args)...);
+			count += 1;
+			return *ptr;
 		}
 		bool TryPopFront(T& result) {
-			if (GetCount() <= 0) {
+			if (count <= 0) {
 				return false;
 			}
-			frontIndex += 1;
-			
-			int32 chunkIndex = GetChunkIndex(frontIndex);
-			SharedPtr<ElementChunk> chunk = chunks.Get(chunkIndex);
-			result = chunk->elements[GetElementIndexInChunk(frontIndex)];
 
-			Memory::Destruct(chunk->elements + GetElementIndexInChunk(frontIndex));
+			T* ptr = GetElementPtr(head);
+			result = Memory::Move(*ptr);
+			Memory::Destruct(ptr);
+			head = (head + 1) & GetPositionMask();
+			count -= 1;
 			return true;
 		}
 		bool TryPopBack(T& result) {
-			if (GetCount() <= 0) {
+			if (count <= 0) {
 				return false;
 			}
-			backIndex -= 1;
-
-			int32 chunkIndex = GetChunkIndex(backIndex);
-			SharedPtr<ElementChunk> chunk = chunks.Get(chunkIndex);
-			result = chunk->elements[GetElementIndexInChunk(backIndex)];
 
-			Memory::Destruct(chunk->elements + GetElementIndexInChunk(backIndex));
+			T* ptr = GetElementPtr((head + count - 1) & GetPositionMask());
+			result = Memory::Move(*ptr);
+			Memory::Destruct(ptr);
+			count -= 1;
 			return true;
 		}
 		T PopFront() {
-			T result;
-			bool succeeded = TryPopFront(result);
-			ERR_ASSERT(succeeded, u8"Cannot pop from front!", return T());
+			ERR_ASSERT(count > 0, u8"Cannot pop from front!", return T());
+			T* ptr = GetElementPtr(head);
+			T result(Memory::Move(*ptr));
+			Memory::Destruct(ptr);
+			head = (head + 1) & GetPositionMask();
+			count -= 1;
 			return result;
 		}
 		T PopBack() {
-			T result;
-			bool succeeded = TryPopBack(result);
-			ERR_ASSERT(succeeded, u8"Cannot pop from back!", return T());
+			ERR_ASSERT(count > 0, u8"Cannot pop from back!", return T());
+			T* ptr = GetElementPtr((head + count - 1) & GetPositionMask());
+			T result(Memory::Move(*ptr));
+			Memory::Destruct(ptr);
+			count -= 1;
 			return result;
 		}
+
+		/// @brief Get the element at index, counted from the front.
+		T Get(int32 index) const {
+			ERR_ASSERT(index >= 0 && index < count, u8"index out of bounds.", return T());
+			return *GetElementPtr((head + index) & GetPositionMask());
+		}
+		void Set(int32 index, const T& value) {
+			ERR_ASSERT(index >= 0 && index < count, u8"index out of bounds.", return);
+			*GetElementPtr((head + index) & GetPositionMask()) = value;
+		}
+		void Set(int32 index, T&& value) {
+			ERR_ASSERT(index >= 0 && index < count, u8"index out of bounds.", return);
+			*GetElementPtr((head + index) & GetPositionMask()) = Memory::Move(value);
+		}
+		T& operator[](int32 index) {
+			return *GetElementPtr((head + index) & GetPositionMask());
+		}
+		const T& operator[](int32 index) const {
+			return *GetElementPtr((head + index) & GetPositionMask());
+		}
+
 		int32 GetCount() const {
-			return backIndex - frontIndex - 1;
+			return count;
+		}
+		/// @brief Get the count of allocated chunks, spare ones kept for reuse included.
+		int32 GetAllocatedChunkCount() const {
+			int32 result = 0;
+			for (int32 i = 0; i < chunkCount; i += 1) {
+				result += (chunks[i] != nullptr);
+			}
+			return result;
 		}
+		/// @brief Destruct every element. The chunks are kept.
 		void Clear() {
-			int32 lastChunkIndex = -1;
-			SharedPtr<ElementChunk> lastChunk;
-			for (int i = frontIndex + 1; i < backIndex; i += 1) {
-				int32 chunkIndex = GetChunkIndex(i);
-				if (lastChunkIndex != chunkIndex) {
-					lastChunkIndex = chunkIndex;
-					lastChunk = chunks.Get(chunkIndex);
+			for (int32 i = 0; i < count; i += 1) {
+				Memory::Destruct(GetElementPtr((head + i) & GetPositionMask()));
+			}
+			head = 0;
+			count = 0;
+		}
+		/// @brief Free the spare chunks and shrink the chunk ring to what the elements need.
+		void ShrinkToFit() {
+			if (count == 0) {
+				Destroy();
+				return;
+			}
+
+			int32 firstChunk = head / ChunkSize;
+			int32 usedChunkCount = GetUsedChunkCount();
+			int32 newChunkCount = GetChunkCountFor(count);
+			T** newChunks = (T**)Allocator::Allocate(newChunkCount * sizeof(T*));
+			for (int32 i = 0; i < chunkCount; i += 1) {
+				T* chunk = chunks[(firstChunk + i) & (chunkCount - 1)];
+				if (i < usedChunkCount) {
+					newChunks[i] = chunk;
+				} else if (chunk != nullptr) {
+					Allocator::Deallocate(chunk);
 				}
-				Memory::Destruct(lastChunk->elements + GetElementIndexInChunk(i));
 			}
+			for (int32 i = usedChunkCount; i < newChunkCount; i += 1) {
+				newChunks[i] = nullptr;
+			}
+			Allocator::Deallocate(chunks);
 
-			frontIndex = -1;
-			backIndex = 0;
+			chunks = newChunks;
+			chunkCount = newChunkCount;
+			head = head & (ChunkSize - 1);
 		}
 
-		static inline constexpr int32 ChunkSize = 8;
-
 	private:
-		struct ElementChunk {
-			ElementChunk() {
-				elements = (T*)Memory::Allocate(sizeof(T) * ChunkSize);
-			}
-			~ElementChunk() {
-				Memory::Deallocate(elements);
-			}
-			T* elements;
-		};
-		//                                  CenterChunk
-		// [ *  *  *  *  *  *  *  * ] [ *  *  *  *  *  *  *  * ]
-		//  -8 -7 -6 -5 -4 -3 -2 -1     0  1  2  3  4  5  6  7
-		List<SharedPtr<ElementChunk>> chunks{};
-
-		int32 frontIndex = -1;
-		int32 backIndex = 0;
-		int32 centerChunk = -1;
-
-
-		int32 GetChunkIndex(int32 elementIndex) const {
-			if (elementIndex >= 0) {
-				return elementIndex / ChunkSize + centerChunk;
-			} else {
-				return (elementIndex + 1) / ChunkSize - 1 + centerChunk;
-			}
-		}
-		int32 GetElementIndexInChunk(int32 elementIndex) const {
-			if (elementIndex >= 0) {
-				return elementIndex % ChunkSize;
-			} else {
-				return (ChunkSize - 1) - ((-elementIndex - 1) % ChunkSize);
-			}
-		}
-		int32 PrepareChunk(int32 chunkIndex) {
-			while (chunkIndex < 0 || chunkIndex >= chunks.GetCount()) {
-				if (chunkIndex < 0) {
-					chunks.Insert(0, SharedPtr<ElementChunk>::Create());
-					centerChunk += 1;
-					chunkIndex += 1;
-				} else if (chunkIndex >= chunks.GetCount()) {
-					chunks.Add(SharedPtr<ElementChunk>::Create());
-				}
+		// chunks     [0]         [1]         [2]       [3]
+		//        [ . . . . ] [ . * * * ] [ * . . . ]  null
+		//                        ^ head = 5  ^ head + count = 9
+		// Positions run over chunkCount * ChunkSize elements and wrap around.
+		// At least ChunkSize positions stay empty, so the front and the back never share a chunk.
+		T** chunks = nullptr;
+		int32 chunkCount = 0;
+		int32 head = 0;
+		int32 count = 0;
+
+		int32 GetPositionMask() const {
+			return chunkCount * ChunkSize - 1;
+		}
+		T* GetElementPtr(int32 position) const {
+			return chunks[static_cast<uint32>(position) / ChunkSize] + (position & (ChunkSize - 1));
+		}
+		/// @brief Get the element slot at a position, allocating its chunk if needed.
+		T* PrepareElementPtr(int32 position) {
+			T*& chunk = chunks[static_cast<uint32>(position) / ChunkSize];
+			if (chunk == nullptr) {
+				chunk = (T*)Allocator::Allocate(ChunkSize * sizeof(T));
+			}
+			return chunk + (position & (ChunkSize - 1));
+		}
+		/// @brief Get the count of chunks holding elements.
+		int32 GetUsedChunkCount() const {
+			return ((head & (ChunkSize - 1)) + count + ChunkSize - 1) / ChunkSize;
+		}
+		/// @brief Get the smallest ring holding count elements with one chunk to spare.
+		static int32 GetChunkCountFor(int32 count) {
+			int32 result = 2;
+			while ((result - 1) * ChunkSize < count) {
+				result *= 2;
 			}
-			return chunkIndex;
+			return result;
+		}
+		/// @brief Make room for one more element, doubling the ring if needed.\n
+		/// The chunk pointers are copied in order from the front chunk, the elements stay where they are.
+		void EnsureRoom() {
+			if (count < (chunkCount - 1) * ChunkSize) {
+				return;
+			}
+
+			int32 newChunkCount = chunkCount == 0 ? 2 : chunkCount * 2;
+			T** newChunks = (T**)Allocator::Allocate(newChunkCount * sizeof(T*));
+			int32 firstChunk = head / ChunkSize;
+			for (int32 i = 0; i < chunkCount; i += 1) {
+				newChunks[i] = chunks[(firstChunk + i) & (chunkCount - 1)];
+			}
+			for (int32 i = chunkCount; i < newChunkCount; i += 1) {
+				newChunks[i] = nullptr;
+			}
+			Allocator::Deallocate(chunks);
+
+			chunks = newChunks;
+			chunkCount = newChunkCount;
+			head = head & (ChunkSize - 1);
+		}
+
+		void CopyFromOther(const Deque& obj) {
+			for (int32 i = 0; i < obj.count; i += 1) {
+				PushBack(obj[i]);
+			}
+		}
+		void Destroy() {
+			Clear();
+			for (int32 i = 0; i < chunkCount; i += 1) {
+				Allocator::Deallocate(chunks[i]);
+			}
+			Allocator::Deallocate(chunks);
+			Reset();
+		}
+		void Reset() {
+			chunks = nullptr;
+			chunkCount = 0;
+			head = 0;
+			count = 0;
 		}
 	};
-}
\ No newline at end of file
+}
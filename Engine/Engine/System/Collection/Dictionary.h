@@ -1,24 +1,75 @@
 #pragma once
 #include "Engine/System/Object/ObjectUtil.h"
-#include "Engine/System/Collection/HashHelper.h"
+#include "Engine/System/Concept.h"
 #include "Engine/System/Memory/Memory.h"
 #include "Engine/System/Debug.h"
+#include <bit>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ENGINE_DICTIONARY_SSE2
+#include <emmintrin.h>
+#endif
 
 namespace Engine {
-	/// @brief A hashmap.
+	/// @brief Control bytes of Dictionary, probed a group at a time.\n
+	/// A full slot holds 7 bits of the hash of its key, so most mismatches are found without touching the entries.
+	class DictionaryGroup final {
+	public:
+		STATIC_CLASS(DictionaryGroup);
+
+		/// @brief Slots probed at once.
+		static inline constexpr int32 Width = 16;
+
+		static inline constexpr sbyte Empty = -128;
+		static inline constexpr sbyte Deleted = -2;
+
+		/// @brief Bit i is set when control i of the group equals h2.
+		static uint32 Match(const sbyte* controls, sbyte h2) {
+#if defined(ENGINE_DICTIONARY_SSE2)
+			__m128i group = _mm_loadu_si128((const __m128i*)controls);
+			return static_cast<uint32>(_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(h2))));
+#else
+			uint32 result = 0;
+			for (int32 i = 0; i < Width; i += 1) {
+				result |= static_cast<uint32>(controls[i] == h2) << i;
+			}
+			return result;
+#endif
+		}
+		/// @brief Bit i is set when slot i of the group is empty.
+		static uint32 MatchEmpty(const sbyte* controls) {
+			return Match(controls, Empty);
+		}
+		/// @brief Bit i is set when slot i of the group is empty or deleted.
+		static uint32 MatchEmptyOrDeleted(const sbyte* controls) {
+#if defined(ENGINE_DICTIONARY_SSE2)
+			// Full controls are 0 to 127, the others are below -1.
+			__m128i group = _mm_loadu_si128((const __m128i*)controls);
+			return static_cast<uint32>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), group)));
+#else
+			uint32 result = 0;
+			for (int32 i = 0; i < Width; i += 1) {
+				result |= static_cast<uint32>(controls[i] < -1) << i;
+			}
+			return result;
+#endif
+		}
+	};
+
+	/// @brief A hashmap.\n
+	/// Open addressing with one control byte per slot, see DictionaryGroup. The capacity is a power of 2 and up to 7/8 of it is used.
 	/// @tparam TKey The key type. Needs to implement `int32 GetHashCode() const` and `bool operator==(const T&) const`.
 	/// @tparam TValue The value type. Needs to be default-constructable, copy-constructable and move-contstructable.
-	template<typename TKey,typename TValue>
+	/// @tparam Allocator Where the entries live, see HeapAllocator.
+	template<typename TKey, typename TValue, typename Allocator = HeapAllocator>
 	class Dictionary {
 	public:
 		Dictionary(int32 capacity=0) {
 			SetCapacity(capacity);
 		}
 		~Dictionary() {
-			Clear();
-
-			MEMDELARR(buckets);
-			Memory::Deallocate(entries);
+			Destroy();
 		}
 
 		Dictionary(const Dictionary& obj) {
@@ -29,80 +80,44 @@ namespace Engine {
 				return *this;
 			}
 
+			Destroy();
 			CopyFromOther(obj);
 
 			return *this;
 		}
 
-		Dictionary(Dictionary&& obj) :buckets(obj.buckets), entries(obj.entries), capacity(obj.capacity), count(obj.count), freeIndex(obj.freeIndex) {
-			obj.buckets = nullptr;
-			obj.entries = nullptr;
-			obj.capacity = 0;
-			obj.count = 0;
-			obj.freeIndex = -1;
+		Dictionary(Dictionary&& obj) :entries(obj.entries), controls(obj.controls), capacity(obj.capacity), count(obj.count), growthLeft(obj.growthLeft), shift(obj.shift) {
+			obj.Reset();
 		}
 		Dictionary& operator=(Dictionary&& obj) {
 			if (this == &obj) {
 				return *this;
 			}
 
-			buckets = obj.buckets;
-			obj.buckets = nullptr;
+			Destroy();
 			entries = obj.entries;
-			obj.entries = nullptr;
+			controls = obj.controls;
 			capacity = obj.capacity;
-			obj.capacity = 0;
 			count = obj.count;
-			obj.count = 0;
-			freeIndex = obj.freeIndex;
-			obj.freeIndex = -1;
+			growthLeft = obj.growthLeft;
+			shift = obj.shift;
+			obj.Reset();
 
 			return *this;
 		}
 
+		/// @brief Make room for at least capacity entries without growing.
 		bool SetCapacity(int32 capacity) {
 			ERR_ASSERT(capacity >= count, u8"capacity cannot be smaller than element count.", return false);
-			if (capacity == count) {
-				return true;
-			}
 
-			CheckSyncState();
-
-			// Get a closest prime to help mod the hash code.
-			int32 desired = HashHelper::GetPrime(capacity);
-			ERR_ASSERT(desired >= capacity, u8"Failed to find a prime number for capacity!", return false);
-
-			if (buckets == nullptr && entries == nullptr) {
-				this->buckets = MEMNEWARR(int32, desired);
-				std::memset(this->buckets, -1, desired * sizeof(int32));
-				this->entries = (Entry*)Memory::Allocate(desired * sizeof(Entry));
-				this->capacity = desired;
-			} else {
-				int32 oldCapacity = this->capacity;
-				int32* oldBuckets = this->buckets;
-				Entry* oldEntries = this->entries;
-
-				this->capacity = desired;
-				this->count = 0;
-				this->buckets = MEMNEWARR(int32, desired);
-				std::memset(this->buckets, -1, desired * sizeof(int32));
-				this->entries = (Entry*)Memory::Allocate(desired * sizeof(Entry));
-
-				// Re-index the elements in the old container into the new one and destroy the old element.
-				for (int32 i = 0; i < oldCapacity; i += 1) {
-					for (int32 j = oldBuckets[i]; j >= 0; j = oldEntries[j].next) {
-						Insert(oldEntries[j].key, oldEntries[j].value, oldEntries[j].hashCode, InsertMode::Set);
-						Memory::Destruct(oldEntries + j);
-					}
-				}
-
-				MEMDELARR(oldBuckets);
-				Memory::Deallocate(oldEntries);
-
-				freeIndex = -1;
+			int32 slotCount = GetSlotCountFor(capacity);
+			if (slotCount == this->capacity) {
+				return true;
 			}
+			Rehash(slotCount);
 			return true;
 		}
+		/// @brief Get the slot count of the table. Up to 7/8 of it is used before growing.
 		int32 GetCapacity() const {
 			return capacity;
 		}
@@ -120,55 +135,44 @@ namespace Engine {
 		}
 
 		bool ContainsKey(const TKey& key) const {
-			if (buckets == nullptr && entries == nullptr) {
-				return false;
-			}
-
-			uint32 hash = GetKeyHash(key);
-			int bucket = GetBucketIndex(hash);
-			if (buckets[bucket] == -1) {
-				return false;
-			}
-			for (int32 i = buckets[bucket]; i >= 0; i = entries[i].next) {
-				if (entries[i].hashCode == hash && entries[i].key == key) {
-					return true;
-				}
-			}
-			return false;
+			return Find(key, GetKeyHash(key)) >= 0;
+		}
+		template<Concept::IsLookupKeyOf<TKey> TLookup>
+		bool ContainsKey(const TLookup& key) const {
+			return Find(key, GetKeyHash(key)) >= 0;
 		}
 		void Clear() {
-			if (buckets == nullptr && entries == nullptr) {
+			if (capacity == 0) {
 				return;
 			}
 
 			// Do destruction
 			for (int32 i = 0; i < capacity; i += 1) {
-				for (int32 j = buckets[i]; j >= 0; j = entries[j].next) {
-					Memory::Destruct(entries + j);
+				if (IsFull(controls[i])) {
+					Memory::Destruct(entries + i);
 				}
-				buckets[i] = -1;
 			}
+			std::memset(controls, DictionaryGroup::Empty, capacity + DictionaryGroup::Width);
 
 			count = 0;
-			freeIndex = -1;
+			growthLeft = GetMaxCount(capacity);
 		}
 		bool TryGet(const TKey& key, TValue& result) const {
-			if (buckets == nullptr && entries == nullptr) {
-				return false;
-			}
-
-			uint32 hash = GetKeyHash(key);
-			int bucket = GetBucketIndex(hash);
-			if (buckets[bucket] == -1) {
-				return false;
-			}
-			for (int32 i = buckets[bucket]; i >= 0; i = entries[i].next) {
-				if (entries[i].hashCode == hash && entries[i].key == key) {
-					result = entries[i].value;
-					return true;
-				}
-			}
-			return false;
+			return TryGetWithHash(key, ObjectUtil::GetHashCode(key), result);
+		}
+		/// @brief Look up by a different type than TKey, see Concept::IsLookupKeyOf.
+		template<Concept::IsLookupKeyOf<TKey> TLookup>
+		bool TryGet(const TLookup& key, TValue& result) const {
+			return TryGetWithHash(key, ObjectUtil::GetHashCode(key), result);
+		}
+		/// @brief Look up with the hash code of the key already known, for finding the same key in several dictionaries.
+		/// @param hashCode What ObjectUtil::GetHashCode() gives the key.
+		bool TryGetWithHash(const TKey& key, int32 hashCode, TValue& result) const {
+			return TryGetAt(Find(key, static_cast<uint32>(hashCode)), result);
+		}
+		template<Concept::IsLookupKeyOf<TKey> TLookup>
+		bool TryGetWithHash(const TLookup& key, int32 hashCode, TValue& result) const {
+			return TryGetAt(Find(key, static_cast<uint32>(hashCode)), result);
 		}
 		TValue Get(const TKey& key) const {
 			TValue result{};
@@ -177,90 +181,62 @@ namespace Engine {
 			return result;
 		}
 		bool Remove(const TKey& key) {
-			if (buckets == nullptr && entries == nullptr) {
+			int32 index = Find(key, GetKeyHash(key));
+			if (index < 0) {
 				return false;
 			}
 
-			uint32 hash = GetKeyHash(key);
-			int bucket = GetBucketIndex(hash);
-			if (buckets[bucket] == -1) {
-				return false;
+			Memory::Destruct(entries + index);
+			count -= 1;
+
+			// A slot no probe ever had to pass can be empty again, otherwise it's left as deleted to keep the probes going.
+			int32 mask = capacity - 1;
+			uint32 emptyBefore = DictionaryGroup::MatchEmpty(controls + ((index - DictionaryGroup::Width) & mask));
+			uint32 emptyAfter = DictionaryGroup::MatchEmpty(controls + index);
+			bool neverFull = emptyBefore != 0 && emptyAfter != 0 &&
+				std::countr_zero(emptyAfter) + std::countl_zero(static_cast<uint16>(emptyBefore)) < DictionaryGroup::Width;
+			if (neverFull) {
+				SetControl(index, DictionaryGroup::Empty);
+				growthLeft += 1;
+			} else {
+				SetControl(index, DictionaryGroup::Deleted);
 			}
-			for (int32 i = buckets[bucket],prev=-1; i >= 0; prev=i,i = entries[i].next) {
-				if (entries[i].hashCode == hash && entries[i].key == key) {
-					if (prev != -1) {
-						// Connect prev and next if it has a prev linked entry.
-						entries[prev].next = entries[i].next;
-					} else {
-						// Set bucket entry target to next if it is the first entry of the bucket.
-						buckets[bucket] = entries[i].next;
-					}
-					// Destruct this entry
-					Memory::Destruct(entries + i);
-					
-					// Add i into free list
-					entries[i].next = freeIndex;
-					freeIndex = i;
-
-					count -= 1;
 
-					return true;
-				}
-			}
-			return false;
+			return true;
 		}
 
 		struct Entry {
-			Entry(const TKey& key, const TValue& value, uint32 hashCode, int32 next) :key(key), value(value), hashCode(hashCode), next(next) {}
+			Entry(const TKey& key, const TValue& value) :key(key), value(value) {}
 			TKey key;
 			TValue value;
-			uint32 hashCode;
-			int32 next;
 		};
 
 		class Iterator {
 		public:
-			Iterator(const Dictionary* dic, int bucket) :dic(dic),bucketIndex(bucket) {
-				while (bucketIndex < dic->GetCapacity()&&dic->buckets[bucketIndex]==-1) {
-					bucketIndex += 1;
-				}
-				if (bucketIndex < dic->GetCapacity()) {
-					entryIndex = dic->buckets[bucketIndex];
-				} else {
-					entryIndex = -1;
-				}
+			Iterator(const Dictionary* dic, int32 index) :dic(dic), index(index) {
+				SkipFree();
 			}
 
 			bool operator!=(const Iterator& obj) const {
-				return bucketIndex != obj.bucketIndex && entryIndex != obj.entryIndex;
+				return index != obj.index;
 			}
 			const Entry& operator*() const {
-				Entry* entry = dic->entries + entryIndex;
-				return *entry;
+				return dic->entries[index];
 			}
 			Iterator& operator++() {
-				if (entryIndex >= 0) {
-					Entry* entry = dic->entries + entryIndex;
-					if (entry->next >= 0) {
-						entryIndex = entry->next;
-					} else {
-						bucketIndex += 1;
-						while (bucketIndex < dic->GetCapacity() && dic->buckets[bucketIndex] == -1) {
-							bucketIndex += 1;
-						}
-						if (bucketIndex < dic->GetCapacity()) {
-							entryIndex = dic->buckets[bucketIndex];
-						} else {
-							entryIndex = -1;
-						}
-					}
-				}
+				index += 1;
+				SkipFree();
 				return *this;
 			}
 		private:
+			void SkipFree() {
+				while (index < dic->capacity && !IsFull(dic->controls[index])) {
+					index += 1;
+				}
+			}
+
 			const Dictionary* dic;
-			int32 bucketIndex;
-			int32 entryIndex;
+			int32 index;
 		};
 
 		Iterator begin() const {
@@ -274,100 +250,210 @@ namespace Engine {
 		static inline constexpr int32 CapacityMultiplier = 2;
 
 	private:
-		void CopyFromOther(const Dictionary& obj) {
-			capacity = obj.capacity;
-			count = obj.count;
-			freeIndex = obj.freeIndex;
-			buckets = MEMNEWARR(int32, capacity);
-			entries = (Entry*)Memory::Allocate(capacity * sizeof(Entry));
-			// Copy entries
-			for (int32 i = 0; i < obj.capacity; i += 1) {
-				buckets[i] = obj.buckets[i];
-				for (int j = obj.buckets[i]; j >= 0; j = obj.entries[j].next) {
-					Memory::Construct(entries + j, obj.entries[j]);
-				}
+		static bool IsFull(sbyte control) {
+			return control >= 0;
+		}
+		/// @brief Entries fitting into slotCount slots before growing.
+		static int32 GetMaxCount(int32 slotCount) {
+			return slotCount - slotCount / 8;
+		}
+		/// @brief Get the smallest power of 2 slot count holding count entries.
+		static int32 GetSlotCountFor(int32 count) {
+			if (count <= 0) {
+				return 0;
 			}
-			// Copy free indexes
-			for (int32 i = freeIndex; i >= 0; i = obj.entries[i].next) {
-				entries[i].next = obj.entries[i].next;
+			int32 result = DictionaryGroup::Width;
+			while (GetMaxCount(result) < count) {
+				result *= CapacityMultiplier;
 			}
+			return result;
 		}
 
-		enum class InsertMode { Add, Set };
-		static uint32 GetKeyHash(const TKey& key) {
-			int32 s_hash = ObjectUtil::GetHashCode(key);
-			return *((uint32*)(&s_hash));
+		template<typename TLookup>
+		static uint32 GetKeyHash(const TLookup& key) {
+			return static_cast<uint32>(ObjectUtil::GetHashCode(key));
+		}
+		/// @brief Spread the hash code over 64 bits, the top bits pick the first slot and bits 25 to 31 make the control byte.
+		static uint64 MixHash(uint32 hash) {
+			return static_cast<uint64>(hash) * 0x9E3779B97F4A7C15ull;
+		}
+		static sbyte GetH2(uint64 mixed) {
+			return static_cast<sbyte>((mixed >> 25) & 0x7F);
+		}
+		int32 GetFirstSlot(uint64 mixed) const {
+			return static_cast<int32>(mixed >> shift);
 		}
-		
-		bool Insert(const TKey& key, const TValue& value, uint32 hash, InsertMode mode) {
-			RequireCapacity(count + 1);
-			int32 bucket = GetBucketIndex(hash);
 
-			// If bucket is empty.
-			if (buckets[bucket] == -1) {
-				buckets[bucket] = AddEntry(key, value, hash, -1);
-				return true;
+		/// @brief Set a control byte, the first group is mirrored after the last slot so groups can be loaded from every slot.
+		void SetControl(int32 index, sbyte control) {
+			controls[index] = control;
+			if (index < DictionaryGroup::Width) {
+				controls[capacity + index] = control;
 			}
+		}
 
-			for (int32 i = buckets[bucket]; i >= 0; i = entries[i].next) {
-				// the key already exists.
-				if (entries[i].hashCode == hash && entries[i].key == key) {
-					if (mode == InsertMode::Add) {
-						// In add mode, fails.
-						ERR_MSG(u8"Key is already exists.");
-						return false;
-					} else {
-						// In set mode, overwrite the value.
-						entries[i].value = value;
-						return true;
+		/// @return The slot of the key, -1 if it is not found.
+		template<typename TLookup>
+		int32 Find(const TLookup& key, uint32 hash) const {
+			if (capacity == 0) {
+				return -1;
+			}
+			uint64 mixed = MixHash(hash);
+			sbyte h2 = GetH2(mixed);
+			int32 mask = capacity - 1;
+			int32 position = GetFirstSlot(mixed);
+			// Jump further every round, with a power of 2 capacity every group is visited once.
+			for (int32 step = DictionaryGroup::Width; ; step += DictionaryGroup::Width) {
+				const sbyte* group = controls + position;
+				for (uint32 match = DictionaryGroup::Match(group, h2); match != 0; match &= match - 1) {
+					int32 index = (position + std::countr_zero(match)) & mask;
+					if (entries[index].key == key) {
+						return index;
 					}
 				}
+				if (DictionaryGroup::MatchEmpty(group) != 0 || step >= capacity) {
+					return -1;
+				}
+				position = (position + step) & mask;
+			}
+		}
+		bool TryGetAt(int32 index, TValue& result) const {
+			if (index < 0) {
+				return false;
+			}
+			result = entries[index].value;
+			return true;
+		}
+		/// @return The first empty or deleted slot on the probe of the hash.
+		int32 FindFree(uint64 mixed) const {
+			int32 mask = capacity - 1;
+			int32 position = GetFirstSlot(mixed);
+			for (int32 step = DictionaryGroup::Width; ; step += DictionaryGroup::Width) {
+				uint32 match = DictionaryGroup::MatchEmptyOrDeleted(controls + position);
+				if (match != 0) {
+					return (position + std::countr_zero(match)) & mask;
+				}
+				position = (position + step) & mask;
+			}
+		}
+
+		enum class InsertMode { Add, Set };
+		bool Insert(const TKey& key, const TValue& value, uint32 hash, InsertMode mode) {
+			int32 index = Find(key, hash);
+			// the key already exists.
+			if (index >= 0) {
+				if (mode == InsertMode::Add) {
+					// In add mode, fails.
+					ERR_MSG(u8"Key is already exists.");
+					return false;
+				} else {
+					// In set mode, overwrite the value.
+					entries[index].value = value;
+					return true;
+				}
 			}
+
 			// the key doesn't exist, add entry.
-			buckets[bucket] = AddEntry(key, value, hash, buckets[bucket]);
+			uint64 mixed = MixHash(hash);
+			index = capacity == 0 ? -1 : FindFree(mixed);
+			if (index < 0 || (growthLeft == 0 && controls[index] != DictionaryGroup::Deleted)) {
+				// Out of empty slots. Grow, unless deleted slots make up half of the used ones, then sweeping them out is enough.
+				int32 slotCount = DictionaryGroup::Width;
+				if (capacity > 0) {
+					slotCount = count * 2 < GetMaxCount(capacity) ? capacity : capacity * CapacityMultiplier;
+				}
+				Rehash(slotCount);
+				index = FindFree(mixed);
+			}
+
+			if (controls[index] == DictionaryGroup::Empty) {
+				growthLeft -= 1;
+			}
+			Memory::Construct(entries + index, key, value);
+			SetControl(index, GetH2(mixed));
+			count += 1;
 
 			return true;
 		}
 
-		int32 AddEntry(const TKey& key, const TValue& value, uint32 hash, int32 next) {
-			int32 index = -1;
-			if (freeIndex == -1) {
-				index = count;
-			} else {
-				index = freeIndex;
-				freeIndex = entries[freeIndex].next;
+		/// @brief Move every entry into a new table of slotCount slots, dropping the deleted slots on the way.
+		void Rehash(int32 slotCount) {
+			Entry* oldEntries = entries;
+			sbyte* oldControls = controls;
+			int32 oldCapacity = capacity;
+
+			Allocate(slotCount);
+			for (int32 i = 0; i < oldCapacity; i += 1) {
+				if (!IsFull(oldControls[i])) {
+					continue;
+				}
+				uint64 mixed = MixHash(GetKeyHash(oldEntries[i].key));
+				int32 index = FindFree(mixed);
+				if constexpr (Memory::IsTriviallyRelocatable<TKey>() && Memory::IsTriviallyRelocatable<TValue>()) {
+					std::memcpy((void*)(entries + index), (const void*)(oldEntries + i), sizeof(Entry));
+				} else {
+					Memory::Construct(entries + index, Memory::Move(oldEntries[i]));
+					Memory::Destruct(oldEntries + i);
+				}
+				SetControl(index, GetH2(mixed));
 			}
-			Memory::Construct(entries + index, key, value, hash, next);
-			count += 1;
-			return index;
+			growthLeft -= count;
+
+			Allocator::Deallocate(oldEntries);
+		}
+		/// @brief Take a new empty table. The entries and the control bytes share one block.
+		void Allocate(int32 slotCount) {
+			capacity = slotCount;
+			growthLeft = GetMaxCount(slotCount);
+			shift = 64 - std::countr_zero(static_cast<uint32>(slotCount));
+			if (slotCount == 0) {
+				entries = nullptr;
+				controls = nullptr;
+				return;
+			}
+			entries = (Entry*)Allocator::Allocate(slotCount * sizeof(Entry) + slotCount + DictionaryGroup::Width);
+			controls = (sbyte*)(entries + slotCount);
+			std::memset(controls, DictionaryGroup::Empty, slotCount + DictionaryGroup::Width);
 		}
 
-		void RequireCapacity(int32 capacity) {
-			if (capacity <= this->capacity) {
+		void CopyFromOther(const Dictionary& obj) {
+			Allocate(obj.capacity);
+			if (capacity == 0) {
 				return;
 			}
-			int result = (this->capacity == 0 ? capacity : this->capacity);
-			while (result < capacity) {
-				result *= CapacityMultiplier;
+			// Same slots, no rehashing needed.
+			for (int32 i = 0; i < capacity; i += 1) {
+				if (IsFull(obj.controls[i])) {
+					Memory::Construct(entries + i, obj.entries[i]);
+				}
 			}
-			SetCapacity(result);
-		}
-		int32 GetBucketIndex(uint32 hash) const {
-			return (int32)(hash % capacity);
+			std::memcpy(controls, obj.controls, capacity + DictionaryGroup::Width);
+			count = obj.count;
+			growthLeft = obj.growthLeft;
 		}
 
-		inline void CheckSyncState() const {
-			// Stop immediately if buckets and entries are not in sync (this should never happen, but just in case)
-			ERR_ASSERT((buckets == nullptr && entries == nullptr) || (buckets != nullptr && entries != nullptr),
-				u8"buckets and entries are out of sync!",
-				FATAL_CRASH(u8"Cannot proceed as Dictionary is in a dangerous state and may have caused memory leak!")
-			);
+		void Destroy() {
+			Clear();
+			Allocator::Deallocate(entries);
+			Reset();
+		}
+		/// @brief Forget the table without freeing it.
+		void Reset() {
+			entries = nullptr;
+			controls = nullptr;
+			capacity = 0;
+			count = 0;
+			growthLeft = 0;
+			shift = 64;
 		}
 
+		Entry* entries = nullptr;
+		sbyte* controls = nullptr;
 		int32 capacity = 0;
 		int32 count = 0;
-		int32* buckets = nullptr;
-		Entry* entries = nullptr;
-		int32 freeIndex = -1;
+		/// @brief Empty slots left to fill before growing.
+		int32 growthLeft = 0;
+		/// @brief 64 - log2(capacity), for taking the first slot from the top bits of the mixed hash.
+		int32 shift = 64;
 	};
 }
@@ -0,0 +1,238 @@
+#pragma once
+#include "Engine/System/Object/ObjectUtil.h"
+#include "Engine/System/Concept.h"
+#include "Engine/System/Collection/List.h"
+#include "Engine/System/Collection/Algorithm.h"
+#include "Engine/System/Debug.h"
+
+namespace Engine {
+	/// @brief Searching the sorted hash codes of FlatMap and FlatSet.
+	class FlatSearch final {
+	public:
+		STATIC_CLASS(FlatSearch);
+
+		/// @brief Get the first index whose hash is not less than hash, count if there is none.\n
+		/// Branchless, the loop runs log2(count) times and the compare becomes a conditional move,
+		/// so lookups in no particular order do not pay for mispredicted branches.
+		static int32 LowerBound(const uint32* hashes, int32 count, uint32 hash) {
+			if (count == 0) {
+				return 0;
+			}
+			const uint32* base = hashes;
+			int32 length = count;
+			while (length > 1) {
+				int32 half = length / 2;
+				// Written as arithmetic, the ternary form compiles to a branch.
+				base += (base[half - 1] < hash) * half;
+				length -= half;
+			}
+			return static_cast<int32>(base - hashes) + (*base < hash);
+		}
+		/// @brief Get the order that sorts the hashes, equal hashes keep their order.
+		static List<int32> GetSortedOrder(const uint32* hashes, int32 count) {
+			List<int32> result(count);
+			for (int32 i = 0; i < count; i += 1) {
+				result.Add(i);
+			}
+			Algorithm::StableSort(result.GetRawElementPtr(), count, [hashes](int32 a, int32 b) {
+				return hashes[a] < hashes[b];
+			});
+			return result;
+		}
+		/// @brief Get the index after the run of hashes equal to hash, where a new key with that hash goes.\n
+		/// Keys with the same hash stay in the order they were added.
+		static int32 UpperBoundOfRun(const uint32* hashes, int32 count, uint32 hash) {
+			int32 index = LowerBound(hashes, count, hash);
+			while (index < count && hashes[index] == hash) {
+				index += 1;
+			}
+			return index;
+		}
+		/// @return The index of the key in the run of elements with its hash, -1 if it is not found.
+		/// @param getKey Gives the key of an element.
+		template<typename TElement, typename TLookup, typename TGetKey>
+		static int32 FindInRun(const uint32* hashes, const TElement* elements, int32 count, uint32 hash, const TLookup& key, TGetKey getKey) {
+			for (int32 i = LowerBound(hashes, count, hash); i < count && hashes[i] == hash; i += 1) {
+				if (getKey(elements[i]) == key) {
+					return i;
+				}
+			}
+			return -1;
+		}
+		/// @brief Sort elements appended in no order by their hashes, see FlatMap::Build().
+		/// @return false if some keys were added more than once, only the first of them is kept.
+		template<typename TElement, typename Allocator, typename TGetKey>
+		static bool SortByHash(List<uint32, Allocator>& hashes, List<TElement, Allocator>& elements, TGetKey getKey) {
+			List<int32> order = GetSortedOrder(hashes.GetRawElementPtr(), hashes.GetCount());
+			List<uint32, Allocator> sortedHashes(order.GetCount());
+			List<TElement, Allocator> sortedElements(order.GetCount());
+			bool unique = true;
+			for (int32 i = 0; i < order.GetCount(); i += 1) {
+				int32 index = order.Get(i);
+				uint32 hash = hashes.GetRawElementPtr()[index];
+				TElement& element = elements.GetRawElementPtr()[index];
+				if (FindInRun(sortedHashes.GetRawElementPtr(), sortedElements.GetRawElementPtr(), sortedHashes.GetCount(), hash, getKey(element), getKey) >= 0) {
+					unique = false;
+					continue;
+				}
+				sortedHashes.Add(hash);
+				sortedElements.Add(Memory::Move(element));
+			}
+			hashes = Memory::Move(sortedHashes);
+			elements = Memory::Move(sortedElements);
+			return unique;
+		}
+	};
+
+	/// @brief A map kept in sorted contiguous storage, for small maps mostly read after being built.\n
+	/// Entries are sorted by the hash codes of their keys, kept in their own array for a binary search touching few cache lines.
+	/// No buckets or empty slots, the storage is as large as the entries. Adding and removing are O(n).
+	/// Build a map at once with AddUnsorted() and Build(), and Freeze() it when done to give back the spare capacity.
+	/// @tparam TKey The key type. Needs to implement `int32 GetHashCode() const` and `bool operator==(const T&) const`.
+	/// @tparam TValue The value type. Needs to be default-constructable, copy-constructable and move-contstructable.
+	/// @tparam Allocator Where the entries live, see HeapAllocator.
+	template<typename TKey, typename TValue, typename Allocator = HeapAllocator>
+	class FlatMap final {
+	public:
+		struct Entry {
+			TKey key;
+			TValue value;
+		};
+		using Iterator = ReadonlyIterator<Entry>;
+
+		FlatMap(int32 capacity = 0) :hashes(capacity), entries(capacity) {}
+
+		int32 GetCount() const {
+			return entries.GetCount();
+		}
+		int32 GetCapacity() const {
+			return entries.GetCapacity();
+		}
+		void SetCapacity(int32 capacity) {
+			hashes.SetCapacity(capacity);
+			entries.SetCapacity(capacity);
+		}
+
+		bool Add(const TKey& key, const TValue& value) {
+			bool result = Insert(key, value, false);
+			ERR_ASSERT(result, u8"Failed to add an entry, the key already exists.", return false);
+			return true;
+		}
+		void Set(const TKey& key, const TValue& value) {
+			Insert(key, value, true);
+		}
+		/// @brief Append an entry without keeping the order. Call Build() before looking anything up.
+		void AddUnsorted(const TKey& key, const TValue& value) {
+			hashes.Add(GetKeyHash(key));
+			entries.Add(Entry{ key, value });
+			sorted = false;
+		}
+		/// @brief Sort the entries added by AddUnsorted().
+		/// @return false if some keys were added more than once, only the first of them is kept.
+		bool Build() {
+			if (sorted) {
+				return true;
+			}
+			sorted = true;
+			return FlatSearch::SortByHash(hashes, entries, GetEntryKey);
+		}
+		/// @brief Build() if needed and shrink the storage to the entries. For when nothing is added any more.
+		void Freeze() {
+			Build();
+			SetCapacity(GetCount());
+		}
+		bool Remove(const TKey& key) {
+			int32 index = Find(key, GetKeyHash(key));
+			if (index < 0) {
+				return false;
+			}
+			hashes.RemoveAt(index);
+			entries.RemoveAt(index);
+			return true;
+		}
+		void Clear() {
+			hashes.Clear();
+			entries.Clear();
+			sorted = true;
+		}
+
+		bool ContainsKey(const TKey& key) const {
+			return Find(key, GetKeyHash(key)) >= 0;
+		}
+		template<Concept::IsLookupKeyOf<TKey> TLookup>
+		bool ContainsKey(const TLookup& key) const {
+			return Find(key, GetKeyHash(key)) >= 0;
+		}
+		bool TryGet(const TKey& key, TValue& result) const {
+			return TryGetWithHash(key, ObjectUtil::GetHashCode(key), result);
+		}
+		/// @brief Look up by a different type than TKey, see Concept::IsLookupKeyOf.
+		template<Concept::IsLookupKeyOf<TKey> TLookup>
+		bool TryGet(const TLookup& key, TValue& result) const {
+			return TryGetWithHash(key, ObjectUtil::GetHashCode(key), result);
+		}
+		/// @brief Look up with the hash code of the key already known, for finding the same key in several maps.
+		/// @param hashCode What ObjectUtil::GetHashCode() gives the key.
+		bool TryGetWithHash(const TKey& key, int32 hashCode, TValue& result) const {
+			return TryGetAt(Find(key, static_cast<uint32>(hashCode)), result);
+		}
+		template<Concept::IsLookupKeyOf<TKey> TLookup>
+		bool TryGetWithHash(const TLookup& key, int32 hashCode, TValue& result) const {
+			return TryGetAt(Find(key, static_cast<uint32>(hashCode)), result);
+		}
+		TValue Get(const TKey& key) const {
+			TValue result{};
+			bool succeed = TryGet(key, result);
+			ERR_ASSERT(succeed, u8"Entry with key does not exists!", return TValue());
+			return result;
+		}
+
+		/// @brief Walk the entries in the order of their hash codes.
+		Iterator begin() const {
+			return entries.begin();
+		}
+		Iterator end() const {
+			return entries.end();
+		}
+
+	private:
+		template<typename TLookup>
+		static uint32 GetKeyHash(const TLookup& key) {
+			return static_cast<uint32>(ObjectUtil::GetHashCode(key));
+		}
+		static const TKey& GetEntryKey(const Entry& entry) {
+			return entry.key;
+		}
+		template<typename TLookup>
+		int32 Find(const TLookup& key, uint32 hash) const {
+			ERR_ASSERT(sorted, u8"Build() the map after AddUnsorted() before looking up.", return -1);
+			return FlatSearch::FindInRun(hashes.GetRawElementPtr(), entries.GetRawElementPtr(), entries.GetCount(), hash, key, GetEntryKey);
+		}
+		bool TryGetAt(int32 index, TValue& result) const {
+			if (index < 0) {
+				return false;
+			}
+			result = entries.GetRawElementPtr()[index].value;
+			return true;
+		}
+		bool Insert(const TKey& key, const TValue& value, bool overwrite) {
+			Build();
+			uint32 hash = GetKeyHash(key);
+			int32 index = Find(key, hash);
+			if (index >= 0) {
+				if (overwrite) {
+					entries.GetRawElementPtr()[index].value = value;
+				}
+				return overwrite;
+			}
+			index = FlatSearch::UpperBoundOfRun(hashes.GetRawElementPtr(), hashes.GetCount(), hash);
+			hashes.Insert(index, hash);
+			entries.Insert(index, Entry{ key, value });
+			return true;
+		}
+
+		List<uint32, Allocator> hashes;
+		List<Entry, Allocator> entries;
+		bool sorted = true;
+	};
+}
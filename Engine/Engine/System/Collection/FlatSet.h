@@ -0,0 +1,108 @@
+#pragma once
+#include "Engine/System/Collection/FlatMap.h"
+
+namespace Engine {
+	/// @brief A set kept in sorted contiguous storage, see FlatMap.
+	/// @tparam TKey The key type. Needs to implement `int32 GetHashCode() const` and `bool operator==(const T&) const`.
+	/// @tparam Allocator Where the keys live, see HeapAllocator.
+	template<typename TKey, typename Allocator = HeapAllocator>
+	class FlatSet final {
+	public:
+		using Iterator = ReadonlyIterator<TKey>;
+
+		FlatSet(int32 capacity = 0) :hashes(capacity), keys(capacity) {}
+
+		int32 GetCount() const {
+			return keys.GetCount();
+		}
+		int32 GetCapacity() const {
+			return keys.GetCapacity();
+		}
+		void SetCapacity(int32 capacity) {
+			hashes.SetCapacity(capacity);
+			keys.SetCapacity(capacity);
+		}
+
+		/// @return false if the key is already in the set.
+		bool Add(const TKey& key) {
+			Build();
+			uint32 hash = GetKeyHash(key);
+			if (Find(key, hash) >= 0) {
+				return false;
+			}
+			int32 index = FlatSearch::UpperBoundOfRun(hashes.GetRawElementPtr(), hashes.GetCount(), hash);
+			hashes.Insert(index, hash);
+			keys.Insert(index, key);
+			return true;
+		}
+		/// @brief Append a key without keeping the order. Call Build() before looking anything up.
+		void AddUnsorted(const TKey& key) {
+			hashes.Add(GetKeyHash(key));
+			keys.Add(key);
+			sorted = false;
+		}
+		/// @brief Sort the keys added by AddUnsorted().
+		/// @return false if some keys were added more than once, only the first of them is kept.
+		bool Build() {
+			if (sorted) {
+				return true;
+			}
+			sorted = true;
+			return FlatSearch::SortByHash(hashes, keys, GetKey);
+		}
+		/// @brief Build() if needed and shrink the storage to the keys. For when nothing is added any more.
+		void Freeze() {
+			Build();
+			SetCapacity(GetCount());
+		}
+		bool Remove(const TKey& key) {
+			int32 index = Find(key, GetKeyHash(key));
+			if (index < 0) {
+				return false;
+			}
+			hashes.RemoveAt(index);
+			keys.RemoveAt(index);
+			return true;
+		}
+		void Clear() {
+			hashes.Clear();
+			keys.Clear();
+			sorted = true;
+		}
+
+		bool Contains(const TKey& key) const {
+			return Find(key, GetKeyHash(key)) >= 0;
+		}
+		/// @brief Look up by a different type than TKey, see Concept::IsLookupKeyOf.
+		template<Concept::IsLookupKeyOf<TKey> TLookup>
+		bool Contains(const TLookup& key) const {
+			return Find(key, GetKeyHash(key)) >= 0;
+		}
+
+		/// @brief Walk the keys in the order of their hash codes.
+		Iterator begin() const {
+			return keys.begin();
+		}
+		Iterator end() const {
+			return keys.end();
+		}
+
+	private:
+		template<typename TLookup>
+		static uint32 GetKeyHash(const TLookup& key) {
+			return static_cast<uint32>(ObjectUtil::GetHashCode(key));
+		}
+		static const TKey& GetKey(const TKey& key) {
+			return key;
+		}
+		template<typename TLookup>
+		int32 Find(const TLookup& key, uint32 hash) const {
+			ERR_ASSERT(sorted, u8"Build() the set after AddUnsorted() before looking up.", return -1);
+			return FlatSearch::FindInRun(hashes.GetRawElementPtr(), keys.GetRawElementPtr(), keys.GetCount(), hash, key, GetKey);
+		}
+
+		List<uint32, Allocator> hashes;
+		List<TKey, Allocator> keys;
+		bool sorted = true;
+	};
+}
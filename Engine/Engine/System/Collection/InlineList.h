@@ -0,0 +1,271 @@
+#pragma once
+#include "Engine/System/Definition.h"
+#include "Engine/System/Memory/Memory.h"
+#include "Engine/System/Debug.h"
+#include "Engine/System/Collection/Iterator.h"
+#include <initializer_list>
+#include <cstring>
+
+namespace Engine {
+	/// @brief A random-access list keeping its first elements inside the list itself.\n
+	/// Up to InlineCapacity elements cost no allocation, more spill to the heap. Same usage as List.
+	/// @tparam T The value type. Needs to be move-constructable, copying the list also needs it to be copy-constructable.
+	/// @tparam InlineCapacity How many elements fit inline.
+	/// @tparam Allocator Where the spilled elements live, see HeapAllocator.
+	template<typename T, int32 InlineCapacity, typename Allocator = HeapAllocator>
+	class InlineList final {
+		static_assert(InlineCapacity > 0, "InlineCapacity must be larger than 0.");
+		static_assert(alignof(T) <= Memory::Alignment, "Allocator blocks are only aligned to Memory::Alignment.");
+	public:
+		using Iterator = ReadonlyIterator<T>;
+
+		InlineList(int32 capacity = 0) {
+			EnsureCapacity(capacity);
+		}
+
+		InlineList(std::initializer_list<T> values) {
+			EnsureCapacity(static_cast<int32>(values.size()));
+			for (const T& value : values) {
+				Add(value);
+			}
+		}
+
+		~InlineList() {
+			Destroy();
+		}
+
+		InlineList(const InlineList& obj) {
+			CopyFromOther(obj);
+		}
+		InlineList& operator=(const InlineList& obj) {
+			if (this == &obj) {
+				return *this;
+			}
+
+			Destroy();
+			CopyFromOther(obj);
+
+			return *this;
+		}
+
+		InlineList(InlineList&& obj) {
+			MoveFromOther(obj);
+		}
+		InlineList& operator=(InlineList&& obj) {
+			if (this == &obj) {
+				return *this;
+			}
+
+			Destroy();
+			MoveFromOther(obj);
+
+			return *this;
+		}
+
+		int32 GetCapacity() const {
+			return capacity;
+		}
+		/// @brief Resize the storage. Capacities up to InlineCapacity move the elements back inline.
+		void SetCapacity(int32 capacity) {
+			ERR_ASSERT(capacity >= 0 && capacity >= count, u8"capacity cannot be less than 0 or the current size.", return);
+
+			if (capacity < InlineCapacity) {
+				capacity = InlineCapacity;
+			}
+			if (capacity == this->capacity) {
+				return;
+			}
+
+			if (IsSpilled() && capacity > InlineCapacity && Memory::IsTriviallyRelocatable<T>()) {
+				elements = (T*)Allocator::Reallocate(elements, this->capacity * sizeof(T), capacity * sizeof(T));
+			} else {
+				T* newElements = capacity == InlineCapacity ? GetInlineElements() : (T*)Allocator::Allocate(capacity * sizeof(T));
+				Relocate(newElements, elements, count);
+				if (IsSpilled()) {
+					Allocator::Deallocate(elements);
+				}
+				elements = newElements;
+			}
+			this->capacity = capacity;
+		}
+		static inline constexpr int32 CapacityMultiplier = 2;
+		void EnsureCapacity(int32 capacity) {
+			if (capacity <= this->capacity) {
+				return;
+			}
+			int32 result = this->capacity;
+			while (result < capacity) {
+				result *= CapacityMultiplier;
+			}
+			SetCapacity(result);
+		}
+		/// @brief Check if the elements have spilled to the heap.
+		bool IsSpilled() const {
+			return elements != GetInlineElements();
+		}
+		int32 GetCount() const {
+			return count;
+		}
+		T Get(int32 index) const {
+			ERR_ASSERT(index >= 0 && index < count, u8"index out of bounds.", return T());
+			return elements[index];
+		}
+		void Set(int32 index, const T& value) {
+			ERR_ASSERT(index >= 0 && index < count, u8"index out of bounds.", return);
+			*(elements + index) = value;
+		}
+		void Set(int32 index, T&& value) {
+			ERR_ASSERT(index >= 0 && index < count, u8"index out of bounds.", return);
+			*(elements + index) = Memory::Move(value);
+		}
+		void Add(const T& value) {
+			Emplace(value);
+		}
+		void Add(T&& value) {
+			Emplace(Memory::Move(value));
+		}
+		/// @brief Construct a new element at the end from the arguments.
+		/// @return The new element, valid until the next insert or remove.
+		template<typename ... Args>
+		T& Emplace(Args&& ... args) {
+			if (count < capacity) {
+				Memory::Construct(elements + count, Memory::Forward<Args>(args)...);
+			} else {
+				// The arguments may point into this list, build the value before growing.
+				T value(Memory::Forward<Args>(args)...);
+				EnsureCapacity(count + 1);
+				Memory::Construct(elements + count, Memory::Move(value));
+			}
+			count += 1;
+			return elements[count - 1];
+		}
+		void Insert(int32 index, const T& value) {
+			Insert(index, T(value));
+		}
+		void Insert(int32 index, T&& value) {
+			ERR_ASSERT(index >= 0 && index <= count, u8"index out of bounds.", return);
+
+			if (index == count) {
+				Emplace(Memory::Move(value));
+				return;
+			}
+
+			// The value may be an element of this list, take it out before shifting.
+			T inserted(Memory::Move(value));
+			EnsureCapacity(count + 1);
+
+			// Shift the tail one step back.
+			if constexpr (Memory::IsTriviallyRelocatable<T>()) {
+				std::memmove((void*)(elements + index + 1), (const void*)(elements + index), (count - index) * sizeof(T));
+				Memory::Construct(elements + index, Memory::Move(inserted));
+			} else {
+				Memory::Construct(elements + count, Memory::Move(elements[count - 1]));
+				for (int32 i = count - 1; i > index; i -= 1) {
+					elements[i] = Memory::Move(elements[i - 1]);
+				}
+				elements[index] = Memory::Move(inserted);
+			}
+
+			count += 1;
+		}
+		void RemoveAt(int32 index) {
+			ERR_ASSERT(index >= 0 && index < count, u8"index out of bounds", return);
+
+			// Shift the tail one step forward.
+			if constexpr (Memory::IsTriviallyRelocatable<T>()) {
+				Memory::Destruct(elements + index);
+				std::memmove((void*)(elements + index), (const void*)(elements + index + 1), (count - index - 1) * sizeof(T));
+			} else {
+				for (int32 i = index; i < count - 1; i += 1) {
+					elements[i] = Memory::Move(elements[i + 1]);
+				}
+				Memory::Destruct(elements + count - 1);
+			}
+
+			count -= 1;
+		}
+		void Clear() {
+			for (int32 i = 0; i < count; i += 1) {
+				Memory::Destruct(elements + i);
+			}
+			count = 0;
+		}
+
+		/// @brief Get the raw element pointer for high performance operation, if you know what you are doing.\n
+		/// Only read or write existing elements. Do not insert or remove.
+		/// The element pointer can vary after an insert or remove operation, or after moving the list!
+		T* GetRawElementPtr() {
+			return elements;
+		}
+		/// @brief Get the raw element pointer for high performance operation, if you know what you are doing.\n
+		/// Only read or write existing elements. Do not insert or remove.
+		/// The element pointer can vary after an insert or remove operation, or after moving the list!
+		const T* GetRawElementPtr() const {
+			return elements;
+		}
+
+		Iterator begin() const {
+			return Iterator(elements);
+		}
+		Iterator end() const {
+			return Iterator(elements + count);
+		}
+	private:
+		T* GetInlineElements() {
+			return reinterpret_cast<T*>(storage);
+		}
+		const T* GetInlineElements() const {
+			return reinterpret_cast<const T*>(storage);
+		}
+
+		/// @brief Move count elements to uninitialized memory, ending their lifetime at the source.
+		static void Relocate(T* destination, T* source, int32 count) {
+			if constexpr (Memory::IsTriviallyRelocatable<T>()) {
+				if (count > 0) {
+					std::memcpy((void*)destination, (const void*)source, count * sizeof(T));
+				}
+			} else {
+				for (int32 i = 0; i < count; i += 1) {
+					Memory::Construct(destination + i, Memory::Move(source[i]));
+					Memory::Destruct(source + i);
+				}
+			}
+		}
+
+		void CopyFromOther(const InlineList& obj) {
+			EnsureCapacity(obj.count);
+			for (int32 i = 0; i < obj.count; i += 1) {
+				Memory::Construct(elements + i, *(obj.elements + i));
+			}
+			count = obj.count;
+		}
+		void MoveFromOther(InlineList& obj) {
+			if (obj.IsSpilled()) {
+				// Take over the heap block.
+				elements = obj.elements;
+				capacity = obj.capacity;
+			} else {
+				Relocate(elements, obj.elements, obj.count);
+			}
+			count = obj.count;
+
+			obj.elements = obj.GetInlineElements();
+			obj.capacity = InlineCapacity;
+			obj.count = 0;
+		}
+		/// @brief Destruct the elements and go back to the inline storage.
+		void Destroy() {
+			Clear();
+			if (IsSpilled()) {
+				Allocator::Deallocate(elements);
+			}
+			elements = GetInlineElements();
+			capacity = InlineCapacity;
+		}
+
+		alignas(T) byte storage[sizeof(T) * InlineCapacity];
+		T* elements = GetInlineElements();
+		int32 capacity = InlineCapacity;
+		int32 count = 0;
+	};
+}
@@ -4,13 +4,19 @@
 #include "Engine/System/Debug.h"
 #include "Engine/System/Collection/Iterator.h"
 #include <initializer_list>
+#include <cstring>
 
 namespace Engine{
 	/// @brief A random-access list.
-	/// @tparam T The value type. Needs to be default-constructable, copy-constructable and move-contstructable.
-	template<typename T>
+	/// @tparam T The value type. Needs to be move-constructable, copying the list also needs it to be copy-constructable.\n
+	/// Elements of trivially relocatable types are moved around as raw bytes, see Memory::IsTriviallyRelocatable().
+	/// @tparam Allocator Where the elements live, see HeapAllocator.
+	template<typename T, typename Allocator = HeapAllocator>
 	class List {
+		static_assert(alignof(T) <= Memory::Alignment, "Allocator blocks are only aligned to Memory::Alignment.");
 	public:
+		TRIVIALLY_RELOCATABLE;
+
 		using Iterator = ReadonlyIterator<T>;
 
 		List(int32 capacity = 0) {
@@ -22,7 +28,7 @@ namespace Engine{
 				return;
 			}
 			SetCapacity(static_cast<int32>(values.size()));
-			for (auto value : values) {
+			for (const T& value : values) {
 				Add(value);
 			}
 		}
@@ -70,14 +76,29 @@ namespace Engine{
 		void SetCapacity(int32 capacity) {
 			ERR_ASSERT(capacity >= 0 && capacity >= count, u8"capacity cannot be less than 0 or the current size.", return);
 
-			if (capacity == count || capacity == this->capacity) {
+			if (capacity == this->capacity) {
+				return;
+			}
+			if (capacity == 0) {
+				Allocator::Deallocate(elements);
+				elements = nullptr;
+				this->capacity = 0;
 				return;
 			}
 
 			if (elements == nullptr) {
-				elements = (T*)Memory::Allocate(capacity * sizeof(T));
+				elements = (T*)Allocator::Allocate(capacity * sizeof(T));
+			} else if constexpr (Memory::IsTriviallyRelocatable<T>()) {
+				elements = (T*)Allocator::Reallocate(elements, this->capacity * sizeof(T), capacity * sizeof(T));
 			} else {
-				elements = (T*)Memory::Reallocate(elements, capacity * sizeof(T));
+				// Reallocate would move the bytes behind the back of the move constructor.
+				T* newElements = (T*)Allocator::Allocate(capacity * sizeof(T));
+				for (int32 i = 0; i < count; i += 1) {
+					Memory::Construct(newElements + i, Memory::Move(elements[i]));
+					Memory::Destruct(elements + i);
+				}
+				Allocator::Deallocate(elements);
+				elements = newElements;
 			}
 			this->capacity = capacity;
 		}
@@ -104,48 +125,74 @@ namespace Engine{
 			ERR_ASSERT(index >= 0 && index < count, u8"index out of bounds.", return);
 			*(elements + index) = value;
 		}
+		void Set(int32 index, T&& value) {
+			ERR_ASSERT(index >= 0 && index < count, u8"index out of bounds.", return);
+			*(elements + index) = Memory::Move(value);
+		}
 		void Add(const T& value) {
-			EnsureCapacity(count + 1);
-			Memory::Construct(elements + count, value);
+			Emplace(value);
+		}
+		void Add(T&& value) {
+			Emplace(Memory::Move(value));
+		}
+		/// @brief Construct a new element at the end from the arguments.
+		/// @return The new element, valid until the next insert or remove.
+		template<typename ... Args>
+		T& Emplace(Args&& ... args) {
+			if (count < capacity) {
+				Memory::Construct(elements + count, Memory::Forward<Args>(args)...);
+			} else {
+				// The arguments may point into this list, build the value before growing.
+				T value(Memory::Forward<Args>(args)...);
+				EnsureCapacity(count + 1);
+				Memory::Construct(elements + count, Memory::Move(value));
+			}
 			count += 1;
+			return elements[count - 1];
 		}
 		void Insert(int32 index, const T& value) {
+			Insert(index, T(value));
+		}
+		void Insert(int32 index, T&& value) {
 			ERR_ASSERT(index >= 0 && index <= count, u8"index out of bounds.", return);
 			
 			if (index == count) {
-				Add(value);
+				Emplace(Memory::Move(value));
 				return;
 			}
 
+			// The value may be an element of this list, take it out before shifting.
+			T inserted(Memory::Move(value));
 			EnsureCapacity(count + 1);
 			
-			// Move objects.
-			for (int32 i = count; i > index; i -= 1) {
-				if (i == count) {
-					Memory::Construct(elements + i, *(elements + i - 1));
-				} else {
-					*(elements + i) = *(elements + i - 1);
+			// Shift the tail one step back.
+			if constexpr (Memory::IsTriviallyRelocatable<T>()) {
+				std::memmove((void*)(elements + index + 1), (const void*)(elements + index), (count - index) * sizeof(T));
+				Memory::Construct(elements + index, Memory::Move(inserted));
+			} else {
+				Memory::Construct(elements + count, Memory::Move(elements[count - 1]));
+				for (int32 i = count - 1; i > index; i -= 1) {
+					elements[i] = Memory::Move(elements[i - 1]);
 				}
+				elements[index] = Memory::Move(inserted);
 			}
-
-			// Assign
-			*(elements + index) = value;
 			
 			count += 1;
 		}
 		void RemoveAt(int32 index) {
 			ERR_ASSERT(index >= 0 && index < count, u8"index out of bounds", return);
 
-			// Move object routine.
-			if (index < count - 1) {
+			// Shift the tail one step forward.
+			if constexpr (Memory::IsTriviallyRelocatable<T>()) {
+				Memory::Destruct(elements + index);
+				std::memmove((void*)(elements + index), (const void*)(elements + index + 1), (count - index - 1) * sizeof(T));
+			} else {
 				for (int32 i = index; i < count - 1; i += 1) {
-					*(elements + i) = *(elements + i + 1);
+					elements[i] = Memory::Move(elements[i + 1]);
 				}
+				Memory::Destruct(elements + count - 1);
 			}
 
-			// Destruct the last element.
-			Memory::Destruct(elements + count - 1);
-
 			count -= 1;
 		}
 		void Clear() {
@@ -178,7 +225,10 @@ namespace Engine{
 		void CopyFromOther(const List& obj) {
 			capacity = obj.capacity;
 			count = obj.count;
-			elements = (T*)Memory::Allocate(sizeof(T) * count);
+			if (capacity == 0) {
+				return;
+			}
+			elements = (T*)Allocator::Allocate(sizeof(T) * capacity);
 			for (int32 i = 0; i < count; i += 1) {
 				Memory::Construct(elements + i, *(obj.elements + i));
 			}
@@ -190,7 +240,9 @@ namespace Engine{
 			for (int32 i = 0; i < count; i += 1) {
 				Memory::Destruct(elements + i);
 			}
-			Memory::Deallocate(elements);
+			Allocator::Deallocate(elements);
+			// Copying an empty list leaves this untouched.
+			elements = nullptr;
 		}
 		T* elements = nullptr;
 		int32 capacity = 0;
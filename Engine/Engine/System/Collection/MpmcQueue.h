@@ -0,0 +1,132 @@
+#pragma once
+#include "Engine/System/Definition.h"
+#include "Engine/System/Memory/Memory.h"
+#include "Engine/System/Thread/ThreadUtil.h"
+#include <atomic>
+
+// Bounded queue after Dmitry Vyukov's "Bounded MPMC queue" (1024cores.net).
+
+namespace Engine {
+	/// @brief A bounded lock-free FIFO queue, any thread may push and pop.\n
+	/// Each cell carries a sequence number telling whether it is ready to be written or read at a position.
+	/// Pushing and popping claim a position with one compare-exchange, then touch only their own cell.
+	/// @tparam T The value type. Needs to be move-constructable.
+	/// @tparam Allocator Where the cells live, see HeapAllocator.
+	template<typename T, typename Allocator = HeapAllocator>
+	class MpmcQueue final {
+		static_assert(alignof(T) <= Memory::Alignment, "Allocator blocks are only aligned to Memory::Alignment.");
+	public:
+		/// @param capacity Rounded up to a power of 2, at least 2.
+		MpmcQueue(int32 capacity) {
+			int32 size = 2;
+			while (size < capacity) {
+				size *= 2;
+			}
+			mask = size - 1;
+			cells = (Cell*)Allocator::Allocate(size * sizeof(Cell));
+			for (int32 i = 0; i < size; i += 1) {
+				Memory::Construct(&cells[i].sequence, static_cast<int64>(i));
+			}
+		}
+		/// @brief Destruct the values left. No other thread may use the queue any more.
+		~MpmcQueue() {
+			int64 end = enqueuePosition.load(std::memory_order_relaxed);
+			for (int64 i = dequeuePosition.load(std::memory_order_relaxed); i < end; i += 1) {
+				Memory::Destruct(cells[i & mask].GetValue());
+			}
+			Allocator::Deallocate(cells);
+		}
+
+		MpmcQueue(const MpmcQueue&) = delete;
+		MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+		bool TryPush(const T& value) {
+			return TryEmplace(value);
+		}
+		bool TryPush(T&& value) {
+			return TryEmplace(Memory::Move(value));
+		}
+		/// @brief Construct a value at the back from the arguments.
+		/// @return false if the queue is full, nothing is constructed then.
+		template<typename ... Args>
+		bool TryEmplace(Args&& ... args) {
+			int64 position = enqueuePosition.load(std::memory_order_relaxed);
+			Cell* cell = nullptr;
+			while (true) {
+				cell = &cells[position & mask];
+				int64 difference = cell->sequence.load(std::memory_order_acquire) - position;
+				if (difference == 0) {
+					// The cell is free at this position, claim it.
+					if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+						break;
+					}
+				} else if (difference < 0) {
+					// Still holding the value from one lap ago, full.
+					return false;
+				} else {
+					// Another producer got here first.
+					position = enqueuePosition.load(std::memory_order_relaxed);
+				}
+			}
+
+			Memory::Construct(cell->GetValue(), Memory::Forward<Args>(args)...);
+			cell->sequence.store(position + 1, std::memory_order_release);
+			return true;
+		}
+		/// @return false if the queue is empty.
+		bool TryPop(T& result) {
+			int64 position = dequeuePosition.load(std::memory_order_relaxed);
+			Cell* cell = nullptr;
+			while (true) {
+				cell = &cells[position & mask];
+				int64 difference = cell->sequence.load(std::memory_order_acquire) - (position + 1);
+				if (difference == 0) {
+					if (dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+						break;
+					}
+				} else if (difference < 0) {
+					// Not written yet, empty.
+					return false;
+				} else {
+					position = dequeuePosition.load(std::memory_order_relaxed);
+				}
+			}
+
+			T* value = cell->GetValue();
+			result = Memory::Move(*value);
+			Memory::Destruct(value);
+			// Free for the producer of the next lap.
+			cell->sequence.store(position + mask + 1, std::memory_order_release);
+			return true;
+		}
+
+		int32 GetCapacity() const {
+			return mask + 1;
+		}
+		/// @brief Get an approximate element count. Exact only when no other thread is pushing or popping.
+		int32 GetCount() const {
+			int64 dequeued = dequeuePosition.load(std::memory_order_relaxed);
+			int64 enqueued = enqueuePosition.load(std::memory_order_relaxed);
+			return enqueued > dequeued ? static_cast<int32>(enqueued - dequeued) : 0;
+		}
+		bool IsEmpty() const {
+			return GetCount() == 0;
+		}
+
+	private:
+		struct Cell {
+			std::atomic<int64> sequence;
+			alignas(T) byte storage[sizeof(T)];
+
+			T* GetValue() {
+				return reinterpret_cast<T*>(storage);
+			}
+		};
+
+		Cell* cells = nullptr;
+		int32 mask = 0;
+		// Producers hammer one position and consumers the other, keep them on their own cache lines.
+		alignas(ThreadUtil::CacheLineSize) std::atomic<int64> enqueuePosition{ 0 };
+		alignas(ThreadUtil::CacheLineSize) std::atomic<int64> dequeuePosition{ 0 };
+	};
+}
@@ -0,0 +1,254 @@
+#pragma once
+#include "Engine/System/Collection/Algorithm.h"
+#include "Engine/System/Collection/List.h"
+#include "Engine/System/Thread/JobSystem.h"
+
+namespace Engine {
+	/// @brief The sorts of Algorithm spread over the workers of a JobSystem.\n
+	/// The calling thread works too and the functions return once the elements are sorted.
+	/// Ranges shorter than SerialThreshold are sorted on the calling thread alone.
+	class ParallelAlgorithm final {
+	public:
+		STATIC_CLASS(ParallelAlgorithm);
+
+		/// @brief Below this many elements per piece, splitting the work costs more than it saves.
+		static inline constexpr int32 SerialThreshold = 16384;
+		/// @brief Pieces per thread, so a slow piece doesn't hold up the others for long.
+		static inline constexpr int32 PiecesPerThread = 2;
+
+		/// @brief Sort in place, not stable. Pieces are sorted with Algorithm::Sort() in parallel, then merged in parallel.\n
+		/// Allocates a buffer of count elements.
+		template<typename T, typename TLess = Algorithm::Less>
+		static void Sort(JobSystem& system, T* values, int32 count, TLess less = {}) {
+			MergeSort<false>(system, values, count, less);
+		}
+		/// @brief Sort in place, elements which are equivalent keep their order.\n
+		/// Pieces are sorted with Algorithm::StableSort() in parallel, then merged in parallel. Allocates a buffer of count elements.
+		template<typename T, typename TLess = Algorithm::Less>
+		static void StableSort(JobSystem& system, T* values, int32 count, TLess less = {}) {
+			MergeSort<true>(system, values, count, less);
+		}
+		/// @brief Sort by integer or floating point keys, stable, see Algorithm::RadixSort().\n
+		/// Each pass counts the digits of every piece in parallel, then the pieces scatter their elements in parallel.
+		/// @param keyOf Called as keyOf(const T&) from several threads at once.
+		template<typename T, typename TKeyOf = Algorithm::Identity>
+		static void RadixSort(JobSystem& system, T* values, int32 count, TKeyOf keyOf = {}) {
+			using Key = decltype(Algorithm::ToRadixKey(keyOf(*values)));
+			constexpr int32 PassCount = sizeof(Key);
+			constexpr int32 DigitCount = Algorithm::RadixDigitCount;
+			int32 pieces = GetPieceCount(system, count);
+			if (pieces <= 1) {
+				Algorithm::RadixSort(values, count, keyOf);
+				return;
+			}
+
+			// histograms[piece * DigitCount + digit], the counts of a pass turned into the scatter offsets.
+			List<int32> counts(pieces * DigitCount);
+			for (int32 i = 0; i < pieces * DigitCount; i += 1) {
+				counts.Add(0);
+			}
+			int32* histograms = counts.GetRawElementPtr();
+
+			T* buffer = nullptr;
+			T* source = values;
+			T* target = nullptr;
+			bool constructed = false;
+			for (int32 pass = 0; pass < PassCount; pass += 1) {
+				int32 shift = pass * 8;
+				system.ParallelFor(0, pieces, 1, [=, &keyOf](int32 pieceBegin, int32 pieceEnd) {
+					for (int32 piece = pieceBegin; piece < pieceEnd; piece += 1) {
+						int32* histogram = histograms + piece * DigitCount;
+						for (int32 digit = 0; digit < DigitCount; digit += 1) {
+							histogram[digit] = 0;
+						}
+						for (int32 i = GetPieceBegin(count, pieces, piece); i < GetPieceBegin(count, pieces, piece + 1); i += 1) {
+							histogram[(Algorithm::ToRadixKey(keyOf(source[i])) >> shift) & (DigitCount - 1)] += 1;
+						}
+					}
+				});
+
+				// Digit by digit, piece by piece, so the pieces keep their order within a digit.
+				int32 offset = 0;
+				bool skip = false;
+				for (int32 digit = 0; digit < DigitCount && !skip; digit += 1) {
+					int32 start = offset;
+					for (int32 piece = 0; piece < pieces; piece += 1) {
+						int32 pieceCount = histograms[piece * DigitCount + digit];
+						histograms[piece * DigitCount + digit] = offset;
+						offset += pieceCount;
+					}
+					// Every key has the same digit, nothing would move.
+					skip = offset - start == count;
+				}
+				if (skip) {
+					continue;
+				}
+				if (buffer == nullptr) {
+					buffer = (T*)Memory::Allocate(count * sizeof(T));
+					target = buffer;
+				}
+
+				bool construct = target == buffer && !constructed;
+				system.ParallelFor(0, pieces, 1, [=, &keyOf](int32 pieceBegin, int32 pieceEnd) {
+					for (int32 piece = pieceBegin; piece < pieceEnd; piece += 1) {
+						int32* offsets = histograms + piece * DigitCount;
+						for (int32 i = GetPieceBegin(count, pieces, piece); i < GetPieceBegin(count, pieces, piece + 1); i += 1) {
+							int32 digit = static_cast<int32>((Algorithm::ToRadixKey(keyOf(source[i])) >> shift) & (DigitCount - 1));
+							T* slot = target + offsets[digit];
+							offsets[digit] += 1;
+							if (construct) {
+								Memory::Construct(slot, Memory::Move(source[i]));
+							} else {
+								*slot = Memory::Move(source[i]);
+							}
+						}
+					}
+				});
+				constructed = constructed || construct;
+				T* swap = source;
+				source = target;
+				target = swap;
+			}
+
+			if (buffer != nullptr) {
+				FinishBuffer(system, values, buffer, count, source == buffer);
+			}
+		}
+
+	private:
+		struct MergeTask {
+			int32 aBegin;
+			int32 aEnd;
+			int32 bBegin;
+			int32 bEnd;
+			int32 target;
+		};
+
+		template<bool Stable, typename T, typename TLess>
+		static void MergeSort(JobSystem& system, T* values, int32 count, TLess& less) {
+			int32 pieces = GetPieceCount(system, count);
+			if (pieces <= 1) {
+				if constexpr (Stable) {
+					Algorithm::StableSort(values, count, less);
+				} else {
+					Algorithm::Sort(values, count, less);
+				}
+				return;
+			}
+
+			system.ParallelFor(0, pieces, 1, [=, &less](int32 pieceBegin, int32 pieceEnd) {
+				for (int32 piece = pieceBegin; piece < pieceEnd; piece += 1) {
+					int32 begin = GetPieceBegin(count, pieces, piece);
+					if constexpr (Stable) {
+						Algorithm::StableSort(values + begin, GetPieceBegin(count, pieces, piece + 1) - begin, less);
+					} else {
+						Algorithm::Sort(values + begin, GetPieceBegin(count, pieces, piece + 1) - begin, less);
+					}
+				}
+			});
+
+			// Merge pairs of runs until one is left. Each merge is cut into tasks along its output,
+			// so the last passes, merging a few long runs, still keep every thread busy.
+			List<int32> runs(pieces + 1);
+			for (int32 piece = 0; piece <= pieces; piece += 1) {
+				runs.Add(GetPieceBegin(count, pieces, piece));
+			}
+			int32 taskLength = count / pieces;
+			List<MergeTask> tasks(pieces * 2);
+			T* buffer = (T*)Memory::Allocate(count * sizeof(T));
+			T* source = values;
+			T* target = buffer;
+			bool constructed = false;
+			while (runs.GetCount() > 2) {
+				tasks.Clear();
+				List<int32> merged(runs.GetCount() / 2 + 2);
+				for (int32 i = 0; i + 1 < runs.GetCount(); i += 2) {
+					int32 aBegin = runs.Get(i);
+					int32 aEnd = runs.Get(i + 1);
+					// An odd run out is merged with nothing, which moves it over.
+					int32 bEnd = i + 2 < runs.GetCount() ? runs.Get(i + 2) : aEnd;
+					merged.Add(aBegin);
+					AddMergeTasks(tasks, source, aBegin, aEnd, aEnd, bEnd, taskLength, less);
+				}
+				merged.Add(count);
+
+				MergeTask* rawTasks = tasks.GetRawElementPtr();
+				bool construct = !constructed;
+				system.ParallelFor(0, tasks.GetCount(), 1, [=, &less](int32 taskBegin, int32 taskEnd) {
+					for (int32 i = taskBegin; i < taskEnd; i += 1) {
+						const MergeTask& task = rawTasks[i];
+						if (construct) {
+							Algorithm::Merge<true>(source + task.aBegin, task.aEnd - task.aBegin, source + task.bBegin, task.bEnd - task.bBegin, target + task.target, less);
+						} else {
+							Algorithm::Merge<false>(source + task.aBegin, task.aEnd - task.aBegin, source + task.bBegin, task.bEnd - task.bBegin, target + task.target, less);
+						}
+					}
+				});
+				constructed = true;
+				runs = Memory::Move(merged);
+				T* swap = source;
+				source = target;
+				target = swap;
+			}
+
+			FinishBuffer(system, values, buffer, count, source == buffer);
+		}
+		/// @brief Cut the merge of [aBegin, aEnd) and [bBegin, bEnd) into tasks writing about length elements each.
+		template<typename T, typename TLess>
+		static void AddMergeTasks(List<MergeTask>& tasks, const T* source, int32 aBegin, int32 aEnd, int32 bBegin, int32 bEnd, int32 length, TLess& less) {
+			int32 total = aEnd - aBegin + bEnd - bBegin;
+			int32 aSplit = aBegin;
+			int32 bSplit = bBegin;
+			for (int32 done = length; ; done += length) {
+				int32 aNext = aEnd;
+				int32 bNext = bEnd;
+				if (done < total) {
+					aNext = aBegin + SplitMerge(source + aBegin, aEnd - aBegin, source + bBegin, bEnd - bBegin, done, less);
+					bNext = bBegin + done - (aNext - aBegin);
+				}
+				tasks.Add(MergeTask{ aSplit, aNext, bSplit, bNext, aSplit + bSplit - bBegin });
+				aSplit = aNext;
+				bSplit = bNext;
+				if (done >= total) {
+					return;
+				}
+			}
+		}
+		/// @brief Get how many elements of a the first outputCount elements of a stable merge of a and b take.
+		template<typename T, typename TLess>
+		static int32 SplitMerge(const T* a, int32 aCount, const T* b, int32 bCount, int32 outputCount, TLess& less) {
+			// a[i] is among the first outputCount when fewer than outputCount - i elements of b go before it.
+			int32 low = outputCount > bCount ? outputCount - bCount : 0;
+			int32 high = outputCount < aCount ? outputCount : aCount;
+			while (low < high) {
+				int32 i = (low + high) / 2;
+				if (!less(b[outputCount - i - 1], a[i])) {
+					low = i + 1;
+				} else {
+					high = i;
+				}
+			}
+			return low;
+		}
+		/// @brief Move the result back if it ended up in the buffer, then free the buffer.
+		template<typename T>
+		static void FinishBuffer(JobSystem& system, T* values, T* buffer, int32 count, bool resultInBuffer) {
+			if (resultInBuffer) {
+				system.ParallelFor(0, count, 0, [values, buffer](int32 begin, int32 end) {
+					for (int32 i = begin; i < end; i += 1) {
+						values[i] = Memory::Move(buffer[i]);
+					}
+				});
+			}
+			Algorithm::FreeBuffer(buffer, count);
+		}
+		static int32 GetPieceCount(JobSystem& system, int32 count) {
+			int32 pieces = (system.GetWorkerCount() + 1) * PiecesPerThread;
+			int32 limit = count / SerialThreshold;
+			return pieces < limit ? pieces : limit;
+		}
+		static int32 GetPieceBegin(int32 count, int32 pieces, int32 piece) {
+			return static_cast<int32>(static_cast<int64>(count) * piece / pieces);
+		}
+	};
+}
@@ -0,0 +1,182 @@
+#pragma once
+#include "Engine/System/Definition.h"
+#include "Engine/System/Collection/List.h"
+#include "Engine/System/Object/ObjectUtil.h"
+
+namespace Engine {
+	/// @brief A handle of a value in a SlotMap: a slot index and the generation of the slot when the value was added.\n
+	/// The default handle never refers to a value.
+	struct SlotHandle final {
+		uint32 index = 0;
+		/// @brief Always odd for a handle given by a SlotMap.
+		uint32 generation = 0;
+
+		bool IsNull() const {
+			return generation == 0;
+		}
+		/// @brief Pack into 64 bits, generation high and index low.
+		uint64 Get() const {
+			return (static_cast<uint64>(generation) << 32) | index;
+		}
+		bool operator==(const SlotHandle& obj) const {
+			return index == obj.index && generation == obj.generation;
+		}
+		bool operator!=(const SlotHandle& obj) const {
+			return !(*this == obj);
+		}
+		int32 GetHashCode() const {
+			return ObjectUtil::GetHashCode(Get());
+		}
+	};
+
+	/// @brief A container giving out generational handles to its values.\n
+	/// Values are stored densely in one array, iteration is a linear walk. Adding and removing are O(1),
+	/// removing moves the last value into the hole. A handle finds its value through its slot without hashing.
+	/// Removing a value bumps the generation of its slot, so old handles to it are detected and fail instead of dangling.
+	/// An old handle could only match again after its slot is reused 2^31 times.
+	/// @tparam T The value type. Needs to be move-constructable.
+	/// @tparam Allocator Where the values and slots live, see HeapAllocator.
+	template<typename T, typename Allocator = HeapAllocator>
+	class SlotMap final {
+	public:
+		using Iterator = ReadonlyIterator<T>;
+
+		SlotMap(int32 capacity = 0) :values(capacity), valueSlots(capacity), slots(capacity) {}
+
+		int32 GetCount() const {
+			return values.GetCount();
+		}
+		/// @brief Make room for capacity values without growing.
+		void EnsureCapacity(int32 capacity) {
+			values.EnsureCapacity(capacity);
+			valueSlots.EnsureCapacity(capacity);
+			slots.EnsureCapacity(capacity);
+		}
+
+		SlotHandle Add(const T& value) {
+			return Emplace(value);
+		}
+		SlotHandle Add(T&& value) {
+			return Emplace(Memory::Move(value));
+		}
+		/// @brief Construct a new value from the arguments.
+		/// @return The handle of the new value.
+		template<typename ... Args>
+		SlotHandle Emplace(Args&& ... args) {
+			int32 denseIndex = values.GetCount();
+			values.Emplace(Memory::Forward<Args>(args)...);
+
+			int32 slotIndex = freeHead;
+			if (slotIndex >= 0) {
+				freeHead = slots.GetRawElementPtr()[slotIndex].index;
+				slots.GetRawElementPtr()[slotIndex].generation += 1;
+			} else {
+				slotIndex = slots.GetCount();
+				slots.Add(Slot{ 1, 0 });
+			}
+			Slot& slot = slots.GetRawElementPtr()[slotIndex];
+			slot.index = denseIndex;
+			valueSlots.Add(slotIndex);
+
+			return SlotHandle{ static_cast<uint32>(slotIndex), slot.generation };
+		}
+		/// @brief Remove the value of a handle. The last value moves into its place.
+		/// @return false if the handle does not refer to a value.
+		bool Remove(const SlotHandle& handle) {
+			if (!Contains(handle)) {
+				return false;
+			}
+
+			Slot& slot = slots.GetRawElementPtr()[handle.index];
+			int32 denseIndex = slot.index;
+			int32 lastIndex = values.GetCount() - 1;
+			if (denseIndex != lastIndex) {
+				int32 lastSlot = valueSlots.GetRawElementPtr()[lastIndex];
+				values.Set(denseIndex, Memory::Move(values.GetRawElementPtr()[lastIndex]));
+				valueSlots.Set(denseIndex, lastSlot);
+				slots.GetRawElementPtr()[lastSlot].index = denseIndex;
+			}
+			values.RemoveAt(lastIndex);
+			valueSlots.RemoveAt(lastIndex);
+
+			FreeSlot(static_cast<int32>(handle.index));
+			return true;
+		}
+		/// @brief Remove every value. Every handle given so far stops referring to a value.
+		void Clear() {
+			for (int32 i = 0; i < valueSlots.GetCount(); i += 1) {
+				FreeSlot(valueSlots.GetRawElementPtr()[i]);
+			}
+			values.Clear();
+			valueSlots.Clear();
+		}
+
+		/// @brief Check if the handle refers to a value, i.e. the value is not removed.
+		bool Contains(const SlotHandle& handle) const {
+			return (handle.generation & 1) != 0 && handle.index < static_cast<uint32>(slots.GetCount()) && slots.GetRawElementPtr()[handle.index].generation == handle.generation;
+		}
+		bool TryGet(const SlotHandle& handle, T& result) const {
+			const T* value = GetPtr(handle);
+			if (value == nullptr) {
+				return false;
+			}
+			result = *value;
+			return true;
+		}
+		/// @brief Get the value of a handle in place.
+		/// @return nullptr if the handle does not refer to a value. Valid until the next add or remove.
+		T* GetPtr(const SlotHandle& handle) {
+			return Contains(handle) ? values.GetRawElementPtr() + slots.GetRawElementPtr()[handle.index].index : nullptr;
+		}
+		/// @brief Get the value of a handle in place.
+		/// @return nullptr if the handle does not refer to a value. Valid until the next add or remove.
+		const T* GetPtr(const SlotHandle& handle) const {
+			return Contains(handle) ? values.GetRawElementPtr() + slots.GetRawElementPtr()[handle.index].index : nullptr;
+		}
+		/// @brief Get the handle of the value at a dense index, 0 to GetCount() - 1.
+		SlotHandle GetHandle(int32 denseIndex) const {
+			ERR_ASSERT(denseIndex >= 0 && denseIndex < values.GetCount(), u8"index out of bounds.", return SlotHandle());
+			int32 slotIndex = valueSlots.GetRawElementPtr()[denseIndex];
+			return SlotHandle{ static_cast<uint32>(slotIndex), slots.GetRawElementPtr()[slotIndex].generation };
+		}
+
+		/// @brief Get the dense values for high performance operation, if you know what you are doing.\n
+		/// Only read or write existing values. The pointer and the order vary after an add or remove operation!
+		T* GetRawElementPtr() {
+			return values.GetRawElementPtr();
+		}
+		/// @brief Get the dense values for high performance operation, if you know what you are doing.\n
+		/// Only read existing values. The pointer and the order vary after an add or remove operation!
+		const T* GetRawElementPtr() const {
+			return values.GetRawElementPtr();
+		}
+
+		Iterator begin() const {
+			return values.begin();
+		}
+		Iterator end() const {
+			return values.end();
+		}
+
+	private:
+		struct Slot {
+			/// @brief Bumped on every add and remove, odd while the slot holds a value.
+			uint32 generation;
+			/// @brief The dense index of the value if the slot is used, the next free slot or -1 otherwise.
+			int32 index;
+		};
+
+		void FreeSlot(int32 slotIndex) {
+			Slot& slot = slots.GetRawElementPtr()[slotIndex];
+			slot.generation += 1;
+			slot.index = freeHead;
+			freeHead = slotIndex;
+		}
+
+		List<T, Allocator> values;
+		/// @brief The slot of each dense value, for fixing up the slot of the value moved by a remove.
+		List<int32, Allocator> valueSlots;
+		List<Slot, Allocator> slots;
+		int32 freeHead = -1;
+	};
+}
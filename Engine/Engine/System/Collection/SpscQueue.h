@@ -0,0 +1,108 @@
+#pragma once
+#include "Engine/System/Definition.h"
+#include "Engine/System/Memory/Memory.h"
+#include "Engine/System/Thread/ThreadUtil.h"
+#include <atomic>
+
+namespace Engine {
+	/// @brief A bounded lock-free FIFO queue between one producer thread and one consumer thread.\n
+	/// Each side keeps a copy of the other side's index and only reloads it when the queue looks full or empty,
+	/// so in a steady stream the sides rarely touch each other's cache line.
+	/// @tparam T The value type. Needs to be move-constructable.
+	/// @tparam Allocator Where the elements live, see HeapAllocator.
+	template<typename T, typename Allocator = HeapAllocator>
+	class SpscQueue final {
+		static_assert(alignof(T) <= Memory::Alignment, "Allocator blocks are only aligned to Memory::Alignment.");
+	public:
+		/// @param capacity Rounded up to a power of 2, at least 2.
+		SpscQueue(int32 capacity) {
+			int32 size = 2;
+			while (size < capacity) {
+				size *= 2;
+			}
+			mask = size - 1;
+			elements = (T*)Allocator::Allocate(size * sizeof(T));
+		}
+		/// @brief Destruct the values left. Neither side may use the queue any more.
+		~SpscQueue() {
+			int64 end = producer.tail.load(std::memory_order_relaxed);
+			for (int64 i = consumer.head.load(std::memory_order_relaxed); i < end; i += 1) {
+				Memory::Destruct(elements + (i & mask));
+			}
+			Allocator::Deallocate(elements);
+		}
+
+		SpscQueue(const SpscQueue&) = delete;
+		SpscQueue& operator=(const SpscQueue&) = delete;
+
+		/// @brief Producer thread only.
+		bool TryPush(const T& value) {
+			return TryEmplace(value);
+		}
+		/// @brief Producer thread only.
+		bool TryPush(T&& value) {
+			return TryEmplace(Memory::Move(value));
+		}
+		/// @brief Construct a value at the back from the arguments. Producer thread only.
+		/// @return false if the queue is full, nothing is constructed then.
+		template<typename ... Args>
+		bool TryEmplace(Args&& ... args) {
+			int64 tail = producer.tail.load(std::memory_order_relaxed);
+			if (tail - producer.cachedHead > mask) {
+				producer.cachedHead = consumer.head.load(std::memory_order_acquire);
+				if (tail - producer.cachedHead > mask) {
+					return false;
+				}
+			}
+
+			Memory::Construct(elements + (tail & mask), Memory::Forward<Args>(args)...);
+			producer.tail.store(tail + 1, std::memory_order_release);
+			return true;
+		}
+		/// @brief Consumer thread only.
+		/// @return false if the queue is empty.
+		bool TryPop(T& result) {
+			int64 head = consumer.head.load(std::memory_order_relaxed);
+			if (head == consumer.cachedTail) {
+				consumer.cachedTail = producer.tail.load(std::memory_order_acquire);
+				if (head == consumer.cachedTail) {
+					return false;
+				}
+			}
+
+			T* value = elements + (head & mask);
+			result = Memory::Move(*value);
+			Memory::Destruct(value);
+			consumer.head.store(head + 1, std::memory_order_release);
+			return true;
+		}
+
+		int32 GetCapacity() const {
+			return mask + 1;
+		}
+		/// @brief Get an approximate element count, the other side may change it meanwhile.
+		int32 GetCount() const {
+			int64 head = consumer.head.load(std::memory_order_acquire);
+			int64 tail = producer.tail.load(std::memory_order_acquire);
+			return tail > head ? static_cast<int32>(tail - head) : 0;
+		}
+		bool IsEmpty() const {
+			return GetCount() == 0;
+		}
+
+	private:
+		struct alignas(ThreadUtil::CacheLineSize) ProducerSide {
+			std::atomic<int64> tail{ 0 };
+			int64 cachedHead = 0;
+		};
+		struct alignas(ThreadUtil::CacheLineSize) ConsumerSide {
+			std::atomic<int64> head{ 0 };
+			int64 cachedTail = 0;
+		};
+
+		T* elements = nullptr;
+		int32 mask = 0;
+		ProducerSide producer{};
+		ConsumerSide consumer{};
+	};
+}
@@ -1,5 +1,7 @@
 #pragma once
 #include "Engine/System/Definition.h"
+#include <concepts>
+#include <type_traits>
 
 namespace Engine {
 	class Object;
@@ -14,5 +16,15 @@ namespace Engine {
 
 		template<typename T>
 		concept IsEnum = std::is_enum_v<T>;
+
+		template<typename F, typename ... Args>
+		concept IsInvocable = std::is_invocable_v<F, Args...>;
+
+		/// @brief TLookup finds TKey keys without being converted to TKey, like std::u8string_view for String.
+		/// Equal values must have the same hash code.
+		template<typename TLookup, typename TKey>
+		concept IsLookupKeyOf = !std::is_convertible_v<const TLookup&, TKey> && requires(const TKey& key, const TLookup& lookup) {
+			{ key == lookup } -> std::convertible_to<bool>;
+		};
 	}
 }
\ No newline at end of file
@@ -2,7 +2,7 @@
 #include "Engine/System/Stream.h"
 
 namespace Engine {
-	template<typename T>
+	template<typename T, typename Allocator>
 	class List;
 
 	class FileStream :public Stream {
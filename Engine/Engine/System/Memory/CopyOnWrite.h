@@ -4,6 +4,8 @@ namespace Engine {
 	template<typename T>
 	class CopyOnWrite {
 	public:
+		TRIVIALLY_RELOCATABLE;
+
 		CopyOnWrite() {}
 		CopyOnWrite(T* ptr) :ptr(SharedPtr<T>(ptr)) {}
 
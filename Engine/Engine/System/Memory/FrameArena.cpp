@@ -0,0 +1,150 @@
+#include "Engine/System/Memory/FrameArena.h"
+#include "Engine/System/Debug.h"
+#include <cstring>
+
+namespace Engine {
+#pragma region FrameArena
+	std::atomic<FrameArena*> FrameArena::current{ nullptr };
+
+	FrameArena::FrameArena(int32 frameCount, sizeint pageSize) :frameCount(frameCount), pageSize(pageSize) {
+		ERR_ASSERT(frameCount >= 1 && frameCount <= MaxFrameCount, u8"frameCount out of range.", this->frameCount = DefaultFrameCount);
+
+		// Start every frame with one page, the common case never takes the lock.
+		for (int32 i = 0; i < this->frameCount; i += 1) {
+			Page* page = CreatePage(pageSize);
+			frames[i].first = page;
+			frames[i].current.store(page, std::memory_order_relaxed);
+		}
+	}
+	FrameArena::~FrameArena() {
+		FrameArena* self = this;
+		current.compare_exchange_strong(self, nullptr);
+
+		for (Frame& frame : frames) {
+			Page* page = frame.first;
+			while (page != nullptr) {
+				Page* next = page->next;
+				Memory::Deallocate(page);
+				page = next;
+			}
+		}
+	}
+
+	void* FrameArena::Allocate(sizeint size, sizeint alignment, uint64* outFrameIndex) {
+		ERR_ASSERT(size > 0, u8"size must be larger than 0.", return nullptr);
+		ERR_ASSERT(alignment > 0 && (alignment & (alignment - 1)) == 0, u8"alignment must be a power of 2.", return nullptr);
+
+		sizeint padded = (size + Alignment - 1) / Alignment * Alignment;
+		if (alignment > Alignment) {
+			padded += alignment - Alignment;
+		}
+
+		// The index is read once, an AdvanceFrame() after this leaves the frame's pages alone.
+		uint64 index = frameIndex.load(std::memory_order_acquire);
+		Frame& frame = frames[index % frameCount];
+		if (outFrameIndex != nullptr) {
+			*outFrameIndex = index;
+		}
+		while (true) {
+			Page* page = frame.current.load(std::memory_order_acquire);
+			sizeint offset = page->offset.fetch_add(padded, std::memory_order_relaxed);
+			if (offset + padded <= page->capacity) {
+				uintptr_t result = (uintptr_t)(page->GetData() + offset);
+				if (alignment > Alignment) {
+					result = (result + alignment - 1) & ~(uintptr_t)(alignment - 1);
+				}
+				return (void*)result;
+			}
+			NextPage(frame, page, padded);
+		}
+	}
+	void FrameArena::AdvanceFrame() {
+		uint64 next = frameIndex.load(std::memory_order_relaxed) + 1;
+		Frame& frame = frames[next % frameCount];
+		for (Page* page = frame.first; page != nullptr; page = page->next) {
+			page->offset.store(0, std::memory_order_relaxed);
+		}
+		frame.current.store(frame.first, std::memory_order_relaxed);
+		// Publish the rewound pages and the new index together.
+		frameIndex.store(next, std::memory_order_release);
+	}
+
+	int32 FrameArena::GetFrameCount() const {
+		return frameCount;
+	}
+	uint64 FrameArena::GetFrameIndex() const {
+		return frameIndex.load(std::memory_order_relaxed);
+	}
+	bool FrameArena::IsFrameAlive(uint64 frameIndex) const {
+		return GetFrameIndex() - frameIndex < static_cast<uint64>(frameCount);
+	}
+	sizeint FrameArena::GetUsedSize() const {
+		auto lock = SimpleLock<Mutex>(pageMutex);
+		const Frame& frame = frames[frameIndex.load(std::memory_order_acquire) % frameCount];
+		Page* last = frame.current.load(std::memory_order_acquire);
+		sizeint result = 0;
+		for (Page* page = frame.first; page != nullptr; page = page->next) {
+			sizeint offset = page->offset.load(std::memory_order_relaxed);
+			// Failed bumps push the offset past the end of a full page.
+			result += (offset < page->capacity ? offset : page->capacity);
+			if (page == last) {
+				break;
+			}
+		}
+		return result;
+	}
+	sizeint FrameArena::GetReservedSize() const {
+		return reservedSize.load(std::memory_order_relaxed);
+	}
+
+	FrameArena* FrameArena::GetCurrent() {
+		return current.load(std::memory_order_acquire);
+	}
+	void FrameArena::SetCurrent(FrameArena* arena) {
+		current.store(arena, std::memory_order_release);
+	}
+
+	FrameArena::Page* FrameArena::CreatePage(sizeint capacity) {
+		Page* page = (Page*)Memory::Allocate(HeaderSize + capacity);
+		page->next = nullptr;
+		page->capacity = capacity;
+		Memory::Construct(&page->offset, 0);
+		reservedSize.fetch_add(HeaderSize + capacity, std::memory_order_relaxed);
+		return page;
+	}
+	void FrameArena::NextPage(Frame& frame, Page* full, sizeint size) {
+		auto lock = SimpleLock<Mutex>(pageMutex);
+		if (frame.current.load(std::memory_order_relaxed) != full) {
+			// Another thread has moved on already.
+			return;
+		}
+
+		// Rewound pages left from earlier frames come first, pages too small for the request are skipped.
+		Page* previous = full;
+		Page* next = full->next;
+		while (next != nullptr && next->capacity < size) {
+			previous = next;
+			next = next->next;
+		}
+		if (next == nullptr) {
+			next = CreatePage(size > pageSize ? size : pageSize);
+			previous->next = next;
+		}
+		frame.current.store(next, std::memory_order_release);
+	}
+#pragma endregion
+
+#pragma region FrameAllocator
+	void* FrameAllocator::Allocate(sizeint size) {
+		FrameArena* arena = FrameArena::GetCurrent();
+		FATAL_ASSERT(arena != nullptr, u8"No frame arena is active, transient containers only work inside the engine loop.");
+		return arena->Allocate(size);
+	}
+	void* FrameAllocator::Reallocate(void* ptr, sizeint oldSize, sizeint newSize) {
+		// The old block stays behind until the arena rewinds.
+		void* result = Allocate(newSize);
+		std::memcpy(result, ptr, oldSize < newSize ? oldSize : newSize);
+		return result;
+	}
+#pragma endregion
+}
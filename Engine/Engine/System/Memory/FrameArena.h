@@ -0,0 +1,113 @@
+#pragma once
+
+#include "Engine/System/Definition.h"
+#include "Engine/System/Memory/Memory.h"
+#include "Engine/System/Collection/List.h"
+#include "Engine/System/Thread/ThreadUtil.h"
+#include <atomic>
+#include <type_traits>
+
+namespace Engine {
+	/// @brief A bump-pointer allocator for data which only lives for a frame or two.\n
+	/// Memory is handed out from pages by bumping an offset and is never freed one by one.
+	/// The arena keeps frameCount sets of pages. AdvanceFrame() moves on to the oldest set and rewinds it,
+	/// so a block stays valid until frameCount - 1 more frames have ended. Jobs may keep using data of the previous frame.\n
+	/// Allocate() can be called from any thread, also while AdvanceFrame() runs on the loop thread:
+	/// only the oldest frame is rewound, never the one allocations are going to. A block belongs to the frame whose pages
+	/// it was bumped from, which Allocate() reports. With a frameCount of 1 the current frame is the one rewound,
+	/// so AdvanceFrame() must not race allocations then. AdvanceFrame() is called from one thread at a time.
+	class FrameArena final {
+	public:
+		/// @brief Frames a block outlives by default, double buffering.
+		static inline constexpr int32 DefaultFrameCount = 2;
+		static inline constexpr int32 MaxFrameCount = 3;
+		static inline constexpr sizeint DefaultPageSize = 256 * 1024;
+		static inline constexpr sizeint Alignment = 16;
+
+		/// @param frameCount Sets of pages to cycle through, 1 to MaxFrameCount.
+		/// @param pageSize Size of a page. Larger requests get a page of their own.
+		FrameArena(int32 frameCount = DefaultFrameCount, sizeint pageSize = DefaultPageSize);
+		~FrameArena();
+
+		FrameArena(const FrameArena&) = delete;
+		FrameArena& operator=(const FrameArena&) = delete;
+
+		/// @brief Allocate a block valid until frameCount frames have ended.
+		/// @param outFrameIndex Receives the index of the frame the block belongs to, see IsFrameAlive().
+		void* Allocate(sizeint size, sizeint alignment = Alignment, uint64* outFrameIndex = nullptr);
+		/// @brief Allocate an array of default constructed T. Destructors are never called, keep T trivially destructible.
+		template<typename T>
+		T* AllocateArray(int32 count) {
+			static_assert(std::is_trivially_destructible_v<T>, "Frame arena blocks are never destructed.");
+			T* result = (T*)Allocate(sizeof(T) * count, alignof(T) > Alignment ? alignof(T) : Alignment);
+			for (int32 i = 0; i < count; i += 1) {
+				Memory::Construct(result + i);
+			}
+			return result;
+		}
+		/// @brief End the current frame. The oldest frame is rewound and takes the new allocations.
+		void AdvanceFrame();
+
+		int32 GetFrameCount() const;
+		/// @brief Get the count of frames ended so far.
+		uint64 GetFrameIndex() const;
+		/// @brief Indicates if blocks allocated while GetFrameIndex() was frameIndex are still valid.
+		bool IsFrameAlive(uint64 frameIndex) const;
+		/// @brief Get the bytes handed out in the current frame.
+		sizeint GetUsedSize() const;
+		/// @brief Get the bytes of every page held by the arena.
+		sizeint GetReservedSize() const;
+
+		/// @brief Get the arena of the running engine loop, nullptr outside of it.
+		static FrameArena* GetCurrent();
+		static void SetCurrent(FrameArena* arena);
+
+	private:
+		struct Page {
+			Page* next;
+			sizeint capacity;
+			std::atomic<sizeint> offset;
+
+			byte* GetData() {
+				return (byte*)this + HeaderSize;
+			}
+		};
+		static inline constexpr sizeint HeaderSize = (sizeof(Page) + Alignment - 1) / Alignment * Alignment;
+
+		struct alignas(ThreadUtil::CacheLineSize) Frame {
+			/// @brief Every page of the frame, the ones after current are rewound and waiting for reuse.
+			Page* first = nullptr;
+			std::atomic<Page*> current{ nullptr };
+		};
+
+		Page* CreatePage(sizeint capacity);
+		/// @brief Move past a full page, reusing the next rewound one if it is large enough.
+		void NextPage(Frame& frame, Page* full, sizeint size);
+
+		Frame frames[MaxFrameCount];
+		int32 frameCount;
+		sizeint pageSize;
+		/// @brief The frame allocations go to is frames[frameIndex % frameCount], one atomic keeps both in step.
+		std::atomic<uint64> frameIndex{ 0 };
+		std::atomic<sizeint> reservedSize{ 0 };
+		mutable Mutex pageMutex;
+
+		static std::atomic<FrameArena*> current;
+	};
+
+	/// @brief Allocation policy for containers living in the current frame arena, see List.\n
+	/// Deallocate() does nothing, the memory is reclaimed when the arena rewinds.
+	class FrameAllocator final {
+	public:
+		STATIC_CLASS(FrameAllocator);
+
+		static void* Allocate(sizeint size);
+		static void* Reallocate(void* ptr, sizeint oldSize, sizeint newSize);
+		static void Deallocate(void* ptr) {}
+	};
+
+	/// @brief A List in the current frame arena. Growing leaves the old elements behind until the arena rewinds.\n
+	/// Element destructors still run, but the memory is never freed on its own.
+	template<typename T>
+	using TransientList = List<T, FrameAllocator>;
+}
@@ -0,0 +1,176 @@
+#pragma once
+
+#include "Engine/System/Definition.h"
+#include "Engine/System/Thread/ThreadUtil.h"
+#include <atomic>
+
+namespace Engine {
+	/// @brief A free block holding the link of its free list in its first bytes.
+	struct FreeBlock {
+		FreeBlock* next;
+	};
+
+	/// @brief Free blocks shared by every thread, traded in batches with the LocalFreeList of each thread under a lock.\n
+	/// The owner refills it through a carve callback when it runs dry, so it never allocates on its own.
+	/// Constant initialized, allocators used by static constructors can keep it in a global.
+	/// @tparam T The block type. Blocks which must keep their content while free, like jobs, link through a member of their own.
+	/// @tparam Link The member holding the link.
+	template<typename T = FreeBlock, T* T::* Link = &T::next>
+	class SharedFreeList final {
+	public:
+		/// @brief Take up to maxCount blocks.
+		/// @param carve Called under the lock when the list is empty, as `int32 carve(T*& head, T*& tail)`.
+		/// It links new blocks, see LinkBlocks(), and returns their count, 0 when it fails.
+		/// @return The count of blocks in result, 0 only when carve failed.
+		template<typename F>
+		int32 Take(int32 maxCount, T*& result, F&& carve) {
+			auto lock = SimpleLock<Mutex>(mutex);
+			if (head == nullptr) {
+				T* tail = nullptr;
+				int32 carved = carve(head, tail);
+				if (carved == 0) {
+					head = nullptr;
+					result = nullptr;
+					return 0;
+				}
+				count += carved;
+				blockCount += carved;
+			}
+
+			int32 taken = 1;
+			T* tail = head;
+			while (taken < maxCount && tail->*Link != nullptr) {
+				tail = tail->*Link;
+				taken += 1;
+			}
+			result = head;
+			head = tail->*Link;
+			tail->*Link = nullptr;
+			count -= taken;
+			if (blockCount - count > peakTakenCount) {
+				peakTakenCount = blockCount - count;
+			}
+			return taken;
+		}
+		/// @brief Give back a list of pushed blocks from first to last.
+		void Push(T* first, T* last, int32 pushed) {
+			auto lock = SimpleLock<Mutex>(mutex);
+			last->*Link = head;
+			head = first;
+			count += pushed;
+		}
+
+		/// @brief Get the count of blocks in the list.
+		int32 GetCount() const {
+			auto lock = SimpleLock<Mutex>(mutex);
+			return count;
+		}
+		/// @brief Get the count of blocks carved so far.
+		int32 GetBlockCount() const {
+			auto lock = SimpleLock<Mutex>(mutex);
+			return blockCount;
+		}
+		/// @brief Get the count of blocks out of the list right now, in use or in thread free lists.
+		int32 GetTakenCount() const {
+			auto lock = SimpleLock<Mutex>(mutex);
+			return blockCount - count;
+		}
+		/// @brief Get the highest GetTakenCount() so far.
+		int32 GetPeakTakenCount() const {
+			auto lock = SimpleLock<Mutex>(mutex);
+			return peakTakenCount;
+		}
+
+		/// @brief Link blockCount blocks laid out every stride bytes from memory, in address order. For carve callbacks.
+		/// @return blockCount.
+		static int32 LinkBlocks(void* memory, sizeint stride, int32 blockCount, T*& head, T*& tail) {
+			head = (T*)memory;
+			tail = head;
+			for (int32 i = 1; i < blockCount; i += 1) {
+				T* block = (T*)((byte*)memory + stride * i);
+				tail->*Link = block;
+				tail = block;
+			}
+			tail->*Link = nullptr;
+			return blockCount;
+		}
+
+	private:
+		mutable Mutex mutex;
+		T* head = nullptr;
+		int32 count = 0;
+		int32 blockCount = 0;
+		int32 peakTakenCount = 0;
+	};
+
+	/// @brief The free blocks a thread keeps of a SharedFreeList, so most allocations and frees take no lock.\n
+	/// Refills TransferCount blocks at a time, and gives TransferCount back once it holds more than CacheLimit.
+	/// Blocks freed on another thread than the one they came from join the list of that thread.
+	/// Trivially destructible, so a thread local made of it stays usable while other thread locals are torn down. Flush() it when the thread exits.
+	template<int32 TransferCount, int32 CacheLimit, typename T = FreeBlock, T* T::* Link = &T::next>
+	class LocalFreeList final {
+	public:
+		using Shared = SharedFreeList<T, Link>;
+
+		/// @brief Take a block, refilling from shared when empty.
+		/// @param carve Passed to SharedFreeList::Take().
+		/// @return nullptr only when carve failed.
+		template<typename F>
+		T* Pop(Shared& shared, F&& carve) {
+			if (head == nullptr) {
+				SetCount(shared.Take(TransferCount, head, carve));
+				if (head == nullptr) {
+					return nullptr;
+				}
+			}
+			T* block = head;
+			head = block->*Link;
+			SetCount(GetCount() - 1);
+			return block;
+		}
+		/// @brief Keep a free block, giving a batch back to shared past CacheLimit.
+		void Push(Shared& shared, T* block) {
+			block->*Link = head;
+			head = block;
+			SetCount(GetCount() + 1);
+			if (GetCount() > CacheLimit) {
+				Spill(shared, TransferCount);
+			}
+		}
+		/// @brief Give every block back to shared.
+		void Flush(Shared& shared) {
+			if (GetCount() > 0) {
+				Spill(shared, GetCount());
+			}
+		}
+		/// @brief Forget the blocks without giving them back, for when shared is gone.
+		void Reset() {
+			head = nullptr;
+			SetCount(0);
+		}
+
+		/// @brief Get the count of blocks kept. Only written by the owning thread, other threads may read it.
+		int32 GetCount() const {
+			return count.load(std::memory_order_relaxed);
+		}
+
+	private:
+		void SetCount(int32 value) {
+			count.store(value, std::memory_order_relaxed);
+		}
+		/// @brief Move spilled blocks from the head of the list to shared.
+		void Spill(Shared& shared, int32 spilled) {
+			T* first = head;
+			T* last = first;
+			for (int32 i = 1; i < spilled; i += 1) {
+				last = last->*Link;
+			}
+			head = last->*Link;
+			SetCount(GetCount() - spilled);
+			shared.Push(first, last, spilled);
+		}
+
+		T* head = nullptr;
+		std::atomic<int32> count{ 0 };
+	};
+}
@@ -7,6 +7,8 @@ namespace Engine {
 	template<typename T>
 	class IntrusivePtr {
 	public:
+		TRIVIALLY_RELOCATABLE;
+
 		// Create a SharedPtr from the given arguments.
 		template<typename ... Args>
 		static IntrusivePtr Create(Args&& ... args) {
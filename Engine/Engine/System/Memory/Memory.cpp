@@ -1,32 +1,122 @@
 #include "Engine/System/Memory/Memory.h"
+#include "Engine/System/Memory/SizeClassAllocator.h"
+#include "Engine/System/Memory/MemoryTracker.h"
 #include <memory>
 #include "Engine/System/Debug.h"
 
+// Define ENGINE_SYSTEM_ALLOCATOR to send everything straight to malloc, handy for external memory debuggers.
+// Define ENGINE_MEMORY_TRACKING to count every block by call site, see MemoryTracker.
+
 namespace Engine {
-	void* Memory::Allocate(sizeint size) {
+	namespace {
+		void* AllocateBlock(sizeint size) {
+#if defined(ENGINE_SYSTEM_ALLOCATOR)
+			return std::malloc(size);
+#else
+			return SizeClassAllocator::Allocate(size);
+#endif
+		}
+		void* ReallocateBlock(void* ptr, sizeint newSize) {
+#if defined(ENGINE_SYSTEM_ALLOCATOR)
+			return std::realloc(ptr, newSize);
+#else
+			return SizeClassAllocator::Reallocate(ptr, newSize);
+#endif
+		}
+		void DeallocateBlock(void* ptr) {
+#if defined(ENGINE_SYSTEM_ALLOCATOR)
+			std::free(ptr);
+#else
+			SizeClassAllocator::Deallocate(ptr);
+#endif
+		}
+	}
+
+#if defined(ENGINE_MEMORY_TRACKING)
+	void* Memory::Allocate(sizeint size, const std::source_location& location) {
 		ERR_ASSERT(size > 0, u8"size must be larger than 0.", return nullptr);
 
-		void* ptr = std::malloc(size);
-		return ptr;
+		void* block = AllocateBlock(MemoryTracker::HeaderSize + size);
+		if (block == nullptr) {
+			return nullptr;
+		}
+		return MemoryTracker::Track(block, size, location);
 	}
+#else
+	void* Memory::Allocate(sizeint size) {
+		ERR_ASSERT(size > 0, u8"size must be larger than 0.", return nullptr);
+		return AllocateBlock(size);
+	}
+#endif
 	void* Memory::Reallocate(void* ptr, sizeint newSize) {
 		ERR_ASSERT(ptr != nullptr, u8"ptr must not be nullptr!", return nullptr);
 		ERR_ASSERT(newSize > 0, u8"newSize must be larger than 0.", return nullptr);
 
-		void* result = std::realloc(ptr, newSize);
-		return result;
+#if defined(ENGINE_MEMORY_TRACKING)
+		void* block = ReallocateBlock(MemoryTracker::Resize(ptr, newSize), MemoryTracker::HeaderSize + newSize);
+		return block == nullptr ? nullptr : (byte*)block + MemoryTracker::HeaderSize;
+#else
+		return ReallocateBlock(ptr, newSize);
+#endif
 	}
 	void Memory::Deallocate(void* ptr) {
-		std::free(ptr);
+#if defined(ENGINE_MEMORY_TRACKING)
+		if (ptr == nullptr) {
+			return;
+		}
+		DeallocateBlock(MemoryTracker::Untrack(ptr));
+#else
+		DeallocateBlock(ptr);
+#endif
+	}
+#if defined(ENGINE_MEMORY_TRACKING)
+	void* Memory::AllocateAligned(sizeint size, sizeint alignment, const std::source_location& location) {
+#else
+	void* Memory::AllocateAligned(sizeint size, sizeint alignment) {
+#endif
+		ERR_ASSERT((alignment & (alignment - 1)) == 0, u8"alignment must be a power of 2.", return nullptr);
+		if (alignment < Alignment) {
+			alignment = Alignment;
+		}
+
+		// Round up past the start of the block, which leaves at least Alignment bytes in front to remember it.
+#if defined(ENGINE_MEMORY_TRACKING)
+		byte* block = (byte*)Allocate(size + alignment, location);
+#else
+		byte* block = (byte*)Allocate(size + alignment);
+#endif
+		if (block == nullptr) {
+			return nullptr;
+		}
+		byte* result = (byte*)(((uintptr_t)block + alignment) & ~(uintptr_t)(alignment - 1));
+		((byte**)result)[-1] = block;
+		return result;
+	}
+	void Memory::DeallocateAligned(void* ptr) {
+		if (ptr == nullptr) {
+			return;
+		}
+		Deallocate(((byte**)ptr)[-1]);
 	}
 	sizeint Memory::GetHeapArrayElementCount(void* ptr) {
 		return *(((sizeint*)ptr) - 1);
 	}
+
+	MemoryTag Memory::MarkAllocationSite(const std::source_location& location) {
+		MemoryTracker::MarkSite(location);
+		return MemoryTag{};
+	}
 }
 
-void* operator new(size_t size, bool reserved) {
+void* operator new(size_t size, Engine::MemoryTag) {
 	return Engine::Memory::Allocate(size);
 }
-void operator delete(void* ptr, bool reserved){
+void operator delete(void* ptr, Engine::MemoryTag) {
 	Engine::Memory::Deallocate(ptr);
-}
\ No newline at end of file
+}
+void* operator new(size_t size, std::align_val_t alignment, Engine::MemoryTag) {
+	return Engine::Memory::AllocateAligned(size, static_cast<Engine::sizeint>(alignment));
+}
+void operator delete(void* ptr, std::align_val_t, Engine::MemoryTag) {
+	Engine::Memory::DeallocateAligned(ptr);
+}
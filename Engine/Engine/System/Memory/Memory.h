@@ -4,11 +4,21 @@
 #include "Engine/System/Debug.h"
 #include <memory>
 #include <new>
+#include <source_location>
+#include <type_traits>
+
+// Marks a class as trivially relocatable, see Memory::IsTriviallyRelocatable().
+// Put it in the public section of classes whose members hold no pointers into the object itself.
+#define TRIVIALLY_RELOCATABLE using TriviallyRelocatableTag = void
 
 // Partly referenced Godot Engine 3.2.3 source code.
 // https://www.github.com/godotengine/godot
 
 namespace Engine {
+	/// @brief Selects the operator new of the engine heap, see MEMNEW.\n
+	/// A type of its own, a pointer would convert to bool and turn placement new into an allocation.
+	struct MemoryTag final {};
+
 	class Memory final {
 		STATIC_CLASS(Memory);
 	public:
@@ -53,22 +63,50 @@ namespace Engine {
 #pragma endregion
 
 		// Allocate a memory of the specific size.
+#if defined(ENGINE_MEMORY_TRACKING)
+		// location names the call site, see MemoryTracker.
+		static void* Allocate(sizeint size, const std::source_location& location = std::source_location::current());
+#else
 		static void* Allocate(sizeint size);
+#endif
 		// Resize a memory block.
 		static void* Reallocate(void* ptr, sizeint newSize);
 		// Free a memory block.
 		static void Deallocate(void* ptr);
+		// Blocks from Allocate() are aligned to this.
+		static inline constexpr sizeint Alignment = 16;
+		// Allocate a memory block aligned to more than Alignment, a power of 2. Free it with DeallocateAligned().
+#if defined(ENGINE_MEMORY_TRACKING)
+		static void* AllocateAligned(sizeint size, sizeint alignment, const std::source_location& location = std::source_location::current());
+#else
+		static void* AllocateAligned(sizeint size, sizeint alignment);
+#endif
+		// Free a memory block from AllocateAligned().
+		static void DeallocateAligned(void* ptr);
 
 		template<typename T>
 		static constexpr bool IsDestructionNeeded() {
 			return !__has_trivial_destructor(T);
 		}
 
+		// Check if objects can be moved to another address by copying their bytes, the source then counts as destructed.
+		// Trivially copyable types always can, classes opt in with TRIVIALLY_RELOCATABLE.
+		template<typename T>
+		static constexpr bool IsTriviallyRelocatable() {
+			return std::is_trivially_copyable_v<T> || requires { typename T::TriviallyRelocatableTag; };
+		}
+
+		// Check if the class frees its instances with an operator delete of its own, see ObjectPool.
+		template<typename T>
+		static constexpr bool HasClassDeallocation() {
+			return requires(void* ptr, sizeint size) { T::operator delete(ptr, size); };
+		}
+
 		// Constructs a object on an existing memory.
 		template<typename T,typename ... Args>
 		static void Construct(T* ptr, Args&& ... args) {
-			// Placement new
-			new (ptr) T(Forward<Args>(args)...);
+			// Placement new, the global one as classes may declare their own operator new.
+			::new (ptr) T(Forward<Args>(args)...);
 		}
 		// Deconstructs a object but doesn't deallocate the memory.
 		template<typename T>
@@ -88,14 +126,24 @@ namespace Engine {
 			if (ptr == nullptr) {
 				return;
 			}
-			// Call destructor if necessary.
-			Destruct(ptr);
-			// Free memory.
-			Deallocate(ptr);
+			if constexpr (HasClassDeallocation<T>()) {
+				// The virtual destructor frees the memory with operator delete of the most derived class.
+				delete ptr;
+			} else if constexpr (alignof(T) > Alignment) {
+				// MEMNEW took it from AllocateAligned(), see operator new(size_t, std::align_val_t, MemoryTag).
+				Destruct(ptr);
+				DeallocateAligned(ptr);
+			} else {
+				// Call destructor if necessary.
+				Destruct(ptr);
+				// Free memory.
+				Deallocate(ptr);
+			}
 		}
 
 		template<typename T,typename ... Args>
 		static T* NewArray(sizeint count, Args&& ... args) {
+			static_assert(alignof(T) <= Alignment, "The count in front of the elements only keeps them aligned to Alignment.");
 			ERR_ASSERT(count > 0, u8"count must be larger than 0.", return nullptr);
 
 			// Reserve a few bytes of size_t for saving the count data.
@@ -136,15 +184,44 @@ namespace Engine {
 		}
 
 		static sizeint GetHeapArrayElementCount(void* ptr);
+
+		// Attribute the next allocation of this thread to location instead of the caller of Allocate(). Used by MEMNEW.
+		static MemoryTag MarkAllocationSite(const std::source_location& location);
+	};
+
+	/// @brief The default allocation policy of containers, going through Memory::Allocate().\n
+	/// A policy is a class with static Allocate(size), Reallocate(ptr, oldSize, newSize) and Deallocate(ptr).
+	/// MemoryTracker counts container storage toward the innermost MemoryScope of the thread.
+	class HeapAllocator final {
+	public:
+		STATIC_CLASS(HeapAllocator);
+
+		static void* Allocate(sizeint size) {
+			return Memory::Allocate(size);
+		}
+		static void* Reallocate(void* ptr, sizeint oldSize, sizeint newSize) {
+			return Memory::Reallocate(ptr, newSize);
+		}
+		static void Deallocate(void* ptr) {
+			Memory::Deallocate(ptr);
+		}
 	};
 }
 
-#define MEMNEW(type) new (true) type
-#define MEMDEL(ptr) ::Engine::Memory::Delete(ptr)
+#if defined(ENGINE_MEMORY_TRACKING)
+#define MEMNEW(type) new (::Engine::Memory::MarkAllocationSite(std::source_location::current())) type
+#define MEMNEWARR(type,count) (::Engine::Memory::MarkAllocationSite(std::source_location::current()), ::Engine::Memory::NewArray<type>(count))
+#else
+#define MEMNEW(type) new (::Engine::MemoryTag{}) type
 #define MEMNEWARR(type,count) ::Engine::Memory::NewArray<type>(count)
+#endif
+#define MEMDEL(ptr) ::Engine::Memory::Delete(ptr)
 #define MEMDELARR(ptr) ::Engine::Memory::DeleteArray(ptr)
 
-void* operator new(size_t size, bool reserved);
+void* operator new(size_t size, Engine::MemoryTag tag);
 // Paired operator delete for freeing memory when exception is thrown in ctor.
-void operator delete(void* ptr, bool reserved);
+void operator delete(void* ptr, Engine::MemoryTag tag);
+// MEMNEW of types aligned to more than Memory::Alignment ends up here.
+void* operator new(size_t size, std::align_val_t alignment, Engine::MemoryTag tag);
+void operator delete(void* ptr, std::align_val_t alignment, Engine::MemoryTag tag);
 
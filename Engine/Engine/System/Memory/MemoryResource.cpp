@@ -0,0 +1,147 @@
+#include "Engine/System/Memory/MemoryResource.h"
+#include "Engine/System/Debug.h"
+#include <cstring>
+
+namespace Engine {
+#pragma region MemoryResource
+	namespace {
+		class HeapResource final :public MemoryResource {
+		public:
+			void* Allocate(sizeint size) override {
+				return Memory::Allocate(size);
+			}
+			void* Reallocate(void* ptr, sizeint oldSize, sizeint newSize) override {
+				return Memory::Reallocate(ptr, newSize);
+			}
+			void Deallocate(void* ptr) override {
+				Memory::Deallocate(ptr);
+			}
+		};
+
+		thread_local MemoryResource* currentResource = nullptr;
+	}
+
+	void* MemoryResource::Reallocate(void* ptr, sizeint oldSize, sizeint newSize) {
+		void* result = Allocate(newSize);
+		if (result == nullptr) {
+			return nullptr;
+		}
+		std::memcpy(result, ptr, oldSize < newSize ? oldSize : newSize);
+		Deallocate(ptr);
+		return result;
+	}
+
+	MemoryResource* MemoryResource::GetHeap() {
+		// Leaked on purpose, containers may still free their blocks from other static destructors at exit.
+		static MemoryResource* heap = MEMNEW(HeapResource());
+		return heap;
+	}
+	MemoryResource* MemoryResource::GetCurrent() {
+		return currentResource != nullptr ? currentResource : GetHeap();
+	}
+
+	MemoryResource::Scope::Scope(MemoryResource* resource) :previous(currentResource) {
+		currentResource = resource;
+	}
+	MemoryResource::Scope::~Scope() {
+		currentResource = previous;
+	}
+#pragma endregion
+
+#pragma region BufferResource
+	BufferResource::BufferResource(byte* buffer, sizeint size, MemoryResource* upstream)
+		:buffer(buffer), size(size), upstream(upstream) {
+		ERR_ASSERT(((uintptr_t)buffer % Alignment) == 0, u8"buffer must be aligned to BufferResource::Alignment.", this->size = 0);
+	}
+
+	void* BufferResource::Allocate(sizeint size) {
+		sizeint padded = (size + Alignment - 1) / Alignment * Alignment;
+		if (padded > this->size - offset) {
+			return upstream->Allocate(size);
+		}
+		lastOffset = offset;
+		offset += padded;
+		return buffer + lastOffset;
+	}
+	void* BufferResource::Reallocate(void* ptr, sizeint oldSize, sizeint newSize) {
+		if (!IsOwned(ptr)) {
+			return upstream->Reallocate(ptr, oldSize, newSize);
+		}
+
+		// The newest block grows or shrinks in place while the buffer has room.
+		sizeint padded = (newSize + Alignment - 1) / Alignment * Alignment;
+		if ((byte*)ptr == buffer + lastOffset && padded <= size - lastOffset) {
+			offset = lastOffset + padded;
+			return ptr;
+		}
+
+		void* result = Allocate(newSize);
+		if (result == nullptr) {
+			return nullptr;
+		}
+		std::memcpy(result, ptr, oldSize < newSize ? oldSize : newSize);
+		Deallocate(ptr);
+		return result;
+	}
+	void BufferResource::Deallocate(void* ptr) {
+		if (ptr == nullptr) {
+			return;
+		}
+		if (!IsOwned(ptr)) {
+			upstream->Deallocate(ptr);
+			return;
+		}
+		if ((byte*)ptr == buffer + lastOffset) {
+			offset = lastOffset;
+		}
+	}
+
+	void BufferResource::Reset() {
+		offset = 0;
+		lastOffset = 0;
+	}
+	sizeint BufferResource::GetUsedSize() const {
+		return offset;
+	}
+	bool BufferResource::IsOwned(const void* ptr) const {
+		return ptr >= buffer && ptr < buffer + size;
+	}
+#pragma endregion
+
+#pragma region ResourceAllocator
+	namespace {
+		struct alignas(ResourceAllocator::HeaderSize) ResourceHeader {
+			MemoryResource* resource;
+		};
+		static_assert(sizeof(ResourceHeader) == ResourceAllocator::HeaderSize, "The header must keep blocks aligned.");
+	}
+
+	void* ResourceAllocator::Allocate(sizeint size) {
+		MemoryResource* resource = MemoryResource::GetCurrent();
+		ResourceHeader* header = (ResourceHeader*)resource->Allocate(HeaderSize + size);
+		if (header == nullptr) {
+			return nullptr;
+		}
+		header->resource = resource;
+		return header + 1;
+	}
+	void* ResourceAllocator::Reallocate(void* ptr, sizeint oldSize, sizeint newSize) {
+		ResourceHeader* header = (ResourceHeader*)ptr - 1;
+		header = (ResourceHeader*)header->resource->Reallocate(header, HeaderSize + oldSize, HeaderSize + newSize);
+		if (header == nullptr) {
+			return nullptr;
+		}
+		return header + 1;
+	}
+	void ResourceAllocator::Deallocate(void* ptr) {
+		if (ptr == nullptr) {
+			return;
+		}
+		ResourceHeader* header = (ResourceHeader*)ptr - 1;
+		header->resource->Deallocate(header);
+	}
+	MemoryResource* ResourceAllocator::GetResource(const void* ptr) {
+		return ((const ResourceHeader*)ptr - 1)->resource;
+	}
+#pragma endregion
+}
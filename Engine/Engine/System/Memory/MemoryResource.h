@@ -0,0 +1,93 @@
+#pragma once
+
+#include "Engine/System/Definition.h"
+#include "Engine/System/Memory/Memory.h"
+
+namespace Engine {
+	/// @brief A source of memory chosen at runtime, for containers using ResourceAllocator.\n
+	/// Subclasses decide where the blocks come from, an arena, a pool or a buffer on the stack.
+	class MemoryResource {
+	public:
+		virtual ~MemoryResource() = default;
+
+		virtual void* Allocate(sizeint size) = 0;
+		/// @brief Resize a block. Allocates, copies and deallocates unless overridden.
+		virtual void* Reallocate(void* ptr, sizeint oldSize, sizeint newSize);
+		virtual void Deallocate(void* ptr) = 0;
+
+		/// @brief Get the resource going through Memory::Allocate().
+		static MemoryResource* GetHeap();
+		/// @brief Get the resource new ResourceAllocator blocks of this thread come from, the heap by default.
+		static MemoryResource* GetCurrent();
+
+		/// @brief Makes a resource current on this thread until the scope ends.
+		class Scope final {
+		public:
+			Scope(MemoryResource* resource);
+			~Scope();
+
+			Scope(const Scope&) = delete;
+			Scope& operator=(const Scope&) = delete;
+
+		private:
+			MemoryResource* previous;
+		};
+	};
+
+	/// @brief Hands out a caller-provided buffer by bumping an offset, and takes from upstream once it is full.\n
+	/// Freeing the newest block rolls the offset back, others stay used until Reset(). Not thread safe.
+	class BufferResource :public MemoryResource {
+	public:
+		static inline constexpr sizeint Alignment = 16;
+
+		/// @param buffer Memory to hand out, aligned to Alignment.
+		BufferResource(byte* buffer, sizeint size, MemoryResource* upstream = MemoryResource::GetHeap());
+
+		void* Allocate(sizeint size) override;
+		void* Reallocate(void* ptr, sizeint oldSize, sizeint newSize) override;
+		void Deallocate(void* ptr) override;
+
+		/// @brief Forget every block in the buffer. Blocks from upstream are not affected.
+		void Reset();
+		/// @brief Get the bytes of the buffer in use.
+		sizeint GetUsedSize() const;
+		/// @brief Check if the block lies in the buffer.
+		bool IsOwned(const void* ptr) const;
+
+	private:
+		byte* buffer;
+		sizeint size;
+		sizeint offset = 0;
+		/// @brief Offset of the newest block, which can be freed or grown in place.
+		sizeint lastOffset = 0;
+		MemoryResource* upstream;
+	};
+
+	/// @brief A BufferResource carrying its own buffer, meant to live on the stack.
+	template<sizeint Size>
+	class InlineBufferResource final :public BufferResource {
+	public:
+		InlineBufferResource(MemoryResource* upstream = MemoryResource::GetHeap()) :BufferResource(storage, Size, upstream) {}
+
+	private:
+		alignas(BufferResource::Alignment) byte storage[Size];
+	};
+
+	/// @brief Allocation policy for containers whose memory comes from a MemoryResource, see List.\n
+	/// New blocks come from MemoryResource::GetCurrent(). Every block remembers its resource,
+	/// so growing and freeing go back to it even after the scope has ended.
+	class ResourceAllocator final {
+	public:
+		STATIC_CLASS(ResourceAllocator);
+
+		/// @brief Size of the header in front of every block.
+		static inline constexpr sizeint HeaderSize = 16;
+
+		static void* Allocate(sizeint size);
+		static void* Reallocate(void* ptr, sizeint oldSize, sizeint newSize);
+		static void Deallocate(void* ptr);
+
+		/// @brief Get the resource a block came from.
+		static MemoryResource* GetResource(const void* ptr);
+	};
+}
@@ -0,0 +1,318 @@
+#include "Engine/System/Memory/MemoryTracker.h"
+#include "Engine/System/File/FileSystem.h"
+#include "Engine/System/File/FileStream.h"
+#include "Engine/System/Thread/ThreadUtil.h"
+#include "Engine/System/Collection/Algorithm.h"
+#include <atomic>
+#include <cstring>
+
+namespace Engine {
+#if defined(ENGINE_MEMORY_TRACKING)
+	namespace {
+		struct SiteData {
+			const char* file;
+			const char* function;
+			uint32 line;
+			std::atomic<int64> allocationCount;
+			std::atomic<int64> liveCount;
+			std::atomic<int64> liveBytes;
+			std::atomic<int64> totalBytes;
+			std::atomic<int64> frameAllocationCount;
+			std::atomic<int64> lastFrameAllocationCount;
+		};
+
+		struct alignas(MemoryTracker::HeaderSize) BlockHeader {
+			uint32 site;
+			sizeint size;
+		};
+		static_assert(sizeof(BlockHeader) == MemoryTracker::HeaderSize, "The block header must keep blocks aligned.");
+
+		// Constant initialized, allocations from static constructors of other files find them ready.
+		SiteData sites[MemoryTracker::MaxSiteCount];
+		std::atomic<int32> siteCount{ 0 };
+		/// @brief Open addressing index of sites, keyed by the location pointers. 0 is empty, otherwise site index + 1.
+		constexpr int32 SlotCount = MemoryTracker::MaxSiteCount * 2;
+		std::atomic<int32> slots[SlotCount];
+		Mutex siteMutex;
+
+		std::atomic<int64> liveCount{ 0 };
+		std::atomic<int64> liveBytes{ 0 };
+		std::atomic<int64> peakLiveBytes{ 0 };
+		std::atomic<int64> allocationCount{ 0 };
+		std::atomic<int64> totalBytes{ 0 };
+		std::atomic<int64> frameAllocationCount{ 0 };
+		std::atomic<int64> frameBytes{ 0 };
+		std::atomic<int64> lastFrameAllocationCount{ 0 };
+		std::atomic<int64> lastFrameBytes{ 0 };
+
+		thread_local std::source_location markedSite{};
+		thread_local bool hasMarkedSite = false;
+		thread_local MemoryScope* currentScope = nullptr;
+
+		bool IsSameSite(const SiteData& site, const std::source_location& location) {
+			return site.line == location.line() && site.file == location.file_name() && site.function == location.function_name();
+		}
+
+		/// @brief Find the site of a location, adding it on first sight.\n
+		/// Keyed by the string pointers, a header used by several files may count as several sites. GetSites() merges them.
+		uint32 FindSite(const std::source_location& location) {
+			uint64 hash = (static_cast<uint64>((uintptr_t)location.file_name()) ^ (static_cast<uint64>((uintptr_t)location.function_name()) << 7) ^ location.line()) * 0x9E3779B97F4A7C15ull;
+			for (int32 probe = 0; probe < SlotCount; probe += 1) {
+				int32 slot = static_cast<int32>((hash >> 32) + probe) & (SlotCount - 1);
+				int32 value = slots[slot].load(std::memory_order_acquire);
+				if (value == 0) {
+					auto lock = SimpleLock<Mutex>(siteMutex);
+					value = slots[slot].load(std::memory_order_relaxed);
+					if (value == 0) {
+						int32 index = siteCount.load(std::memory_order_relaxed);
+						if (index >= MemoryTracker::MaxSiteCount - 1) {
+							// Out of room, everything else shares the last site.
+							index = MemoryTracker::MaxSiteCount - 1;
+							SiteData& other = sites[index];
+							other.file = "(other sites)";
+							other.function = "";
+							other.line = 0;
+							siteCount.store(MemoryTracker::MaxSiteCount, std::memory_order_release);
+							return static_cast<uint32>(index);
+						}
+						SiteData& site = sites[index];
+						site.file = location.file_name();
+						site.function = location.function_name();
+						site.line = location.line();
+						siteCount.store(index + 1, std::memory_order_release);
+						slots[slot].store(index + 1, std::memory_order_release);
+						return static_cast<uint32>(index);
+					}
+				}
+				if (IsSameSite(sites[value - 1], location)) {
+					return static_cast<uint32>(value - 1);
+				}
+			}
+			return MemoryTracker::MaxSiteCount - 1;
+		}
+
+		void CountAllocation(SiteData& site, sizeint size) {
+			int64 bytes = static_cast<int64>(size);
+			site.allocationCount.fetch_add(1, std::memory_order_relaxed);
+			site.liveCount.fetch_add(1, std::memory_order_relaxed);
+			site.totalBytes.fetch_add(bytes, std::memory_order_relaxed);
+			site.frameAllocationCount.fetch_add(1, std::memory_order_relaxed);
+
+			liveCount.fetch_add(1, std::memory_order_relaxed);
+			allocationCount.fetch_add(1, std::memory_order_relaxed);
+			totalBytes.fetch_add(bytes, std::memory_order_relaxed);
+			frameAllocationCount.fetch_add(1, std::memory_order_relaxed);
+			frameBytes.fetch_add(bytes, std::memory_order_relaxed);
+		}
+		void CountLiveBytes(SiteData& site, int64 delta) {
+			site.liveBytes.fetch_add(delta, std::memory_order_relaxed);
+			int64 live = liveBytes.fetch_add(delta, std::memory_order_relaxed) + delta;
+			int64 peak = peakLiveBytes.load(std::memory_order_relaxed);
+			while (live > peak && !peakLiveBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+		}
+	}
+
+	void MemoryTracker::MarkSite(const std::source_location& location) {
+		markedSite = location;
+		hasMarkedSite = true;
+	}
+	std::source_location MemoryTracker::TakeSite(const std::source_location& location) {
+		if (hasMarkedSite) {
+			hasMarkedSite = false;
+			return markedSite;
+		}
+		return currentScope != nullptr ? currentScope->location : location;
+	}
+	void* MemoryTracker::Track(void* block, sizeint size, const std::source_location& location) {
+		BlockHeader* header = (BlockHeader*)block;
+		header->site = FindSite(TakeSite(location));
+		header->size = size;
+
+		SiteData& site = sites[header->site];
+		CountAllocation(site, size);
+		CountLiveBytes(site, static_cast<int64>(size));
+		return header + 1;
+	}
+	void* MemoryTracker::Resize(void* ptr, sizeint newSize) {
+		BlockHeader* header = (BlockHeader*)ptr - 1;
+		SiteData& site = sites[header->site];
+		int64 delta = static_cast<int64>(newSize) - static_cast<int64>(header->size);
+		if (delta > 0) {
+			site.totalBytes.fetch_add(delta, std::memory_order_relaxed);
+			totalBytes.fetch_add(delta, std::memory_order_relaxed);
+			frameBytes.fetch_add(delta, std::memory_order_relaxed);
+		}
+		CountLiveBytes(site, delta);
+		header->size = newSize;
+		return header;
+	}
+	void* MemoryTracker::Untrack(void* ptr) {
+		BlockHeader* header = (BlockHeader*)ptr - 1;
+		SiteData& site = sites[header->site];
+		site.liveCount.fetch_sub(1, std::memory_order_relaxed);
+		liveCount.fetch_sub(1, std::memory_order_relaxed);
+		CountLiveBytes(site, -static_cast<int64>(header->size));
+		return header;
+	}
+
+	void* MemoryTracker::TrackSlot(void* slot, sizeint size, const std::source_location& site) {
+		BlockHeader* header = (BlockHeader*)slot;
+		header->site = FindSite(site);
+		header->size = size;
+
+		SiteData& data = sites[header->site];
+		data.allocationCount.fetch_add(1, std::memory_order_relaxed);
+		data.liveCount.fetch_add(1, std::memory_order_relaxed);
+		data.liveBytes.fetch_add(static_cast<int64>(size), std::memory_order_relaxed);
+		data.totalBytes.fetch_add(static_cast<int64>(size), std::memory_order_relaxed);
+		data.frameAllocationCount.fetch_add(1, std::memory_order_relaxed);
+		return header + 1;
+	}
+	void* MemoryTracker::UntrackSlot(void* ptr) {
+		BlockHeader* header = (BlockHeader*)ptr - 1;
+		SiteData& data = sites[header->site];
+		data.liveCount.fetch_sub(1, std::memory_order_relaxed);
+		data.liveBytes.fetch_sub(static_cast<int64>(header->size), std::memory_order_relaxed);
+		return header;
+	}
+
+	MemoryScope::MemoryScope(const std::source_location& location) :location(location), outer(currentScope) {
+		currentScope = this;
+	}
+	MemoryScope::~MemoryScope() {
+		currentScope = outer;
+	}
+
+	MemoryTracker::Statistics MemoryTracker::GetStatistics() {
+		Statistics result{};
+		result.liveCount = liveCount.load(std::memory_order_relaxed);
+		result.liveBytes = liveBytes.load(std::memory_order_relaxed);
+		result.peakLiveBytes = peakLiveBytes.load(std::memory_order_relaxed);
+		result.allocationCount = allocationCount.load(std::memory_order_relaxed);
+		result.totalBytes = totalBytes.load(std::memory_order_relaxed);
+		result.lastFrameAllocationCount = lastFrameAllocationCount.load(std::memory_order_relaxed);
+		result.lastFrameBytes = lastFrameBytes.load(std::memory_order_relaxed);
+		return result;
+	}
+	List<MemoryTracker::Site> MemoryTracker::GetSites() {
+		// Read the count first, the list allocates and may add sites on the way.
+		int32 count = siteCount.load(std::memory_order_acquire);
+		List<Site> result(count);
+		for (int32 i = 0; i < count; i += 1) {
+			const SiteData& data = sites[i];
+			Site site{};
+			site.file = data.file;
+			site.function = data.function;
+			site.line = data.line;
+			site.allocationCount = data.allocationCount.load(std::memory_order_relaxed);
+			site.liveCount = data.liveCount.load(std::memory_order_relaxed);
+			site.liveBytes = data.liveBytes.load(std::memory_order_relaxed);
+			site.totalBytes = data.totalBytes.load(std::memory_order_relaxed);
+			site.lastFrameAllocationCount = data.lastFrameAllocationCount.load(std::memory_order_relaxed);
+
+			// Merge the copies of a site seen from several files.
+			bool merged = false;
+			for (int32 j = 0; j < result.GetCount() && !merged; j += 1) {
+				Site& other = result.GetRawElementPtr()[j];
+				if (other.line == site.line && std::strcmp(other.file, site.file) == 0 && std::strcmp(other.function, site.function) == 0) {
+					other.allocationCount += site.allocationCount;
+					other.liveCount += site.liveCount;
+					other.liveBytes += site.liveBytes;
+					other.totalBytes += site.totalBytes;
+					other.lastFrameAllocationCount += site.lastFrameAllocationCount;
+					merged = true;
+				}
+			}
+			if (!merged) {
+				result.Add(site);
+			}
+		}
+
+		Algorithm::Sort(result.GetRawElementPtr(), result.GetCount(), [](const Site& a, const Site& b) {
+			return a.liveBytes > b.liveBytes;
+		});
+		return result;
+	}
+	void MemoryTracker::AdvanceFrame() {
+		lastFrameAllocationCount.store(frameAllocationCount.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+		lastFrameBytes.store(frameBytes.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+
+		int32 count = siteCount.load(std::memory_order_acquire);
+		for (int32 i = 0; i < count; i += 1) {
+			SiteData& site = sites[i];
+			site.lastFrameAllocationCount.store(site.frameAllocationCount.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+		}
+	}
+#else
+	MemoryTracker::Statistics MemoryTracker::GetStatistics() {
+		return Statistics();
+	}
+	List<MemoryTracker::Site> MemoryTracker::GetSites() {
+		return List<Site>();
+	}
+	void MemoryTracker::AdvanceFrame() {}
+
+	void MemoryTracker::MarkSite(const std::source_location& location) {}
+	std::source_location MemoryTracker::TakeSite(const std::source_location& location) {
+		return location;
+	}
+	void* MemoryTracker::Track(void* block, sizeint size, const std::source_location& location) {
+		return block;
+	}
+	void* MemoryTracker::Resize(void* ptr, sizeint newSize) {
+		return ptr;
+	}
+	void* MemoryTracker::Untrack(void* ptr) {
+		return ptr;
+	}
+	void* MemoryTracker::TrackSlot(void* slot, sizeint size, const std::source_location& site) {
+		return slot;
+	}
+	void* MemoryTracker::UntrackSlot(void* ptr) {
+		return ptr;
+	}
+
+	MemoryScope::MemoryScope(const std::source_location& location) :location(location) {}
+	MemoryScope::~MemoryScope() {}
+#endif
+
+	const std::source_location& MemoryScope::GetLocation() const {
+		return location;
+	}
+
+	String MemoryTracker::GetReport(int32 maxSiteCount) {
+		Statistics statistics = GetStatistics();
+		String result = String::Format(
+			STRL("Memory: {0} bytes live in {1} blocks, peak {2} bytes, {3} allocations of {4} bytes in total, {5} allocations of {6} bytes last frame.\n"),
+			statistics.liveBytes, statistics.liveCount, statistics.peakLiveBytes,
+			statistics.allocationCount, statistics.totalBytes,
+			statistics.lastFrameAllocationCount, statistics.lastFrameBytes
+		);
+		if (!IsEnabled()) {
+			return result + STRL("Tracking is off, build with ENGINE_MEMORY_TRACKING to count allocations.\n");
+		}
+
+		result = result + String::Format(STRL("{0:>14} {1:>10} {2:>12} {3:>10}  Site\n"), "Live bytes", "Live", "Allocations", "Last frame");
+		List<Site> sites = GetSites();
+		int32 count = maxSiteCount < 0 || maxSiteCount > sites.GetCount() ? sites.GetCount() : maxSiteCount;
+		for (int32 i = 0; i < count; i += 1) {
+			const Site& site = sites.GetRawElementPtr()[i];
+			result = result + String::Format(
+				STRL("{0:>14} {1:>10} {2:>12} {3:>10}  {4}:{5} {6}\n"),
+				site.liveBytes, site.liveCount, site.allocationCount, site.lastFrameAllocationCount,
+				site.file, site.line, site.function
+			);
+		}
+		return result;
+	}
+	ResultCode MemoryTracker::DumpToFile(FileSystem& fileSystem, const String& path) {
+		IntrusivePtr<FileStream> file;
+		ResultCode code = fileSystem.TryOpenFile(path, FileSystem::OpenMode::WriteTruncate, file);
+		if (code != ResultCode::OK) {
+			return code;
+		}
+		code = file->WriteText(GetReport(-1));
+		file->Close();
+		return code;
+	}
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "Engine/System/Definition.h"
+#include "Engine/System/String.h"
+#include "Engine/System/Collection/List.h"
+#include <source_location>
+
+namespace Engine {
+	class FileSystem;
+
+	/// @brief Counts the blocks of Memory::Allocate() by call site. Build with ENGINE_MEMORY_TRACKING to turn it on.\n
+	/// Every block then carries a small header naming its site. MEMNEW and MEMNEWARR record the line using them,
+	/// other allocations the innermost MemoryScope of the thread, or the caller of Memory::Allocate() without one.
+	/// Slots of object pools count toward their sites as well, but not toward the totals, which hold the slabs instead.
+	/// Without ENGINE_MEMORY_TRACKING nothing is counted and every query returns zeros.
+	class MemoryTracker final {
+	public:
+		STATIC_CLASS(MemoryTracker);
+
+		/// @brief Bytes in front of every tracked block.
+		static inline constexpr sizeint HeaderSize = 16;
+		/// @brief Distinct call sites counted, later ones share the last entry.
+		static inline constexpr int32 MaxSiteCount = 4096;
+
+		struct Site {
+			const char* file = nullptr;
+			const char* function = nullptr;
+			uint32 line = 0;
+			int64 allocationCount = 0;
+			int64 liveCount = 0;
+			int64 liveBytes = 0;
+			int64 totalBytes = 0;
+			/// @brief Allocations during the last frame ended by AdvanceFrame().
+			int64 lastFrameAllocationCount = 0;
+		};
+		struct Statistics {
+			int64 liveCount = 0;
+			int64 liveBytes = 0;
+			int64 peakLiveBytes = 0;
+			int64 allocationCount = 0;
+			int64 totalBytes = 0;
+			int64 lastFrameAllocationCount = 0;
+			int64 lastFrameBytes = 0;
+		};
+
+		static constexpr bool IsEnabled() {
+#if defined(ENGINE_MEMORY_TRACKING)
+			return true;
+#else
+			return false;
+#endif
+		}
+
+		static Statistics GetStatistics();
+		/// @brief Get every call site seen so far, the ones holding the most live bytes first.
+		static List<Site> GetSites();
+		/// @brief End the current frame for the per-frame counts. Called by the engine loop.
+		static void AdvanceFrame();
+
+		/// @brief Get a text report of the totals and the sites holding the most live bytes.
+		static String GetReport(int32 maxSiteCount = 32);
+		/// @brief Write GetReport() with every site to a file.
+		static ResultCode DumpToFile(FileSystem& fileSystem, const String& path);
+
+	private:
+		friend class Memory;
+		friend class ObjectPool;
+		friend class MemoryScope;
+
+		/// @brief Count the next block of this thread toward location, whatever scope it is in.
+		static void MarkSite(const std::source_location& location);
+		/// @brief Get the site the next block of this thread counts toward, and drop the mark of MarkSite().
+		/// @param location Counted toward when the block is neither marked nor in a MemoryScope.
+		static std::source_location TakeSite(const std::source_location& location);
+		/// @brief Record a new block and write its header.
+		/// @param location Passed to TakeSite().
+		/// @return The user pointer after the header.
+		static void* Track(void* block, sizeint size, const std::source_location& location);
+		/// @brief Record a block changing size.
+		/// @return The start of the block, header included.
+		static void* Resize(void* ptr, sizeint newSize);
+		/// @brief Record a block being freed.
+		/// @return The start of the block, header included.
+		static void* Untrack(void* ptr);
+		/// @brief Record a slot of an object pool and write its header.\n
+		/// Only counted toward its site, the totals already hold the slab it is carved from.
+		/// @param site From TakeSite(), before the pool could allocate a slab.
+		static void* TrackSlot(void* slot, sizeint size, const std::source_location& site);
+		/// @brief Record a slot of an object pool being freed.
+		/// @return The start of the slot, header included.
+		static void* UntrackSlot(void* ptr);
+	};
+
+	/// @brief Counts the allocations of the current thread toward the line declaring the scope, while it lives.\n
+	/// Container storage is allocated inside the container, a scope is how a system gets it counted as its own.
+	/// Scopes nest and the innermost one wins, MEMNEW and MEMNEWARR keep their own line.
+	/// Does nothing without ENGINE_MEMORY_TRACKING.
+	class MemoryScope final {
+	public:
+		MemoryScope(const std::source_location& location = std::source_location::current());
+		~MemoryScope();
+
+		MemoryScope(const MemoryScope&) = delete;
+		MemoryScope& operator=(const MemoryScope&) = delete;
+
+		/// @brief Get the line the allocations are counted toward.
+		const std::source_location& GetLocation() const;
+
+	private:
+		friend class MemoryTracker;
+
+		std::source_location location;
+		MemoryScope* outer = nullptr;
+	};
+}
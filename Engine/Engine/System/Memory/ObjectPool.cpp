@@ -0,0 +1,210 @@
+#include "Engine/System/Memory/ObjectPool.h"
+#include "Engine/System/Memory/MemoryTracker.h"
+
+namespace Engine {
+	ObjectPool* ObjectPool::firstPool = nullptr;
+	int32 ObjectPool::poolCount = 0;
+	Mutex ObjectPool::registryMutex{};
+
+	struct ObjectPoolLocalCache;
+	namespace {
+		/// @brief Every thread free list, for counting the slots in use.
+		ObjectPoolLocalCache* firstCache = nullptr;
+
+#if defined(ENGINE_MEMORY_TRACKING)
+		/// @brief Slots carry the header of MemoryTracker in front of the object, like heap blocks.
+		constexpr sizeint SlotHeaderSize = MemoryTracker::HeaderSize;
+#else
+		constexpr sizeint SlotHeaderSize = 0;
+#endif
+	}
+
+	/// @brief Free slots of the current thread. Trivially destructible, it stays usable while other thread locals are torn down.
+	struct ObjectPoolLocalCache {
+		ObjectPool::LocalSlots lists[ObjectPool::MaxCachedPoolCount];
+		ObjectPoolLocalCache* nextCache;
+		bool registered;
+		/// @brief Set once the thread is exiting, slots go to the shared lists directly from then on.
+		bool retired;
+
+		void Register() {
+			auto lock = SimpleLock<Mutex>(ObjectPool::registryMutex);
+			nextCache = firstCache;
+			firstCache = this;
+			registered = true;
+		}
+		void Flush() {
+			auto lock = SimpleLock<Mutex>(ObjectPool::registryMutex);
+			for (ObjectPool* pool = ObjectPool::firstPool; pool != nullptr; pool = pool->nextPool) {
+				if (pool->cacheIndex >= 0) {
+					lists[pool->cacheIndex].Flush(pool->freeSlots);
+				}
+			}
+			if (registered) {
+				ObjectPoolLocalCache** link = &firstCache;
+				while (*link != this) {
+					link = &(*link)->nextCache;
+				}
+				*link = nextCache;
+			}
+			retired = true;
+		}
+	};
+
+	namespace {
+		thread_local ObjectPoolLocalCache localCache{};
+
+		/// @brief Gives the cached slots back when the thread exits.
+		struct LocalCacheFlusher {
+			~LocalCacheFlusher() {
+				localCache.Flush();
+			}
+		};
+		thread_local LocalCacheFlusher localCacheFlusher;
+	}
+
+	ObjectPool::ObjectPool(const String& name, sizeint slotSize)
+		:name(name) {
+		// Free slots hold the link of the free list.
+		if (slotSize < sizeof(FreeBlock)) {
+			slotSize = sizeof(FreeBlock);
+		}
+		constexpr sizeint alignment = alignof(std::max_align_t);
+		this->slotSize = (slotSize + alignment - 1) / alignment * alignment;
+
+		sizeint count = (SlabSize - HeaderSize) / (this->slotSize + SlotHeaderSize);
+		slabSlotCount = count < MinSlabSlotCount ? MinSlabSlotCount : static_cast<int32>(count);
+
+		auto lock = SimpleLock<Mutex>(registryMutex);
+		cacheIndex = poolCount < MaxCachedPoolCount ? poolCount : -1;
+		poolCount += 1;
+		nextPool = firstPool;
+		firstPool = this;
+	}
+
+	int32 ObjectPool::CarveSlab(FreeBlock*& head, FreeBlock*& tail) {
+		sizeint capacity = (slotSize + SlotHeaderSize) * slabSlotCount;
+		Slab* slab = (Slab*)Memory::Allocate(HeaderSize + capacity);
+		FATAL_ASSERT(slab != nullptr, u8"Failed to allocate a slab.");
+		slab->capacity = capacity;
+		{
+			auto lock = SimpleLock<Mutex>(slabMutex);
+			slab->next = slabs;
+			slabs = slab;
+			slabCount += 1;
+		}
+		// Linked in address order, so objects created together sit next to each other.
+		return SharedFreeList<>::LinkBlocks(slab->GetData(), slotSize + SlotHeaderSize, slabSlotCount, head, tail);
+	}
+
+	void* ObjectPool::Allocate(sizeint size) {
+		if (size > slotSize) {
+			return Memory::Allocate(size);
+		}
+#if defined(ENGINE_MEMORY_TRACKING)
+		// Before taking the slot, a new slab would take the mark of MEMNEW otherwise.
+		std::source_location site = MemoryTracker::TakeSite(std::source_location::current());
+		return MemoryTracker::TrackSlot(TakeSlot(), size, site);
+#else
+		return TakeSlot();
+#endif
+	}
+	void* ObjectPool::TakeSlot() {
+		auto carve = [this](FreeBlock*& head, FreeBlock*& tail) {
+			return CarveSlab(head, tail);
+		};
+		ObjectPoolLocalCache& cache = localCache;
+		if (cacheIndex < 0 || cache.retired) {
+			FreeBlock* slot = nullptr;
+			freeSlots.Take(1, slot, carve);
+			return slot;
+		}
+
+		if (!cache.registered) {
+			// Touch the flusher so it is constructed, and its destructor registered, on this thread.
+			(void)&localCacheFlusher;
+			cache.Register();
+		}
+		return cache.lists[cacheIndex].Pop(freeSlots, carve);
+	}
+	void ObjectPool::Deallocate(void* ptr, sizeint size) {
+		if (ptr == nullptr) {
+			return;
+		}
+		if (size > slotSize) {
+			Memory::Deallocate(ptr);
+			return;
+		}
+
+#if defined(ENGINE_MEMORY_TRACKING)
+		FreeBlock* slot = (FreeBlock*)MemoryTracker::UntrackSlot(ptr);
+#else
+		FreeBlock* slot = (FreeBlock*)ptr;
+#endif
+		ObjectPoolLocalCache& cache = localCache;
+		if (cacheIndex < 0 || cache.retired || !cache.registered) {
+			freeSlots.Push(slot, slot, 1);
+			return;
+		}
+		// Objects destroyed on another thread than the one they came from join the free list of this one.
+		cache.lists[cacheIndex].Push(freeSlots, slot);
+	}
+	void ObjectPool::Deallocate(void* ptr) {
+		if (IsOwned(ptr)) {
+			Deallocate(ptr, slotSize);
+		} else {
+			Memory::Deallocate(ptr);
+		}
+	}
+	bool ObjectPool::IsOwned(const void* ptr) const {
+		auto lock = SimpleLock<Mutex>(slabMutex);
+		for (Slab* slab = slabs; slab != nullptr; slab = slab->next) {
+			const byte* data = slab->GetData();
+			if (ptr >= data && ptr < data + slab->capacity) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	String ObjectPool::GetName() const {
+		return name;
+	}
+	sizeint ObjectPool::GetSlotSize() const {
+		return slotSize;
+	}
+	int32 ObjectPool::GetUsedCount() const {
+		// Counted from the slots out of the shared list, so allocating does not need to touch shared counters.
+		auto registryLock = SimpleLock<Mutex>(registryMutex);
+		int32 cachedCount = 0;
+		if (cacheIndex >= 0) {
+			for (ObjectPoolLocalCache* cache = firstCache; cache != nullptr; cache = cache->nextCache) {
+				cachedCount += cache->lists[cacheIndex].GetCount();
+			}
+		}
+		return freeSlots.GetTakenCount() - cachedCount;
+	}
+	int32 ObjectPool::GetPeakUsedCount() const {
+		return freeSlots.GetPeakTakenCount();
+	}
+	int32 ObjectPool::GetSlotCount() const {
+		return freeSlots.GetBlockCount();
+	}
+	int32 ObjectPool::GetSlabCount() const {
+		auto lock = SimpleLock<Mutex>(slabMutex);
+		return slabCount;
+	}
+	sizeint ObjectPool::GetReservedSize() const {
+		auto lock = SimpleLock<Mutex>(slabMutex);
+		return slabCount * (HeaderSize + (slotSize + SlotHeaderSize) * slabSlotCount);
+	}
+
+	List<ObjectPool*> ObjectPool::GetPools() {
+		auto lock = SimpleLock<Mutex>(registryMutex);
+		List<ObjectPool*> result{};
+		for (ObjectPool* pool = firstPool; pool != nullptr; pool = pool->nextPool) {
+			result.Add(pool);
+		}
+		return result;
+	}
+}
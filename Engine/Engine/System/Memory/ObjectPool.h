@@ -0,0 +1,120 @@
+#pragma once
+
+#include "Engine/System/Definition.h"
+#include "Engine/System/Memory/Memory.h"
+#include "Engine/System/Memory/FreeList.h"
+#include "Engine/System/String.h"
+#include "Engine/System/Collection/List.h"
+#include "Engine/System/Thread/ThreadUtil.h"
+#include <cstddef>
+
+/// @brief Put the instances of a reflection class in an ObjectPool of their own. Place it after REFLECTION_CLASS.\n
+/// MEMNEW takes a slot from the pool, MEMDEL gives it back through the virtual destructor.
+/// Derived classes share the pool while they fit in a slot, larger ones go to the heap unless they are pooled as well.
+#define OBJECT_POOLED(type)																				\
+public:																									\
+	static void* operator new(size_t size, ::Engine::MemoryTag){										\
+		return ::Engine::ObjectPool::Get<type>().Allocate(size);										\
+	}																									\
+	static void operator delete(void* ptr, ::Engine::MemoryTag){										\
+		::Engine::ObjectPool::Get<type>().Deallocate(ptr);												\
+	}																									\
+	static void operator delete(void* ptr, size_t size){												\
+		::Engine::ObjectPool::Get<type>().Deallocate(ptr, size);										\
+	}																									\
+private:
+
+namespace Engine {
+	/// @brief Slab storage for the objects of one class, see OBJECT_POOLED.\n
+	/// Slots are carved from slabs in order and recycled, the most recently freed first.
+	/// Like SizeClassAllocator, every thread keeps a LocalFreeList of each pool in front of the SharedFreeList of the pool.
+	/// Pools are created on first use and never destroyed, slabs are kept for the lifetime of the program.
+	class ObjectPool final {
+	public:
+		/// @brief Memory carved into slots at once.
+		static inline constexpr sizeint SlabSize = 64 * 1024;
+		/// @brief Slots of a slab at least, for classes too large to fill a slab.
+		static inline constexpr int32 MinSlabSlotCount = 8;
+		/// @brief Slots moved between a thread free list and the shared one at a time.
+		static inline constexpr int32 TransferCount = 32;
+		/// @brief Free slots of a pool a thread keeps before giving a batch back.
+		static inline constexpr int32 LocalCacheLimit = TransferCount * 2;
+		/// @brief Pools getting thread free lists, later ones always take the lock.
+		static inline constexpr int32 MaxCachedPoolCount = 256;
+
+		ObjectPool(const ObjectPool&) = delete;
+		ObjectPool& operator=(const ObjectPool&) = delete;
+
+		/// @brief Take a slot. Requests larger than a slot go to the heap.
+		void* Allocate(sizeint size);
+		/// @brief Give back a block of Allocate(size) with the same size.
+		void Deallocate(void* ptr, sizeint size);
+		/// @brief Give back a block of unknown size. Slower, the slabs are searched for the block.
+		void Deallocate(void* ptr);
+		/// @brief Check if the block is a slot of this pool.
+		bool IsOwned(const void* ptr) const;
+
+		String GetName() const;
+		sizeint GetSlotSize() const;
+		/// @brief Get the count of slots in use.
+		int32 GetUsedCount() const;
+		/// @brief Get the highest count of slots out of the shared list at once, in use or waiting in thread free lists.
+		int32 GetPeakUsedCount() const;
+		/// @brief Get the count of slots carved so far, used or free.
+		int32 GetSlotCount() const;
+		int32 GetSlabCount() const;
+		/// @brief Get the bytes of every slab held by the pool.
+		sizeint GetReservedSize() const;
+
+		/// @brief Get the pool of a class.
+		template<typename T>
+		static ObjectPool& Get() {
+			static_assert(alignof(T) <= alignof(std::max_align_t), "Over-aligned classes cannot be pooled.");
+			// Leaked on purpose, objects may still be deleted by other static destructors at exit.
+			static ObjectPool* pool = MEMNEW(ObjectPool(T::GetReflectionClassNameStatic(), sizeof(T)));
+			return *pool;
+		}
+		/// @brief Get every pool created so far.
+		static List<ObjectPool*> GetPools();
+
+	private:
+		struct Slab {
+			Slab* next;
+			sizeint capacity;
+
+			byte* GetData() {
+				return (byte*)this + HeaderSize;
+			}
+		};
+		static inline constexpr sizeint HeaderSize = (sizeof(Slab) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+		using LocalSlots = LocalFreeList<TransferCount, LocalCacheLimit>;
+		friend struct ObjectPoolLocalCache;
+
+		/// @param name Name shown in the statistics, usually the reflection class name.
+		/// @param slotSize Size of a slot, the size of the pooled class.
+		ObjectPool(const String& name, sizeint slotSize);
+
+		/// @brief Take a free slot, from the thread free list if there is one.
+		void* TakeSlot();
+		/// @brief Refill the shared list with a new slab, for SharedFreeList::Take().
+		int32 CarveSlab(FreeBlock*& head, FreeBlock*& tail);
+
+		String name;
+		sizeint slotSize;
+		int32 slabSlotCount;
+		/// @brief Index of the thread free lists, -1 when there are too many pools.
+		int32 cacheIndex;
+
+		SharedFreeList<> freeSlots{};
+		/// @brief Guards the slabs, taken under the lock of freeSlots when carving.
+		mutable Mutex slabMutex;
+		Slab* slabs = nullptr;
+		int32 slabCount = 0;
+
+		/// @brief Next pool in the registry.
+		ObjectPool* nextPool = nullptr;
+		static ObjectPool* firstPool;
+		static int32 poolCount;
+		static Mutex registryMutex;
+	};
+}
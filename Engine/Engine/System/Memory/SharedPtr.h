@@ -13,6 +13,8 @@ namespace Engine {
 	template<typename T>
 	class SharedPtr {
 	public:
+		TRIVIALLY_RELOCATABLE;
+
 		template<typename ... Args>
 		static SharedPtr Create(Args&& ... args) {
 			return SharedPtr(MEMNEW(T(Memory::Forward<Args>(args)...)));
@@ -0,0 +1,189 @@
+#include "Engine/System/Memory/SizeClassAllocator.h"
+#include "Engine/System/Memory/FreeList.h"
+#include "Engine/System/Thread/ThreadUtil.h"
+#include <atomic>
+#include <bit>
+#include <cstdlib>
+#include <cstring>
+
+namespace Engine {
+	namespace {
+		/// @brief sizeClass of blocks allocated on their own.
+		constexpr uint32 LargeClass = UINT32_MAX;
+
+		struct alignas(SizeClassAllocator::Alignment) BlockHeader {
+			uint32 sizeClass;
+			/// @brief Requested size of a large block.
+			sizeint size;
+		};
+		static_assert(sizeof(BlockHeader) == SizeClassAllocator::HeaderSize, "The block header must keep blocks aligned.");
+
+		struct alignas(ThreadUtil::CacheLineSize) SharedClass {
+			/// @brief The link of free blocks overlays the header.
+			SharedFreeList<> list;
+		};
+		// Constant initialized, so allocations from static constructors of other files find them ready.
+		SharedClass sharedClasses[SizeClassAllocator::SizeClassCount];
+		std::atomic<sizeint> reservedSize{ 0 };
+
+		/// @brief Free blocks of the current thread. Trivially destructible, it stays usable while other thread locals are torn down.
+		struct LocalCache {
+			LocalFreeList<SizeClassAllocator::TransferCount, SizeClassAllocator::LocalCacheLimit> lists[SizeClassAllocator::SizeClassCount];
+			/// @brief Set once the thread is exiting, blocks go to the shared lists directly from then on.
+			bool retired;
+		};
+		thread_local LocalCache localCache{};
+
+		/// @brief Gives the cached blocks back when the thread exits.
+		struct LocalCacheFlusher {
+			~LocalCacheFlusher() {
+				LocalCache& cache = localCache;
+				for (int32 i = 0; i < SizeClassAllocator::SizeClassCount; i += 1) {
+					cache.lists[i].Flush(sharedClasses[i].list);
+				}
+				cache.retired = true;
+			}
+		};
+		thread_local LocalCacheFlusher localCacheFlusher;
+
+		/// @brief Refills a shared list when everything is in use, for SharedFreeList::Take().
+		struct ChunkCarver {
+			int32 sizeClass;
+
+			int32 operator()(FreeBlock*& head, FreeBlock*& tail) const {
+				// Large classes get a few blocks at least.
+				sizeint blockSize = SizeClassAllocator::HeaderSize + SizeClassAllocator::GetClassSize(sizeClass);
+				sizeint blockCount = SizeClassAllocator::ChunkSize / blockSize;
+				if (blockCount < 4) {
+					blockCount = 4;
+				}
+				byte* chunk = (byte*)std::malloc(blockSize * blockCount);
+				if (chunk == nullptr) {
+					return 0;
+				}
+				reservedSize.fetch_add(blockSize * blockCount, std::memory_order_relaxed);
+				return SharedFreeList<>::LinkBlocks(chunk, blockSize, static_cast<int32>(blockCount), head, tail);
+			}
+		};
+
+		constexpr sizeint ComputeClassSize(int32 sizeClass) {
+			if (sizeClass < 8) {
+				return static_cast<sizeint>(sizeClass + 1) * 16;
+			}
+			int32 group = (sizeClass - 8) / 4;
+			int32 step = (sizeClass - 8) % 4;
+			sizeint base = static_cast<sizeint>(128) << group;
+			return base + (base / 4) * (step + 1);
+		}
+		static_assert(ComputeClassSize(SizeClassAllocator::SizeClassCount - 1) == SizeClassAllocator::MaxSmallSize, "The last size class must be MaxSmallSize.");
+	}
+
+	void* SizeClassAllocator::Allocate(sizeint size) {
+		int32 sizeClass = GetSizeClass(size);
+		BlockHeader* header = nullptr;
+		if (sizeClass < 0) {
+			header = (BlockHeader*)std::malloc(HeaderSize + size);
+			if (header == nullptr) {
+				return nullptr;
+			}
+			header->sizeClass = LargeClass;
+			header->size = size;
+			return header + 1;
+		}
+
+		FreeBlock* block = nullptr;
+		LocalCache& cache = localCache;
+		if (cache.retired) {
+			sharedClasses[sizeClass].list.Take(1, block, ChunkCarver{ sizeClass });
+		} else {
+			if (cache.lists[sizeClass].GetCount() == 0) {
+				// Touch the flusher so it is constructed, and its destructor registered, on this thread.
+				(void)&localCacheFlusher;
+			}
+			block = cache.lists[sizeClass].Pop(sharedClasses[sizeClass].list, ChunkCarver{ sizeClass });
+		}
+		if (block == nullptr) {
+			return nullptr;
+		}
+
+		header = (BlockHeader*)block;
+		header->sizeClass = static_cast<uint32>(sizeClass);
+		return header + 1;
+	}
+	void* SizeClassAllocator::Reallocate(void* ptr, sizeint newSize) {
+		BlockHeader* header = (BlockHeader*)ptr - 1;
+		if (header->sizeClass == LargeClass) {
+			if (newSize > MaxSmallSize) {
+				header = (BlockHeader*)std::realloc(header, HeaderSize + newSize);
+				if (header == nullptr) {
+					return nullptr;
+				}
+				header->size = newSize;
+				return header + 1;
+			}
+		} else {
+			// Stay in place unless the block would be more than half empty.
+			sizeint classSize = GetClassSize(static_cast<int32>(header->sizeClass));
+			if (newSize <= classSize && newSize * 2 > classSize) {
+				return ptr;
+			}
+		}
+
+		void* result = Allocate(newSize);
+		if (result == nullptr) {
+			return nullptr;
+		}
+		sizeint oldSize = GetUsableSize(ptr);
+		std::memcpy(result, ptr, oldSize < newSize ? oldSize : newSize);
+		Deallocate(ptr);
+		return result;
+	}
+	void SizeClassAllocator::Deallocate(void* ptr) {
+		if (ptr == nullptr) {
+			return;
+		}
+
+		BlockHeader* header = (BlockHeader*)ptr - 1;
+		if (header->sizeClass == LargeClass) {
+			std::free(header);
+			return;
+		}
+
+		int32 sizeClass = static_cast<int32>(header->sizeClass);
+		FreeBlock* block = (FreeBlock*)header;
+		LocalCache& cache = localCache;
+		if (cache.retired) {
+			sharedClasses[sizeClass].list.Push(block, block, 1);
+			return;
+		}
+		// Blocks freed on another thread than the one they came from join the free list of this one.
+		cache.lists[sizeClass].Push(sharedClasses[sizeClass].list, block);
+	}
+
+	sizeint SizeClassAllocator::GetUsableSize(const void* ptr) {
+		const BlockHeader* header = (const BlockHeader*)ptr - 1;
+		if (header->sizeClass == LargeClass) {
+			return header->size;
+		}
+		return GetClassSize(static_cast<int32>(header->sizeClass));
+	}
+	int32 SizeClassAllocator::GetSizeClass(sizeint size) {
+		if (size <= 128) {
+			return size == 0 ? 0 : static_cast<int32>((size - 1) / 16);
+		}
+		if (size > MaxSmallSize) {
+			return -1;
+		}
+		// size lies in (2^k, 2^(k+1)], which is cut into four classes.
+		int32 k = static_cast<int32>(std::bit_width(size - 1)) - 1;
+		sizeint base = static_cast<sizeint>(1) << k;
+		int32 step = static_cast<int32>((size - 1 - base) >> (k - 2));
+		return 8 + (k - 7) * 4 + step;
+	}
+	sizeint SizeClassAllocator::GetClassSize(int32 sizeClass) {
+		return ComputeClassSize(sizeClass);
+	}
+	sizeint SizeClassAllocator::GetReservedSize() {
+		return reservedSize.load(std::memory_order_relaxed);
+	}
+}
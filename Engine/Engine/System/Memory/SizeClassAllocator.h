@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Engine/System/Definition.h"
+
+namespace Engine {
+	/// @brief The engine allocator behind Memory::Allocate().\n
+	/// Small blocks are rounded up to a size class and recycled through free lists, one set per thread,
+	/// which trade batches with shared lists under a per-class lock. Large blocks go to malloc.
+	/// Every block carries a small header, so a block can be freed or resized from any thread without knowing its size.
+	/// Chunks are never given back, the pooled memory keeps the high water mark of each size class.
+	class SizeClassAllocator final {
+	public:
+		STATIC_CLASS(SizeClassAllocator);
+
+		/// @brief Size of the header in front of every block. Keeps blocks aligned like malloc does.
+		static inline constexpr sizeint HeaderSize = 16;
+		static inline constexpr sizeint Alignment = 16;
+		/// @brief Largest block served from the size classes.
+		static inline constexpr sizeint MaxSmallSize = 16384;
+		/// @brief 16 byte steps up to 128, then four classes per power of two up to MaxSmallSize.
+		static inline constexpr int32 SizeClassCount = 36;
+		/// @brief Memory carved into blocks at once when a size class runs dry.
+		static inline constexpr sizeint ChunkSize = 64 * 1024;
+		/// @brief Blocks moved between a thread free list and the shared one at a time.
+		static inline constexpr int32 TransferCount = 32;
+		/// @brief Free blocks of a size class a thread keeps before giving a batch back.
+		static inline constexpr int32 LocalCacheLimit = TransferCount * 2;
+
+		static void* Allocate(sizeint size);
+		static void* Reallocate(void* ptr, sizeint newSize);
+		static void Deallocate(void* ptr);
+
+		/// @brief Get the bytes a block can hold, at least the requested size.
+		static sizeint GetUsableSize(const void* ptr);
+		/// @brief Get the size class serving a request, -1 for large blocks.
+		static int32 GetSizeClass(sizeint size);
+		/// @brief Get the block size of a size class.
+		static sizeint GetClassSize(int32 sizeClass);
+		/// @brief Get the bytes reserved in chunks for the size classes so far.
+		static sizeint GetReservedSize();
+	};
+}
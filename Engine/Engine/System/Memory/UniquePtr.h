@@ -8,6 +8,8 @@ namespace Engine {
 	template<typename T>
 	class UniquePtr final {
 	public:
+		TRIVIALLY_RELOCATABLE;
+
 		template<typename ... Args>
 		static UniquePtr Create(Args&& ... args) {
 			return UniquePtr(MEMNEW(T(Memory::Forward<Args>(args)...)));
@@ -76,6 +78,8 @@ namespace Engine {
 	template<typename T>
 	class UniquePtr<T[]> {
 	public:
+		TRIVIALLY_RELOCATABLE;
+
 		static UniquePtr Create(sizeint length) {
 			return UniquePtr(MEMNEWARR(T, length));
 		}
@@ -1,6 +1,7 @@
 #include "Engine/System/Object/Object.h"
 #include "Engine/System/Object/ObjectUtil.h"
 #include "Engine/System/String.h"
+#include "Engine/System/Memory/FrameArena.h"
 
 namespace Engine {
 	Invokable::Invokable() :instanceId(InstanceId()), methodName(String::GetEmpty()) {}
@@ -15,12 +16,22 @@ namespace Engine {
 
 #pragma region Object
 	// Change this capacity value to a reasonable one.
-	Dictionary<InstanceId, Object*> Object::objectLookup{ 100 };
+	ConcurrentDictionary<InstanceId, Object*> Object::objectLookup{ 100 };
 
 	Object::~Object() {
 		objectLookup.Remove(instanceId);
 	}
 
+	void* Object::operator new(size_t size, MemoryTag) {
+		return Memory::Allocate(size);
+	}
+	void Object::operator delete(void* ptr, MemoryTag) {
+		Memory::Deallocate(ptr);
+	}
+	void Object::operator delete(void* ptr, size_t size) {
+		Memory::Deallocate(ptr);
+	}
+
 	String Object::ToString() const {
 		return String::Format(STRING_LITERAL("{0} ({1})"), GetReflectionClassName(), GetInstanceId().Get());
 	}
@@ -213,14 +224,23 @@ namespace Engine {
 				target->InvokeMethod(invokable.methodName, arguments, argumentCount, tempReturn);
 			} else {
 				int32 newArgCount = argumentCount + extraArgCount;
-				auto newArgs = UniquePtr<const Variant* []>::Create(newArgCount);
+				// The pointer array only lives for this call, take it from the frame arena inside the engine loop.
+				UniquePtr<const Variant* []> heapArgs{};
+				const Variant** newArgs = nullptr;
+				FrameArena* arena = FrameArena::GetCurrent();
+				if (arena != nullptr) {
+					newArgs = arena->AllocateArray<const Variant*>(newArgCount);
+				} else {
+					heapArgs = UniquePtr<const Variant* []>::Create(newArgCount);
+					newArgs = heapArgs.GetRaw();
+				}
 				for (int i = 0; i < argumentCount; i += 1) {
-					newArgs.GetRaw()[i] = arguments[i];
+					newArgs[i] = arguments[i];
 				}
 				for (int i = 0; i < extraArgCount; i += 1) {
-					newArgs.GetRaw()[argumentCount + i] = extraArgs.GetRawElementPtr() + i;
+					newArgs[argumentCount + i] = extraArgs.GetRawElementPtr() + i;
 				}
-				target->InvokeMethod(invokable.methodName, newArgs.GetRaw(), newArgCount, tempReturn);
+				target->InvokeMethod(invokable.methodName, newArgs, newArgCount, tempReturn);
 			}
 		}
 
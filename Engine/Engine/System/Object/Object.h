@@ -5,6 +5,8 @@
 #include "Engine/System/Thread/Atomic.h"
 #include "Engine/System/Object/InstanceId.h"
 #include "Engine/System/Collection/Dictionary.h"
+#include "Engine/System/Collection/ConcurrentDictionary.h"
+#include "Engine/System/Collection/InlineList.h"
 #include "Engine/System/Object/Reflection.h"
 #include "Engine/System/Memory/CopyOnWrite.h"
 
@@ -35,6 +37,12 @@ namespace Engine{
 
 		virtual ~Object() = 0;
 
+		// MEMDEL deletes objects through their virtual destructor, which frees the memory with operator delete of the most derived class.
+		// Classes may put their instances in an ObjectPool, see OBJECT_POOLED.
+		static void* operator new(size_t size, MemoryTag);
+		static void operator delete(void* ptr, MemoryTag);
+		static void operator delete(void* ptr, size_t size);
+
 		// Indicates if current object is a ReferencedObject
 		virtual bool IsReferenced() const = 0;
 
@@ -70,14 +78,15 @@ namespace Engine{
 #pragma endregion
 
 	protected:
-		static Dictionary<InstanceId, Object*> objectLookup;
+		/// @brief Every live object by id, objects are created and destroyed from any thread.
+		static ConcurrentDictionary<InstanceId, Object*> objectLookup;
 		InstanceId instanceId;
 
 	private:
 		struct ExtraData {
 			struct SignalConnection {
 				ReflectionSignal::ConnectFlag flag = ReflectionSignal::ConnectFlag::Null;
-				List<Variant> extraArguments;
+				InlineList<Variant, 2> extraArguments;
 			};
 			struct SignalConnectionGroup {
 				using ConnectionsType = CopyOnWrite<Dictionary<Invokable, SharedPtr<SignalConnection>>>;
@@ -86,5 +86,8 @@ namespace Engine {
 		sizeint v = *((sizeint*)(&obj));
 		return GetHashCode(v);
 	}
+	int32 ObjectUtil::GetHashCode(std::u8string_view obj) {
+		return String::GetHashCode(obj);
+	}
 #pragma endregion
 }
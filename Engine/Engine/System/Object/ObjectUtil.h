@@ -47,6 +47,7 @@ namespace Engine{
 		static int32 GetHashCode(float obj);
 		static int32 GetHashCode(double obj);
 		static int32 GetHashCode(const void* obj);
+		static int32 GetHashCode(std::u8string_view obj);
 #pragma endregion
 	};
 }
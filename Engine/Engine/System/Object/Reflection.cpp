@@ -94,8 +94,11 @@ namespace Engine{
 		return false;
 	}
 	bool ReflectionClass::TryGetMethod(const String& name, ReflectionMethod*& result) const {
+		return TryGetMethod(name, name.GetHashCode(), result);
+	}
+	bool ReflectionClass::TryGetMethod(const String& name, int32 hashCode, ReflectionMethod*& result) const {
 		SharedPtr<ReflectionMethod> intermediate;
-		if (methods.TryGet(name, intermediate)) {
+		if (methods.TryGetWithHash(name, hashCode, intermediate)) {
 			result = intermediate.GetRaw();
 			return true;
 		} else {
@@ -108,9 +111,10 @@ namespace Engine{
 		return ptr;
 	}
 	bool ReflectionClass::TryGetMethodInTree(const String& name, ReflectionMethod*& result) const {
+		int32 hashCode = name.GetHashCode();
 		const ReflectionClass* current = this;
 		do {
-			if (current->TryGetMethod(name, result)) {
+			if (current->TryGetMethod(name, hashCode, result)) {
 				return true;
 			}
 			if (!Reflection::TryGetClass(current->parentName, current)) {
@@ -145,8 +149,11 @@ namespace Engine{
 		return false;
 	}
 	bool ReflectionClass::TryGetProperty(const String& name, ReflectionProperty*& result) const {
+		return TryGetProperty(name, name.GetHashCode(), result);
+	}
+	bool ReflectionClass::TryGetProperty(const String& name, int32 hashCode, ReflectionProperty*& result) const {
 		SharedPtr<ReflectionProperty> intermediate;
-		if (properties.TryGet(name, intermediate)) {
+		if (properties.TryGetWithHash(name, hashCode, intermediate)) {
 			result = intermediate.GetRaw();
 			return true;
 		} else {
@@ -154,9 +161,10 @@ namespace Engine{
 		}
 	}
 	bool ReflectionClass::TryGetPropertyInTree(const String& name, ReflectionProperty*& result) const {
+		int32 hashCode = name.GetHashCode();
 		const ReflectionClass* current = this;
 		do {
-			if (current->TryGetProperty(name, result)) {
+			if (current->TryGetProperty(name, hashCode, result)) {
 				return true;
 			}
 			if (!Reflection::TryGetClass(current->parentName, current)) {
@@ -191,8 +199,11 @@ namespace Engine{
 		return false;
 	}
 	bool ReflectionClass::TryGetSignal(const String& name, ReflectionSignal*& result) const {
+		return TryGetSignal(name, name.GetHashCode(), result);
+	}
+	bool ReflectionClass::TryGetSignal(const String& name, int32 hashCode, ReflectionSignal*& result) const {
 		SharedPtr<ReflectionSignal> intermediate;
-		if (signals.TryGet(name, intermediate)) {
+		if (signals.TryGetWithHash(name, hashCode, intermediate)) {
 			result = intermediate.GetRaw();
 			return true;
 		} else {
@@ -200,9 +211,10 @@ namespace Engine{
 		}
 	}
 	bool ReflectionClass::TryGetSignalInTree(const String& name, ReflectionSignal*& result) const {
+		int32 hashCode = name.GetHashCode();
 		const ReflectionClass* current = this;
 		do {
-			if (current->TryGetSignal(name, result)) {
+			if (current->TryGetSignal(name, hashCode, result)) {
 				return true;
 			}
 			if (!Reflection::TryGetClass(current->parentName, current)) {
@@ -219,6 +231,12 @@ namespace Engine{
 	bool ReflectionClass::RemoveSignal(const String& name) {
 		return signals.Remove(name);
 	}
+
+	void ReflectionClass::Freeze() {
+		methods.SetCapacity(methods.GetCount());
+		properties.SetCapacity(properties.GetCount());
+		signals.SetCapacity(signals.GetCount());
+	}
 #pragma endregion
 
 #pragma region ReflectionMethod
@@ -251,7 +269,7 @@ namespace Engine{
 		return bind;
 	}
 
-	List<String>& ReflectionMethod::GetArgumentNameList() {
+	ReflectionMethod::ArgumentNameList& ReflectionMethod::GetArgumentNameList() {
 		return argumentNames;
 	}
 	List<Variant>& ReflectionMethod::GetDefaultArgumentList() {
@@ -6,6 +6,7 @@
 #include "Engine/System/Memory/SharedPtr.h"
 #include "Engine/System/Collection/Dictionary.h"
 #include "Engine/System/Collection/List.h"
+#include "Engine/System/Collection/InlineList.h"
 #include "Engine/System/Object/Variant.h"
 #include "Engine/System/Object/InstanceId.h"
 
@@ -52,6 +53,7 @@ protected:																								\
 		);																								\
 		FATAL_ASSERT(ptr!=nullptr,u8"Failed to register class.");										\
 		_InitializeCustomReflection(ptr);																\
+		ptr->Freeze();																					\
 																										\
 		inited=true;																					\
 	}																									\
@@ -95,6 +97,7 @@ protected:																								\
 		);																								\
 		FATAL_ASSERT(ptr!=nullptr,u8"Failed to register class.");										\
 		_InitializeCustomReflection(ptr);																\
+		ptr->Freeze();																					\
 																										\
 		inited=true;																					\
 	}																									\
@@ -207,9 +210,17 @@ namespace Engine {
 		bool TryGetSignalInTree(const String& name, ReflectionSignal*& result) const;
 		ReflectionSignal* AddSignal(SharedPtr<ReflectionSignal> signal);
 		bool RemoveSignal(const String& name);
+
+		/// @brief Done registering, shrink the method, property and signal tables to the smallest ones holding their entries.
+		void Freeze();
 	private:
 		friend class Reflection;
 
+		// The tree lookups hash the name once for every class on the way.
+		bool TryGetMethod(const String& name, int32 hashCode, ReflectionMethod*& result) const;
+		bool TryGetProperty(const String& name, int32 hashCode, ReflectionProperty*& result) const;
+		bool TryGetSignal(const String& name, int32 hashCode, ReflectionSignal*& result) const;
+
 		String name;
 		String parentName;
 		bool instantiable = true;
@@ -226,6 +237,8 @@ namespace Engine {
 
 	class ReflectionMethod final {
 	public:
+		using ArgumentNameList = InlineList<String, 4>;
+
 		ReflectionMethod(const String& name, SharedPtr<ReflectionMethodBind> bind);
 		ReflectionMethod(
 			const String& name, SharedPtr<ReflectionMethodBind> bind,
@@ -241,7 +254,7 @@ namespace Engine {
 		void SetBind(SharedPtr<ReflectionMethodBind> bind);
 		SharedPtr<ReflectionMethodBind> GetBind() const;
 
-		List<String>& GetArgumentNameList();
+		ArgumentNameList& GetArgumentNameList();
 		List<Variant>& GetDefaultArgumentList();
 
 		ResultCode Invoke(Object* target, const Variant** arguments, int32 argumentCount, Variant& returnValue) const;
@@ -250,7 +263,7 @@ namespace Engine {
 		friend class ReflectionClass;
 
 		String name;
-		List<String> argumentNames;
+		ArgumentNameList argumentNames;
 		List<Variant> defaultArguments;
 
 		SharedPtr<ReflectionMethodBind> bind;
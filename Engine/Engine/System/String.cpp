@@ -4,6 +4,7 @@
 #include "Engine/System/Memory/Memory.h"
 #include "Engine/System/Collection/Iterator.h"
 #include "Engine/System/Memory/UniquePtr.h"
+#include "Engine/System/Memory/FrameArena.h"
 #include <string>
 #include <cstring>
 #include <string_view>
@@ -38,6 +39,16 @@ namespace Engine {
 		return referenceCount.Get();
 	}
 	
+	int32 String::ContentData::GetHashCode() const {
+		int64 result = hashCode.load(std::memory_order_relaxed);
+		if (result == NoHashCode) {
+			// Racing threads compute the same value, no need to lock.
+			result = String::GetHashCode(std::u8string_view(data, length - 1));
+			hashCode.store(result, std::memory_order_relaxed);
+		}
+		return static_cast<int32>(result);
+	}
+
 	IntrusivePtr<String::ContentData> String::ContentData::GetEmpty() {
 		static const ContentData empty(u8"", 1);
 		static IntrusivePtr<ContentData> ptr{ const_cast<ContentData*>(&empty) };
@@ -104,6 +115,19 @@ namespace Engine {
 		PrepareData(string.c_str(), static_cast<int32>(string.length()));
 	}
 
+	TransientString String::CreateTransient(const u8char* string, int32 count) {
+		FrameArena* arena = FrameArena::GetCurrent();
+		if (arena == nullptr || count <= 0) {
+			return TransientString(String(string, count));
+		}
+
+		// Tag the chars with the frame they were bumped from, the loop may advance the arena meanwhile.
+		uint64 frameIndex = 0;
+		u8char* chars = (u8char*)arena->Allocate(count + 1, FrameArena::Alignment, &frameIndex);
+		std::memcpy(chars, string, count);
+		chars[count] = u8'\0';
+		return TransientString(chars, count, arena, frameIndex);
+	}
 	String::String(IntrusivePtr<ContentData> dataPtr, int32 start, int32 count) :data(dataPtr), refStart(start), refCount(count < 0 ? dataPtr->length - 1 : count) {}
 
 	void String::PrepareData(const u8char* string, sizeint count) {
@@ -271,12 +295,24 @@ namespace Engine {
 	bool String::operator!=(const String& obj) const {
 		return !IsEqual(obj);
 	}
+	bool String::operator==(std::u8string_view text) const {
+		return GetU8StringView() == text;
+	}
+	bool String::operator==(const u8char* text) const {
+		return GetU8StringView() == std::u8string_view(text);
+	}
 
 	String String::ToString() const {
 		return *this;
 	}
 	int32 String::GetHashCode() const {
-		return ObjectUtil::GetHashCode(std::hash<std::string_view>{}(GetStringView()));
+		if (IsIndividual()) {
+			return data->GetHashCode();
+		}
+		return GetHashCode(GetU8StringView());
+	}
+	int32 String::GetHashCode(std::u8string_view text) {
+		return ObjectUtil::GetHashCode(std::hash<std::u8string_view>{}(text));
 	}
 
 	int32 String::GetStartIndex() const {
@@ -298,4 +334,37 @@ namespace Engine {
 	}
 
 	String::SearcherSunday String::searcher{};
+
+	TransientString::TransientString(const u8char* chars, int32 count, const FrameArena* arena, uint64 frameIndex) :chars(chars), count(count), arena(arena), frameIndex(frameIndex) {}
+	TransientString::TransientString(String&& owned) :owned(Memory::Move(owned)), chars(this->owned.GetStartPtr()), count(this->owned.GetCount()) {}
+
+	int32 TransientString::GetCount() const {
+		return count;
+	}
+	const u8char* TransientString::GetRawArray() const {
+		ERR_ASSERT(IsAlive(), u8"The transient string outlived its frame, keep it with ToString().", return u8"");
+		return chars;
+	}
+	std::u8string_view TransientString::GetU8StringView() const {
+		return std::u8string_view(GetRawArray(), count);
+	}
+	String TransientString::ToString() const {
+		if (arena == nullptr) {
+			return owned;
+		}
+		return String(GetRawArray(), count);
+	}
+	bool TransientString::IsAlive() const {
+		return arena == nullptr || arena->IsFrameAlive(frameIndex);
+	}
+
+	bool TransientString::operator==(const String& obj) const {
+		return GetU8StringView() == obj.GetU8StringView();
+	}
+	bool TransientString::operator==(std::u8string_view text) const {
+		return GetU8StringView() == text;
+	}
+	bool TransientString::operator==(const u8char* text) const {
+		return GetU8StringView() == std::u8string_view(text);
+	}
 }
\ No newline at end of file
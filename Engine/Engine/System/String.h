@@ -7,6 +7,7 @@
 #include "Engine/System/Memory/IntrusivePtr.h"
 #include "Engine/System/Collection/List.h"
 #include <string_view>
+#include <atomic>
 
 /// @brief Make a UTF-8 String literal. No need to add u8 prefix.
 /// This prevents allocating heap memory for constant strings.
@@ -21,10 +22,15 @@
 #define STRL STRING_LITERAL
 
 namespace Engine {
+	class FrameArena;
+	class TransientString;
+
 	/// @brief A string holding a NULL-termined char array.
 	/// The actual content is reference counted, so it's cheap to copy around.
 	class String final {
 	public:
+		TRIVIALLY_RELOCATABLE;
+
 		/// @brief Container of actual content data of Strings. Shared between Strings. 
 		struct ContentData final {
 			/// @brief Accept data as a static block. Will not free the data.
@@ -49,11 +55,17 @@ namespace Engine {
 			uint32 Dereference() const;
 			uint32 GetReferenceCount() const;
 
+			/// @brief Get the hash code of the whole content, computed on first use.
+			int32 GetHashCode() const;
+
 			/// @brief Get the global empty content data.
 			static IntrusivePtr<ContentData> GetEmpty();
 		private:
 			bool staticData;
 			mutable ReferenceCount referenceCount;
+			/// @brief NoHashCode until computed. The content never changes, so neither does the hash code.
+			mutable std::atomic<int64> hashCode{ NoHashCode };
+			static inline constexpr int64 NoHashCode = -1;
 		};
 
 		class SearcherSunday {
@@ -135,13 +147,18 @@ namespace Engine {
 		String Replace(const String& from, const String& to) const;
 
 		String ToString() const;
+		/// @brief Get the hash code. Cached in the content for strings covering all of it, see IsIndividual().
 		int32 GetHashCode() const;
+		/// @brief Get the hash code String would give the text, for looking Strings up without making one.
+		static int32 GetHashCode(std::u8string_view text);
 
 		int32 GetStartIndex() const;
 		const u8char* GetStartPtr() const;
 
 		bool operator==(const String& obj) const;
 		bool operator!=(const String& obj) const;
+		bool operator==(std::u8string_view text) const;
+		bool operator==(const u8char* text) const;
 
 		std::string_view GetStringView() const;
 		std::u8string_view GetU8StringView() const;
@@ -152,6 +169,14 @@ namespace Engine {
 		static String Format(const String& format, const Ts& ... args) {
 			return fmt::format(format.GetStringView(), args...);
 		}
+		/// @brief Format into the current frame arena, for strings thrown away within the frame.\n
+		/// The result does not own its chars and is only valid until the arena rewinds, see TransientString.
+		/// Outside of the engine loop it holds a plain Format().
+		template<typename ... Ts>
+		static TransientString FormatTransient(const String& format, const Ts& ... args);
+		/// @brief Copy a string into the current frame arena. Same lifetime rules as FormatTransient().
+		/// @param count The char count. NULL NOT included.
+		static TransientString CreateTransient(const u8char* string, int32 count);
 #pragma endregion
 
 		String operator+(const String& obj);
@@ -173,6 +198,50 @@ namespace Engine {
 
 		static List<sizeint> replacerIndexes;
 	};
+
+	/// @brief Chars in the current frame arena, made by String::FormatTransient() and String::CreateTransient().\n
+	/// It does not own the chars, which are only valid until the arena rewinds them, see FrameArena.
+	/// Keep it past the frame with ToString(). Reading it after the arena rewound its frame asserts.
+	class TransientString final {
+	public:
+		/// @brief Get char count. NULL NOT included.
+		int32 GetCount() const;
+		/// @brief Get the NULL-terminated chars. Do not store the pointer.
+		const u8char* GetRawArray() const;
+		std::u8string_view GetU8StringView() const;
+		/// @brief Copy the chars into a String on the heap, which outlives the frame.
+		String ToString() const;
+		/// @brief Check if the chars are still valid. Always true outside of the engine loop.
+		bool IsAlive() const;
+
+		bool operator==(const String& obj) const;
+		bool operator==(std::u8string_view text) const;
+		bool operator==(const u8char* text) const;
+
+	private:
+		friend class String;
+
+		TransientString(const u8char* chars, int32 count, const FrameArena* arena, uint64 frameIndex);
+		/// @brief Holds a heap String, when there is no arena.
+		TransientString(String&& owned);
+
+		/// @brief Keeps the chars alive outside of the engine loop, empty otherwise.
+		String owned;
+		const u8char* chars;
+		int32 count;
+		/// @brief The arena holding the chars, nullptr if they are owned.
+		const FrameArena* arena = nullptr;
+		/// @brief The frame of the arena the chars were allocated in.
+		uint64 frameIndex = 0;
+	};
+
+	// Defined after TransientString, which it returns.
+	template<typename ... Ts>
+	TransientString String::FormatTransient(const String& format, const Ts& ... args) {
+		fmt::memory_buffer buffer;
+		fmt::format_to(buffer, format.GetStringView(), args...);
+		return CreateTransient(reinterpret_cast<const u8char*>(buffer.data()), static_cast<int32>(buffer.size()));
+	}
 }
 
 namespace fmt {
@@ -0,0 +1,116 @@
+#include "Engine/System/Thread/Fiber.h"
+#include "Engine/System/Memory/Memory.h"
+#include "Engine/System/Debug.h"
+
+#if defined(_WIN32)
+#	include "Engine/Platform/Windows/BetterWindows.h"
+#else
+#	include <ucontext.h>
+#endif
+
+// The thread sanitizer loses track of the stack on context switches unless told about them.
+#if defined(__SANITIZE_THREAD__)
+#	define FIBER_SANITIZE_THREAD 1
+#elif defined(__has_feature)
+#	if __has_feature(thread_sanitizer)
+#		define FIBER_SANITIZE_THREAD 1
+#	endif
+#endif
+
+#if FIBER_SANITIZE_THREAD
+extern "C" {
+	void* __tsan_get_current_fiber();
+	void* __tsan_create_fiber(unsigned flags);
+	void __tsan_destroy_fiber(void* fiber);
+	void __tsan_switch_to_fiber(void* fiber, unsigned flags);
+}
+#endif
+
+namespace Engine {
+	Fiber::Fiber(EntryFunction entry, void* argument, sizeint stackSize) :stackSize(stackSize), entry(entry), argument(argument) {
+#if defined(_WIN32)
+		context = ::CreateFiber(stackSize, [](LPVOID parameter) {
+			Start((Fiber*)parameter);
+		}, this);
+		FATAL_ASSERT(context != nullptr, u8"Failed to create a fiber.");
+#else
+		stack = Memory::Allocate(stackSize);
+		ucontext_t* native = (ucontext_t*)Memory::Allocate(sizeof(ucontext_t));
+		int result = getcontext(native);
+		FATAL_ASSERT(result == 0, u8"Failed to create a fiber.");
+		native->uc_stack.ss_sp = stack;
+		native->uc_stack.ss_size = stackSize;
+		native->uc_link = nullptr;
+
+		// makecontext only passes int arguments, split the pointer in two.
+		void (*start)(uint32, uint32) = [](uint32 high, uint32 low) {
+			Start((Fiber*)((((uint64)high) << 32) | low));
+		};
+		uint64 address = (uint64)this;
+		makecontext(native, (void (*)())start, 2, (uint32)(address >> 32), (uint32)address);
+		context = native;
+#endif
+#if FIBER_SANITIZE_THREAD
+		sanitizerFiber = __tsan_create_fiber(0);
+#endif
+	}
+	Fiber::~Fiber() {
+		// Converted threads own neither the stack nor, on Windows, the fiber handle.
+		bool converted = (stackSize == 0);
+#if FIBER_SANITIZE_THREAD
+		if (!converted) {
+			__tsan_destroy_fiber(sanitizerFiber);
+		}
+#endif
+#if defined(_WIN32)
+		if (!converted) {
+			::DeleteFiber(context);
+		}
+#else
+		Memory::Deallocate(context);
+		if (!converted) {
+			Memory::Deallocate(stack);
+		}
+#endif
+	}
+
+	Fiber* Fiber::ConvertThread() {
+		Fiber* fiber = MEMNEW(Fiber());
+#if defined(_WIN32)
+		fiber->context = ::ConvertThreadToFiber(nullptr);
+		FATAL_ASSERT(fiber->context != nullptr, u8"Failed to convert the thread to a fiber.");
+#else
+		// Filled in by the first switch away.
+		fiber->context = Memory::Allocate(sizeof(ucontext_t));
+#endif
+#if FIBER_SANITIZE_THREAD
+		fiber->sanitizerFiber = __tsan_get_current_fiber();
+#endif
+		return fiber;
+	}
+	void Fiber::RevertThread(Fiber* fiber) {
+#if defined(_WIN32)
+		::ConvertFiberToThread();
+#endif
+		MEMDEL(fiber);
+	}
+	void Fiber::Switch(Fiber* from, Fiber* to) {
+#if FIBER_SANITIZE_THREAD
+		__tsan_switch_to_fiber(to->sanitizerFiber, 0);
+#endif
+#if defined(_WIN32)
+		::SwitchToFiber(to->context);
+#else
+		swapcontext((ucontext_t*)from->context, (ucontext_t*)to->context);
+#endif
+	}
+
+	sizeint Fiber::GetStackSize() const {
+		return stackSize;
+	}
+
+	void Fiber::Start(Fiber* fiber) {
+		fiber->entry(fiber->argument);
+		FATAL_CRASH(u8"A fiber entry function returned.");
+	}
+}
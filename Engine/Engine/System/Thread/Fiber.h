@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Engine/System/Definition.h"
+
+namespace Engine {
+	/// @brief A user mode execution context with its own stack. Fibers switch cooperatively, never preemptively.\n
+	/// Backed by Win32 fibers on Windows and ucontext elsewhere.
+	/// A thread has to be converted with ConvertThread() before it can switch to a fiber.
+	class Fiber final {
+	public:
+		using EntryFunction = void (*)(void* argument);
+		static inline constexpr sizeint DefaultStackSize = 256 * 1024;
+
+		/// @brief Create a fiber which calls entry(argument) when first switched to.
+		/// @param entry Must never return, switch to another fiber instead.
+		Fiber(EntryFunction entry, void* argument, sizeint stackSize = DefaultStackSize);
+		~Fiber();
+
+		Fiber(const Fiber&) = delete;
+		Fiber& operator=(const Fiber&) = delete;
+
+		/// @brief Turn the calling thread into a fiber, so it can switch to others and be switched back to.
+		static Fiber* ConvertThread();
+		/// @brief Turn the calling thread back into a plain thread. Deletes the fiber from ConvertThread().
+		static void RevertThread(Fiber* fiber);
+		/// @brief Save the running context into from, then continue to.
+		/// @param from Must be the fiber currently running on the calling thread.
+		static void Switch(Fiber* from, Fiber* to);
+
+		sizeint GetStackSize() const;
+
+	private:
+		Fiber() = default;
+
+		static void Start(Fiber* fiber);
+
+		/// @brief The platform context. A fiber handle on Windows, a ucontext_t elsewhere.
+		void* context = nullptr;
+		/// @brief nullptr for converted threads, which run on their own stack.
+		void* stack = nullptr;
+		sizeint stackSize = 0;
+		EntryFunction entry = nullptr;
+		void* argument = nullptr;
+		/// @brief Fiber bookkeeping of the thread sanitizer, when enabled.
+		void* sanitizerFiber = nullptr;
+	};
+}
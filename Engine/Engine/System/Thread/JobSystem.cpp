@@ -2,71 +2,375 @@
 #include "Engine/System/String.h"
 
 namespace Engine {
+	static_assert(sizeof(Job) == ThreadUtil::CacheLineSize * 2, "Job is expected to fill exactly two cache lines.");
+
+	namespace {
+		void LockDependents(Job* job) {
+			while (job->dependentsLock.Exchange(true)) {
+				std::this_thread::yield();
+			}
+		}
+		void UnlockDependents(Job* job) {
+			job->dependentsLock.Set(false);
+		}
+		/// @brief The function of resume jobs, only compared by address to tell them apart from other jobs.\n
+		/// Workers switch to the fiber in the data instead, running it merely recycles the job.
+		void ResumeFiberJob(Job*) {}
+		JobSystem::Config MakeConfig(int32 workerCount, JobSystem::SchedulingMode mode, JobSystem::ExecutionMode execution) {
+			// The rest keeps its defaults, no pinning and no CPU list.
+			JobSystem::Config config{};
+			config.workerCount = workerCount;
+			config.scheduling = mode;
+			config.execution = execution;
+			return config;
+		}
+	}
+
+#pragma region JobPool
+	thread_local JobPool::LocalCache JobPool::localCache{};
+	std::atomic<uint64> JobPool::lastSerial{ 0 };
+
+	JobPool::JobPool() :serial(lastSerial.fetch_add(1, std::memory_order_relaxed) + 1) {}
+	JobPool::~JobPool() {
+		for (const auto& chunk : chunks) {
+			for (int32 i = 0; i < ChunkJobCount; i += 1) {
+				Memory::Destruct(chunk.jobs + i);
+			}
+			Memory::Deallocate(chunk.memory);
+		}
+		for (void* chunk : blockChunks) {
+			Memory::Deallocate(chunk);
+		}
+	}
+
+	Job* JobPool::Acquire() {
+		Job* job = GetLocalCache().jobs.Pop(freeJobs, [this](Job*& head, Job*& tail) {
+			return CarveChunk(head, tail);
+		});
+
+		job->nextFree = nullptr;
+		job->preference = Job::Preference::Null;
+		job->priority = Job::Priority::Normal;
+		job->submitted = false;
+		job->unfinishedPrerequisites.Set(1);
+		// Stale handles have already seen the generation bump by the time they can read this.
+		job->finished.Set(false);
+		return job;
+	}
+	void JobPool::Release(Job* job) {
+		job->generation.Add(1);
+		GetLocalCache().jobs.Push(freeJobs, job);
+	}
+	void JobPool::FlushLocalCache() {
+		GetLocalCache().jobs.Flush(freeJobs);
+	}
+
+	void* JobPool::AllocateBlock(sizeint size) {
+		sizeint total = size + sizeof(BlockHeader);
+		int32 sizeClass = 0;
+		while (sizeClass < BlockClassCount && (MinBlockSize << sizeClass) < total) {
+			sizeClass += 1;
+		}
+
+		BlockHeader* header = nullptr;
+		if (sizeClass >= BlockClassCount) {
+			header = (BlockHeader*)Memory::Allocate(total);
+			header->sizeClass = -1;
+			return header + 1;
+		}
+
+		freeBlocks[sizeClass].Take(1, header, [this, sizeClass](BlockHeader*& head, BlockHeader*& tail) {
+			return CarveBlocks(sizeClass, head, tail);
+		});
+		header->sizeClass = sizeClass;
+		return header + 1;
+	}
+	void JobPool::DeallocateBlock(void* block) {
+		BlockHeader* header = (BlockHeader*)block - 1;
+		if (header->sizeClass < 0) {
+			Memory::Deallocate(header);
+			return;
+		}
+		freeBlocks[header->sizeClass].Push(header, header, 1);
+	}
+
+	int32 JobPool::GetCapacity() const {
+		return GetChunkCount() * ChunkJobCount;
+	}
+	int32 JobPool::GetChunkCount() const {
+		auto lock = SimpleLock<Mutex>(mutex);
+		return chunks.GetCount();
+	}
+
+	JobPool::LocalCache& JobPool::GetLocalCache() {
+		if (localCache.serial != serial) {
+			// Left over by another pool. Its jobs stay in its chunks and are freed along with it.
+			localCache.serial = serial;
+			localCache.jobs.Reset();
+		}
+		return localCache;
+	}
+	int32 JobPool::CarveChunk(Job*& head, Job*& tail) {
+		void* memory = Memory::Allocate(sizeof(Job) * ChunkJobCount + ThreadUtil::CacheLineSize);
+		Job* jobs = (Job*)(((uintptr_t)memory + ThreadUtil::CacheLineSize - 1) & ~(uintptr_t)(ThreadUtil::CacheLineSize - 1));
+		for (int32 i = 0; i < ChunkJobCount; i += 1) {
+			Memory::Construct(jobs + i);
+		}
+		{
+			auto lock = SimpleLock<Mutex>(mutex);
+			chunks.Add(Chunk{ memory, jobs });
+		}
+		return SharedFreeList<Job, &Job::nextFree>::LinkBlocks(jobs, sizeof(Job), ChunkJobCount, head, tail);
+	}
+	int32 JobPool::CarveBlocks(int32 sizeClass, BlockHeader*& head, BlockHeader*& tail) {
+		sizeint blockSize = MinBlockSize << sizeClass;
+		byte* chunk = (byte*)Memory::Allocate(blockSize * ChunkBlockCount);
+		{
+			auto lock = SimpleLock<Mutex>(blockMutex);
+			blockChunks.Add(chunk);
+		}
+		return SharedFreeList<BlockHeader, &BlockHeader::nextFree>::LinkBlocks(chunk, blockSize, ChunkBlockCount, head, tail);
+	}
+#pragma endregion
+
 #pragma region JobWorker
-	JobWorker::JobWorker(JobSystem* manager, int32 id) :manager(manager), id(id) {}
+	thread_local JobWorker* JobWorker::current = nullptr;
+
+#if defined(_MSC_VER)
+	__declspec(noinline)
+#else
+	__attribute__((noinline))
+#endif
+	JobWorker* JobWorker::GetCurrent() {
+		return current;
+	}
+
+	JobWorker::JobWorker(JobSystem* manager, int32 id) :manager(manager), stealSeed(static_cast<uint32>(id) * 2654435761u + 1), id(id) {}
 
 	void JobWorker::Start() {
-		shouldRun = true;
+		shouldRun.Set(true);
+		running.Set(true);
 
 		thread = std::thread(ThreadFunction, this);
 		thread.detach();
 	}
 	void JobWorker::RequireStop() {
-		shouldRun = false;
+		shouldRun.Set(false);
 	}
 
 	void JobWorker::ThreadFunction(JobWorker* worker) {
-		worker->running = true;
+		current = worker;
+		ThreadUtil::SetCurrentThreadName(worker->name.GetRawArray());
+		if (worker->cpu >= 0 && !ThreadUtil::SetCurrentThreadAffinity(worker->cpu)) {
+			WARN_MSG(String::Format(STRL("Failed to pin job worker {0} to CPU {1}."), worker->id, worker->cpu).GetRawArray());
+		}
 		//INFO_MSG(String::Format(STRL("Job worker {0} started."), worker->id).GetRawArray());
 
-		SharedPtr<Job> job;
+		JobSystem* manager = worker->manager;
+		if (manager->execution == JobSystem::ExecutionMode::Fiber) {
+			worker->schedulerFiber = Fiber::ConvertThread();
+		}
+
+		Job* job = nullptr;
 		while (worker->ShouldRun()) {
+			job = worker->GetJob();
 			if (job != nullptr) {
-				RunJob(job);
-				job = SharedPtr<Job>(nullptr);
+				manager->RunJobOnWorker(worker, job);
+				continue;
 			}
 
 			{
-				auto lock = AdvanceLock<Mutex>(worker->manager->jobsCondMutex);
-				worker->manager->jobsCond.wait(lock, [worker, &job]() {
-					if (!worker->ShouldRun()) {
-						return true;
+				auto lock = AdvanceLock<Mutex>(manager->jobsCondMutex);
+				manager->sleepingWorkers.fetch_add(1, std::memory_order_seq_cst);
+				while (worker->ShouldRun()) {
+					job = worker->GetJob();
+					if (job != nullptr) {
+						break;
 					}
-					if (job == nullptr) {
-						job = worker->GetJob();
+					int64 deadline = manager->frameDeadline.load(std::memory_order_relaxed);
+					if (worker->deferredBackground && deadline != JobSystem::NoFrameDeadline) {
+						// Nobody notifies when the held back jobs become available, wake up at the deadline.
+						manager->jobsCond.wait_until(lock, JobSystem::Clock::time_point(JobSystem::Clock::duration(deadline)));
+					} else {
+						manager->jobsCond.wait(lock);
 					}
-					return job != nullptr;
-				});
+				}
+				manager->sleepingWorkers.fetch_sub(1, std::memory_order_relaxed);
+			}
+
+			if (job != nullptr) {
+				manager->RunJobOnWorker(worker, job);
 			}
 		}
 
 		//INFO_MSG(String::Format(STRL("Job worker {0} stopped."), worker->id).GetRawArray());
-		worker->running = false;
-	}
-	void JobWorker::RunJob(SharedPtr<Job>& job) {
-		job->function(job.GetRaw());
-		job->finished = true;
+		if (worker->schedulerFiber != nullptr) {
+			Fiber::RevertThread(worker->schedulerFiber);
+			worker->schedulerFiber = nullptr;
+		}
+		manager->jobPool.FlushLocalCache();
+		current = nullptr;
+		worker->running.Set(false);
 	}
-	SharedPtr<Job> JobWorker::GetJob() {
+	Job* JobWorker::GetJob() {
 		{
 			auto lock = SimpleLock<Mutex>(exclusiveJobMutex);
-			if (exclusiveJobs.GetCount() > 0) {
-				auto job = exclusiveJobs.Get(exclusiveJobs.GetCount() - 1);
-				exclusiveJobs.RemoveAt(exclusiveJobs.GetCount() - 1);
+			Job* job = nullptr;
+			if (exclusiveJobs.TryPopFront(job)) {
 				return job;
 			}
 		}
-		return manager->GetJob();
+
+		constexpr int32 background = static_cast<int32>(Job::Priority::Background);
+		bool allowBackground = !manager->IsNearFrameDeadline();
+		deferredBackground = !allowBackground;
+
+		// A lane passed over too many times goes first once, lowest lane first.
+		int32 limit = manager->starvationLimit.load(std::memory_order_relaxed);
+		int32 first = 0;
+		if (limit > 0) {
+			for (int32 lane = Job::PriorityCount - 1; lane > 0; lane -= 1) {
+				if (passedOver[lane] >= limit && (lane != background || allowBackground)) {
+					// Reset even if the lane turns out empty, it only deserves a turn when it has work.
+					passedOver[lane] = 0;
+					first = lane;
+					break;
+				}
+			}
+		}
+
+		for (int32 i = 0; i < Job::PriorityCount; i += 1) {
+			int32 lane = (i == 0 ? first : (i <= first ? i - 1 : i));
+			if (lane == background && !allowBackground) {
+				continue;
+			}
+
+			Job* job = TakeJob(lane);
+			if (job != nullptr) {
+				passedOver[lane] = 0;
+				for (int32 lower = lane + 1; lower < Job::PriorityCount; lower += 1) {
+					passedOver[lower] += 1;
+				}
+				return job;
+			}
+		}
+		return nullptr;
+	}
+	Job* JobWorker::TakeJob(int32 lane) {
+		if (manager->mode == JobSystem::SchedulingMode::SharedQueue) {
+			return manager->GetJob(lane);
+		}
+
+		// Local jobs first, they are the hottest in cache.
+		Job* job = nullptr;
+		if (localJobs[lane].TryPop(job)) {
+			return job;
+		}
+
+		// Then jobs injected from outside.
+		job = manager->GetJob(lane);
+		if (job != nullptr) {
+			return job;
+		}
+
+		return StealFromOthers(lane);
 	}
-	void JobWorker::AddExclusiveJob(SharedPtr<Job> job) {
+	void JobWorker::AddExclusiveJob(Job* job) {
 		auto lock = SimpleLock<Mutex>(exclusiveJobMutex);
-		exclusiveJobs.Add(job);
+		exclusiveJobs.PushBack(job);
+	}
+	void JobWorker::PushLocalJob(Job* job) {
+		localJobs[static_cast<int32>(job->priority)].Push(job);
+	}
+	Job* JobWorker::StealJob(int32 lane) {
+		Job* job = nullptr;
+		if (localJobs[lane].TrySteal(job)) {
+			return job;
+		}
+		return nullptr;
+	}
+	Job* JobWorker::TakeOwnJob() {
+		{
+			auto lock = SimpleLock<Mutex>(exclusiveJobMutex);
+			Job* job = nullptr;
+			if (exclusiveJobs.TryPopFront(job)) {
+				return job;
+			}
+		}
+
+		for (int32 lane = 0; lane < Job::PriorityCount; lane += 1) {
+			Job* job = nullptr;
+			if (manager->mode == JobSystem::SchedulingMode::SharedQueue) {
+				job = manager->GetJob(lane);
+			} else {
+				localJobs[lane].TryPop(job);
+			}
+			if (job != nullptr) {
+				return job;
+			}
+		}
+		return nullptr;
+	}
+	bool JobWorker::HasOwnJob() const {
+		{
+			auto lock = SimpleLock<Mutex>(exclusiveJobMutex);
+			if (exclusiveJobs.GetCount() > 0) {
+				return true;
+			}
+		}
+
+		if (manager->mode == JobSystem::SchedulingMode::SharedQueue) {
+			auto lock = SimpleLock<Mutex>(manager->jobsMutex);
+			for (int32 lane = 0; lane < Job::PriorityCount; lane += 1) {
+				if (manager->jobs[lane].GetCount() > 0) {
+					return true;
+				}
+			}
+			return false;
+		}
+		for (int32 lane = 0; lane < Job::PriorityCount; lane += 1) {
+			if (!localJobs[lane].IsEmpty()) {
+				return true;
+			}
+		}
+		return false;
+	}
+	Job* JobWorker::StealFromOthers(int32 lane) {
+		int32 count = manager->workers.GetCount();
+		if (count <= 1) {
+			return nullptr;
+		}
+
+		// Start from a random victim so thieves don't all line up on the same worker.
+		stealSeed ^= stealSeed << 13;
+		stealSeed ^= stealSeed >> 17;
+		stealSeed ^= stealSeed << 5;
+		int32 start = static_cast<int32>(stealSeed % static_cast<uint32>(count));
+
+		// Same node first, a steal across nodes drags the job's data over the interconnect.
+		int32 passes = manager->numaAware ? 2 : 1;
+		for (int32 pass = 0; pass < passes; pass += 1) {
+			for (int32 i = 0; i < count; i += 1) {
+				JobWorker* victim = manager->workers.Get((start + i) % count).GetRaw();
+				if (victim == this) {
+					continue;
+				}
+				if (manager->numaAware && (victim->numaNode == numaNode) != (pass == 0)) {
+					continue;
+				}
+				Job* job = victim->StealJob(lane);
+				if (job != nullptr) {
+					return job;
+				}
+			}
+		}
+		return nullptr;
 	}
 	bool JobWorker::ShouldRun() const {
-		return shouldRun;
+		return shouldRun.Get();
 	}
 	bool JobWorker::IsRunning() const {
-		return running;
+		return running.Get();
 	}
 
 	int32 JobWorker::GetId() const {
@@ -75,19 +379,56 @@ namespace Engine {
 #pragma endregion
 
 #pragma region JobSystem
-	JobSystem::JobSystem() {
+	JobSystem::JobSystem(int32 workerCount, SchedulingMode mode, ExecutionMode execution) :JobSystem(MakeConfig(workerCount, mode, execution)) {}
+	JobSystem::JobSystem(const Config& config) :mode(config.scheduling), execution(config.execution) {
+		int32 workerCount = config.workerCount;
 		int32 hardware = ThreadUtil::GetHardwareThreadCount();
-		INFO_MSG(String::Format(STRING_LITERAL("{0} hardware threads, creating {1} job workers."), hardware, hardware - 1).GetRawArray());
+		if (workerCount < 0) {
+			workerCount = hardware - 1;
+		}
+		// Jobs would never run without a worker.
+		if (workerCount < 1) {
+			workerCount = 1;
+		}
+		INFO_MSG(String::Format(STRING_LITERAL("{0} hardware threads, creating {1} job workers."), hardware, workerCount).GetRawArray());
 		//INFO_MSG(String::Format(STRING_LITERAL("L1 cache line size: {0} bytes."), CacheLineSize).GetRawArray());
 		INFO_MSG(String::Format(STRING_LITERAL("Job struct size: {0} bytes."), sizeof(Job)).GetRawArray());
 
 		preferenceToWorker.Add(Job::Preference::Window, 0);
 
-		for (int32 i = 0; i < hardware - 1; i += 1) {
+		String threadName = String(config.threadName);
+		for (int32 i = 0; i < workerCount; i += 1) {
 			lastId += 1;
 			auto worker = SharedPtr<JobWorker>::Create(this,lastId);
+			worker->name = String::Format(STRL("{0} {1}"), threadName, lastId);
+			if (config.pinThreads) {
+				if (config.cpus.GetCount() > 0) {
+					worker->cpu = config.cpus.Get(i % config.cpus.GetCount());
+				} else {
+					worker->cpu = (hardware > 1 ? 1 + i % (hardware - 1) : 0);
+				}
+				if (config.numaAware) {
+					worker->numaNode = ThreadUtil::GetCpuNumaNode(worker->cpu);
+					// Only worth the second steal pass if the workers really span several nodes.
+					if (i > 0 && worker->numaNode != workers.Get(0)->numaNode) {
+						numaAware = true;
+					}
+				}
+			}
 			workers.Add(worker);
 		}
+		if (numaAware) {
+			INFO_MSG(String::Format(STRL("Job workers span {0} NUMA nodes, stealing within the node first."), ThreadUtil::GetNumaNodeCount()).GetRawArray());
+		}
+	}
+	JobSystem::~JobSystem() {
+		if (running) {
+			Stop();
+		}
+		// Fibers still suspended here are dropped without unwinding their stacks.
+		for (JobFiber* fiber : fibers) {
+			MEMDEL(fiber);
+		}
 	}
 
 	void JobSystem::Start() {
@@ -107,7 +448,10 @@ namespace Engine {
 		bool stop = true;
 		do {
 			stop = true;
-			jobsCond.notify_all();
+			{
+				auto lock = SimpleLock<Mutex>(jobsCondMutex);
+				jobsCond.notify_all();
+			}
 
 			for (const auto& worker : workers) {
 				if (worker->IsRunning()) {
@@ -120,65 +464,452 @@ namespace Engine {
 		running = false;
 	}
 
-	SharedPtr<Job> JobSystem::AddJob(Job::WorkFunction function,void* data,sizeint dataLength,Job::Preference preference) {
+	JobHandle JobSystem::AddJob(Job::WorkFunction function,void* data,sizeint dataLength,Job::Preference preference,Job::Priority priority) {
+		JobHandle handle = CreateJob(function, data, dataLength, preference, priority);
+		Job* job = handle.job;
+		job->submitted = true;
+		job->unfinishedPrerequisites.Set(0);
+		Schedule(job);
+		return handle;
+	}
+	JobHandle JobSystem::CreateJob(Job::WorkFunction function, void* data, sizeint dataLength, Job::Preference preference, Job::Priority priority) {
 		if (data != nullptr) {
 			FATAL_ASSERT(dataLength <= Job::DataLength, u8"data is too large to put into a job! Consider putting a pointer to the actual data.");
 		}
 
 		// Prepare job
-		auto job = SharedPtr<Job>::Create();
+		Job* job = jobPool.Acquire();
 		job->function = function;
+		job->preference = preference;
+		job->priority = priority;
 		if (data != nullptr) {
-			for (sizeint i = 0; i < dataLength; i += 1) {
-				job->data[i] = ((byte*)data)[i];
-			}
+			std::memcpy(job->data, data, dataLength);
+		}
+		return JobHandle(job, job->generation.Get());
+	}
+	void JobSystem::AddDependency(JobHandle job, JobHandle prerequisite) {
+		ERR_ASSERT(job.IsValid() && prerequisite.IsValid(), u8"job and prerequisite must not be null.", return);
+		ERR_ASSERT(job.job->generation.Get() == job.generation && !job.job->submitted, u8"Cannot add dependencies to a submitted job.", return);
+		ERR_ASSERT(job != prerequisite, u8"A job cannot depend on itself.", return);
+
+		job.job->unfinishedPrerequisites.Add(1);
+
+		// A stale handle means the prerequisite has finished and its slot went back to the pool.
+		LockDependents(prerequisite.job);
+		bool finished = prerequisite.IsFinished();
+		if (!finished) {
+			prerequisite.job->dependents.Add(job.job);
+		}
+		UnlockDependents(prerequisite.job);
+
+		// The submit hold keeps the counter above zero, so no need to schedule here.
+		if (finished) {
+			job.job->unfinishedPrerequisites.Subtract(1);
 		}
+	}
+	void JobSystem::Submit(JobHandle job) {
+		ERR_ASSERT(job.IsValid(), u8"job must not be null.", return);
+		ERR_ASSERT(job.job->generation.Get() == job.generation && !job.job->submitted, u8"The job is already submitted.", return);
 
+		job.job->submitted = true;
+		if (job.job->unfinishedPrerequisites.Subtract(1) == 0) {
+			Schedule(job.job);
+		}
+	}
+	void JobSystem::SubmitNextFrame(JobHandle job) {
+		ERR_ASSERT(job.IsValid(), u8"job must not be null.", return);
+		ERR_ASSERT(job.job->generation.Get() == job.generation && !job.job->submitted, u8"The job is already submitted.", return);
+
+		auto lock = SimpleLock<Mutex>(nextFrameMutex);
+		nextFrameJobs.Add(job);
+	}
+	void JobSystem::AdvanceFrame() {
+		// Jobs added for the next frame while these run wait for the following one.
+		auto lock = SimpleLock<Mutex>(nextFrameMutex);
+		for (JobHandle job : nextFrameJobs) {
+			Submit(job);
+		}
+		nextFrameJobs.Clear();
+	}
+	JobHandle JobSystem::AddContinuation(JobHandle prerequisite, Job::WorkFunction function, void* data, sizeint dataLength, Job::Preference preference, Job::Priority priority) {
+		JobHandle job = CreateJob(function, data, dataLength, preference, priority);
+		AddDependency(job, prerequisite);
+		Submit(job);
+		return job;
+	}
+	void JobSystem::Schedule(Job* job) {
 		// Exclusive job targeting
 		int32 worker = -1;
-		if (preference != Job::Preference::Null) {
-			preferenceToWorker.TryGet(preference, worker);
+		if (job->preference != Job::Preference::Null) {
+			preferenceToWorker.TryGet(job->preference, worker);
 		}
-		
+
 		// Add job
-		if (worker < 0) {
-			auto lock = SimpleLock<Mutex>(jobsMutex);
-			jobs.Add(job);
-		} else if (worker < workers.GetCount()) {
+		if (worker >= 0) {
+			FATAL_ASSERT(worker < workers.GetCount(), u8"PreferenceToWorker map error! Trying to add exclusive work to unexisting worker!");
 			workers.Get(worker)->AddExclusiveJob(job);
+			// Only the targeted worker can take it, so wake up everyone.
+			NotifyWorkers(true);
+			// It may be blocked waiting on a job which needs this one.
+			NotifyWaiters();
+			return;
+		}
+
+		JobWorker* local = JobWorker::GetCurrent();
+		if (mode == SchedulingMode::WorkStealing && local != nullptr && local->manager == this) {
+			local->PushLocalJob(job);
 		} else {
-			FATAL_CRASH(u8"PreferenceToWorker map error! Trying to add exclusive work to unexisting worker!");
+			auto lock = SimpleLock<Mutex>(jobsMutex);
+			jobs[static_cast<int32>(job->priority)].PushBack(job);
+		}
+		NotifyWorkers(false);
+		if (mode == SchedulingMode::SharedQueue) {
+			// The shared queue is every worker's own in this mode, see JobWorker::TakeOwnJob().
+			NotifyWaiters();
 		}
+	}
+	void JobSystem::RunJob(Job* job) {
+		job->function(job);
 
-		{
-			auto lock = SimpleLock<Mutex>(jobsCondMutex);
-			jobsCond.notify_all();
+		// Mark finished under the lock, so AddDependency either sees the job finished or gets released here.
+		// Nobody adds to the dependents afterwards.
+		LockDependents(job);
+		job->finished.Set(true);
+		UnlockDependents(job);
+		NotifyWaiters();
+
+		for (Job* dependent : job->dependents) {
+			if (dependent->unfinishedPrerequisites.Subtract(1) == 0) {
+				Schedule(dependent);
+			}
 		}
-		return job;
+		job->dependents.Clear();
+
+		jobPool.Release(job);
+	}
+	void JobSystem::RunJobOnWorker(JobWorker* worker, Job* job) {
+		if (execution == ExecutionMode::Thread) {
+			RunJob(job);
+			return;
+		}
+
+		JobFiber* fiber = nullptr;
+		if (job->function == ResumeFiberJob) {
+			std::memcpy(&fiber, job->data, sizeof(fiber));
+			// Nothing depends on resume jobs, this only recycles it.
+			RunJob(job);
+		} else {
+			fiber = AcquireFiber();
+			fiber->job = job;
+		}
+
+		worker->currentFiber = fiber;
+		Fiber::Switch(worker->schedulerFiber, &fiber->fiber);
+		worker->currentFiber = nullptr;
+
+		// Back on the worker, the fiber has either finished its job or suspended.
+		if (fiber->job == nullptr) {
+			ReleaseFiber(fiber);
+		}
+		if (worker->pendingResume != nullptr) {
+			Job* resume = worker->pendingResume;
+			worker->pendingResume = nullptr;
+			Submit(JobHandle(resume, resume->generation.Get()));
+		}
+	}
+	bool JobSystem::SuspendFiber(const JobHandle& job) {
+		JobWorker* worker = JobWorker::GetCurrent();
+		if (execution != ExecutionMode::Fiber || worker == nullptr || worker->manager != this || worker->currentFiber == nullptr) {
+			return false;
+		}
+		if (job.IsFinished()) {
+			return true;
+		}
+
+		JobFiber* fiber = worker->currentFiber;
+		// Keep the lane and the exclusive worker of the suspended job.
+		JobHandle resume = CreateJob(ResumeFiberJob, &fiber, sizeof(fiber), fiber->job->preference, fiber->job->priority);
+		AddDependency(resume, job);
+		// Submitting here could let another worker resume the fiber while it is still running on this one.
+		worker->pendingResume = resume.job;
+		Fiber::Switch(&fiber->fiber, worker->schedulerFiber);
+		return true;
+	}
+	JobFiber* JobSystem::AcquireFiber() {
+		auto lock = SimpleLock<Mutex>(fiberMutex);
+		if (freeFibers.GetCount() > 0) {
+			JobFiber* fiber = freeFibers.Get(freeFibers.GetCount() - 1);
+			freeFibers.RemoveAt(freeFibers.GetCount() - 1);
+			return fiber;
+		}
+		JobFiber* fiber = MEMNEW(JobFiber(this, RunFiber));
+		fibers.Add(fiber);
+		return fiber;
 	}
-	SharedPtr<Job> JobSystem::GetJob() {
+	void JobSystem::ReleaseFiber(JobFiber* fiber) {
+		auto lock = SimpleLock<Mutex>(fiberMutex);
+		freeFibers.Add(fiber);
+	}
+	void JobSystem::RunFiber(void* argument) {
+		JobFiber* fiber = (JobFiber*)argument;
+		while (true) {
+			fiber->system->RunJob(fiber->job);
+			fiber->job = nullptr;
+			// Possibly not the worker which started the job.
+			Fiber::Switch(&fiber->fiber, JobWorker::GetCurrent()->schedulerFiber);
+		}
+	}
+	Job* JobSystem::GetJob(int32 lane) {
 		auto lock = SimpleLock<Mutex>(jobsMutex);
 
-		if (jobs.GetCount()>0) {
-			auto job = jobs.Get(jobs.GetCount() - 1);
-			jobs.RemoveAt(jobs.GetCount() - 1);
-			return job;
+		Job* job = nullptr;
+		jobs[lane].TryPopFront(job);
+		return job;
+	}
+	void JobSystem::NotifyWorkers(bool all) {
+		// Pairs with the increment of sleepingWorkers in JobWorker::ThreadFunction.
+		// Either the sleeper sees the new job, or we see the sleeper.
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (sleepingWorkers.load(std::memory_order_relaxed) <= 0) {
+			return;
+		}
+
+		auto lock = SimpleLock<Mutex>(jobsCondMutex);
+		if (all) {
+			jobsCond.notify_all();
 		} else {
-			return SharedPtr<Job>(nullptr);
+			jobsCond.notify_one();
+		}
+	}
+	void JobSystem::NotifyWaiters() {
+		// Pairs with the increment of blockedWaiters in BlockWait.
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (blockedWaiters.load(std::memory_order_relaxed) > 0) {
+			auto lock = SimpleLock<Mutex>(finishedMutex);
+			finishedCond.notify_all();
 		}
 	}
 	bool JobSystem::IsRunning() const {
 		return running;
 	}
+	JobSystem::SchedulingMode JobSystem::GetSchedulingMode() const {
+		return mode;
+	}
+	JobSystem::ExecutionMode JobSystem::GetExecutionMode() const {
+		return execution;
+	}
+	int32 JobSystem::GetFiberCount() const {
+		auto lock = SimpleLock<Mutex>(fiberMutex);
+		return fibers.GetCount();
+	}
+	int32 JobSystem::GetWorkerCount() const {
+		return workers.GetCount();
+	}
+	int32 JobSystem::GetWorkerCpu(int32 worker) const {
+		ERR_ASSERT(worker >= 0 && worker < workers.GetCount(), u8"worker out of bounds.", return -1);
+		return workers.Get(worker)->cpu;
+	}
+	int32 JobSystem::GetWorkerNumaNode(int32 worker) const {
+		ERR_ASSERT(worker >= 0 && worker < workers.GetCount(), u8"worker out of bounds.", return 0);
+		return workers.Get(worker)->numaNode;
+	}
+	const JobPool& JobSystem::GetJobPool() const {
+		return jobPool;
+	}
+
+	void JobSystem::SetStarvationLimit(int32 limit) {
+		starvationLimit.store(limit > 0 ? limit : 0, std::memory_order_relaxed);
+	}
+	int32 JobSystem::GetStarvationLimit() const {
+		return starvationLimit.load(std::memory_order_relaxed);
+	}
+	void JobSystem::SetFrameDeadline(Clock::time_point deadline) {
+		frameDeadline.store(deadline.time_since_epoch().count(), std::memory_order_relaxed);
+	}
+	void JobSystem::ClearFrameDeadline() {
+		frameDeadline.store(NoFrameDeadline, std::memory_order_relaxed);
+		// Workers holding background jobs back may sleep until the old deadline.
+		NotifyWorkers(true);
+	}
+	void JobSystem::SetFrameDeadlineMargin(Clock::duration margin) {
+		frameDeadlineMargin.store(margin.count(), std::memory_order_relaxed);
+	}
+	JobSystem::Clock::duration JobSystem::GetFrameDeadlineMargin() const {
+		return Clock::duration(frameDeadlineMargin.load(std::memory_order_relaxed));
+	}
+	bool JobSystem::IsNearFrameDeadline() const {
+		int64 deadline = frameDeadline.load(std::memory_order_relaxed);
+		if (deadline == NoFrameDeadline) {
+			return false;
+		}
+		int64 now = Clock::now().time_since_epoch().count();
+		return now < deadline && now >= deadline - frameDeadlineMargin.load(std::memory_order_relaxed);
+	}
 
-	void JobSystem::WaitJob(SharedPtr<Job> job) {
-		while (!job->finished) {
+	thread_local int32 JobSystem::waitHelpDepth = 0;
+
+	void JobSystem::WaitJob(JobHandle job, WaitStrategy strategy) {
+		ERR_ASSERT(job.IsValid(), u8"job must not be nullptr.", return);
+
+		if (strategy == WaitStrategy::Adaptive && SuspendFiber(job)) {
+			return;
+		}
+		Wait([](const void* context) {
+			return ((const JobHandle*)context)->IsFinished();
+		}, &job, strategy);
+	}
+	void JobSystem::Wait(WaitCondition condition, const void* context, WaitStrategy strategy) {
+		switch (strategy) {
+			case WaitStrategy::Spin:
+				while (!condition(context)) {
+					ThreadUtil::Pause();
+				}
+				return;
+			case WaitStrategy::SpinYield:
+				while (!SpinWait(condition, context, WaitSpinCount, WaitYieldCount)) {}
+				return;
+			case WaitStrategy::Block:
+				BlockWait(condition, context, false);
+				return;
+			case WaitStrategy::Adaptive:
+				break;
+		}
+
+		while (!condition(context)) {
 			// Help run jobs when waiting.
-			//auto job = GetJob();
-			//if (job!=nullptr) {
-			//	JobWorker::RunJob(job);
-			//}
+			Job* other = waitHelpDepth < MaxWaitHelpDepth ? GetJobForWaiter() : nullptr;
+			if (other == nullptr) {
+				// Too deep or nothing else to do, but jobs of this worker may have nobody else to run them.
+				other = GetOwnJobForWaiter();
+			}
+			if (other != nullptr && other->function == ResumeFiberJob) {
+				// Only a worker can switch to a fiber, give it back.
+				Schedule(other);
+			} else if (other != nullptr) {
+				waitHelpDepth += 1;
+				RunJob(other);
+				waitHelpDepth -= 1;
+				continue;
+			}
+
+			// Nothing to help with, the job is running somewhere else.
+			if (SpinWait(condition, context, WaitSpinCount, WaitYieldCount)) {
+				return;
+			}
+			// Wakes up for new jobs of this worker too, it must not sleep on a job routed to it.
+			BlockWait(condition, context, true);
 		}
 	}
+	Job* JobSystem::GetJobForWaiter() {
+		JobWorker* local = JobWorker::GetCurrent();
+		if (local != nullptr && local->manager == this) {
+			return local->GetJob();
+		}
+
+		// Not a worker, frame deadlines don't apply. The waiter may well be waiting on a background job.
+		for (int32 lane = 0; lane < Job::PriorityCount; lane += 1) {
+			Job* job = GetJob(lane);
+			if (job != nullptr) {
+				return job;
+			}
+			if (mode != SchedulingMode::WorkStealing) {
+				continue;
+			}
+			for (const auto& worker : workers) {
+				job = worker->StealJob(lane);
+				if (job != nullptr) {
+					return job;
+				}
+			}
+		}
+		return nullptr;
+	}
+	Job* JobSystem::GetOwnJobForWaiter() {
+		JobWorker* local = JobWorker::GetCurrent();
+		if (local != nullptr && local->manager == this) {
+			return local->TakeOwnJob();
+		}
+		return nullptr;
+	}
+	bool JobSystem::SpinWait(WaitCondition condition, const void* context, int32 spinCount, int32 yieldCount) {
+		for (int32 i = 0; i < spinCount; i += 1) {
+			if (condition(context)) {
+				return true;
+			}
+			ThreadUtil::Pause();
+		}
+		for (int32 i = 0; i < yieldCount; i += 1) {
+			if (condition(context)) {
+				return true;
+			}
+			std::this_thread::yield();
+		}
+		return condition(context);
+	}
+	void JobSystem::BlockWait(WaitCondition condition, const void* context, bool wakeForOwnJobs) {
+		JobWorker* local = JobWorker::GetCurrent();
+		if (!wakeForOwnJobs || local == nullptr || local->manager != this) {
+			local = nullptr;
+		}
+
+		auto lock = AdvanceLock<Mutex>(finishedMutex);
+		blockedWaiters.fetch_add(1, std::memory_order_seq_cst);
+		finishedCond.wait(lock, [condition, context, local]() {
+			return condition(context) || (local != nullptr && local->HasOwnJob());
+		});
+		blockedWaiters.fetch_sub(1, std::memory_order_relaxed);
+	}
+
+	int32 JobSystem::GetParallelGrain(int32 count, int32 grain) const {
+		if (grain > 0) {
+			return grain;
+		}
+		// The calling thread takes part as well.
+		int32 pieces = (workers.GetCount() + 1) * ParallelPiecesPerWorker;
+		return count > pieces ? (count - 1) / pieces + 1 : 1;
+	}
+	void JobSystem::RunParallel(ParallelRange& range, int32 begin, int32 end, int32 grain) {
+		range.grain = GetParallelGrain(end - begin, grain);
+		range.remaining.Set(end - begin);
+		range.completion = CreateJob([](Job*) {});
+
+		RunParallelRange(&range, begin, end);
+		// A job to wait for lets a fiber suspend instead of spinning.
+		WaitJob(range.completion);
+	}
+	void JobSystem::RunParallelRange(ParallelRange* range, int32 begin, int32 end) {
+		int32 processed = 0;
+		while (begin < end) {
+			if (end - begin > range->grain && ShouldSplitParallelRange()) {
+				int32 middle = begin + (end - begin) / 2;
+				ParallelRangeData data{ this, range, middle, end };
+				AddJob(RunParallelRangeJob, &data, sizeof(data));
+				end = middle;
+				continue;
+			}
+
+			int32 pieceEnd = end - begin > range->grain ? begin + range->grain : end;
+			range->function(range->context, begin, pieceEnd);
+			processed += pieceEnd - begin;
+			begin = pieceEnd;
+		}
+		// The caller may return as soon as the completion runs, don't touch the range after this.
+		JobHandle completion = range->completion;
+		if (range->remaining.Subtract(processed) == 0) {
+			Submit(completion);
+		}
+	}
+	bool JobSystem::ShouldSplitParallelRange() const {
+		// Only a worker's own deque tells if thieves are starving, split eagerly everywhere else.
+		JobWorker* local = JobWorker::GetCurrent();
+		if (mode != SchedulingMode::WorkStealing || local == nullptr || local->manager != this) {
+			return true;
+		}
+		return local->localJobs[static_cast<int32>(Job::Priority::Normal)].IsEmpty();
+	}
+	void JobSystem::RunParallelRangeJob(Job* job) {
+		volatile ParallelRangeData* data = job->GetDataAs<ParallelRangeData>();
+		data->system->RunParallelRange(data->range, data->begin, data->end);
+	}
 #pragma endregion
 }
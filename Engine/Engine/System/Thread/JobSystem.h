@@ -1,10 +1,22 @@
 #pragma once
 #include "Engine/System/Definition.h"
+#include "Engine/System/Concept.h"
+#include "Engine/System/String.h"
 #include "Engine/System/Collection/List.h"
 #include "Engine/System/Collection/Dictionary.h"
+#include "Engine/System/Collection/Deque.h"
 #include "Engine/System/Memory/SharedPtr.h"
+#include "Engine/System/Memory/FreeList.h"
 #include "Engine/System/Thread/ThreadUtil.h"
+#include "Engine/System/Thread/WorkStealingQueue.h"
+#include "Engine/System/Thread/Fiber.h"
 #include <thread>
+#include <chrono>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <cstring>
 
 #undef GetJob
 
@@ -12,23 +24,182 @@ namespace Engine {
 	class JobSystem;
 	class JobWorker;
 	struct Job;
+	template<typename T>
+	class JobFuture;
 
-	struct Job {
+	struct alignas(ThreadUtil::CacheLineSize) Job {
 		using WorkFunction = void (*)(Job* job);
-		static inline constexpr sizeint DataLength = 64 - 8 - 1;
+		static inline constexpr sizeint DataAlignment = 16;
+		static inline constexpr sizeint DataLength = (ThreadUtil::CacheLineSize * 2 - sizeof(WorkFunction) - sizeof(Job*) - sizeof(List<Job*>) - sizeof(AtomicValue<int32>) - sizeof(AtomicValue<uint32>) - 5) / DataAlignment * DataAlignment;
 		enum class Preference :byte {
 			Null,
 			Window
 		};
+		/// @brief Scheduling lanes. Workers drain higher lanes first.
+		enum class Priority :byte {
+			/// @brief Work the current frame waits on.
+			Critical,
+			Normal,
+			/// @brief Work nobody waits on soon, like asset streaming. Held back when the next frame is near.
+			Background
+		};
+		static inline constexpr int32 PriorityCount = 3;
 		template<typename T>
 		volatile T* GetDataAs() {
 			return (volatile T*)(&data);
 		}
 
-		WorkFunction function;
-		volatile bool finished = false;
-		// Data zone, also prevents false sharing.
-		volatile byte data[DataLength];
+		WorkFunction function = nullptr;
+		/// @brief Next job in the free list of a JobPool, only meaningful while the job is free.
+		Job* nextFree = nullptr;
+		/// @brief Jobs waiting for this one to finish. Guarded by dependentsLock.\n
+		/// Keeps its capacity across reuses, so the pool stays allocation-free once warm.
+		List<Job*> dependents;
+		/// @brief Unfinished prerequisites, plus one until the job is submitted.\n
+		/// The job is scheduled the moment it drops to zero.
+		AtomicValue<int32> unfinishedPrerequisites{ 1 };
+		/// @brief Bumped every time the job goes back to the pool, invalidating the handles given out before.
+		AtomicValue<uint32> generation{ 0 };
+		AtomicValue<bool> dependentsLock{ false };
+		Preference preference = Preference::Null;
+		Priority priority = Priority::Normal;
+		volatile bool submitted = false;
+		AtomicValue<bool> finished{ false };
+		// Data zone, also prevents false sharing. Callable jobs keep their callable here.
+		alignas(DataAlignment) byte data[DataLength];
+	};
+
+	/// @brief A weak reference to a pooled job.\n
+	/// The job slot is recycled once the job has finished, the generation tells the handle apart from the slot's later uses.
+	class JobHandle final {
+	public:
+		JobHandle() = default;
+		JobHandle(std::nullptr_t) {}
+
+		bool IsValid() const {
+			return job != nullptr;
+		}
+		/// @brief Indicates if the job has finished. Stays true after the slot is reused by another job.
+		bool IsFinished() const {
+			// Read finished before generation. A reused slot resets finished only after the generation was bumped.
+			bool finished = job->finished.Get();
+			return job->generation.Get() != generation || finished;
+		}
+
+		bool operator==(const JobHandle& obj) const {
+			return job == obj.job && generation == obj.generation;
+		}
+		bool operator!=(const JobHandle& obj) const {
+			return !(*this == obj);
+		}
+		bool operator==(std::nullptr_t) const {
+			return job == nullptr;
+		}
+		bool operator!=(std::nullptr_t) const {
+			return job != nullptr;
+		}
+
+	private:
+		friend class JobSystem;
+
+		JobHandle(Job* job, uint32 generation) :job(job), generation(generation) {}
+
+		Job* job = nullptr;
+		uint32 generation = 0;
+	};
+
+	/// @brief Recycles job objects so scheduling does not touch the heap once warm.\n
+	/// Each thread keeps a LocalFreeList and only takes the lock of the SharedFreeList to exchange batches with it.
+	/// Memory is allocated in cache line aligned chunks, which are freed with the pool.
+	class JobPool final {
+	public:
+		/// @brief Jobs allocated at once when every free list is empty.
+		static inline constexpr int32 ChunkJobCount = 256;
+		/// @brief Jobs moved between a thread free list and the shared one at a time.
+		static inline constexpr int32 TransferCount = 64;
+		/// @brief Free jobs a thread keeps before giving a batch back to the shared list.
+		static inline constexpr int32 LocalCacheLimit = TransferCount * 2;
+		/// @brief Size of the smallest pooled block, including its header. Each following class doubles it.
+		static inline constexpr sizeint MinBlockSize = 128;
+		/// @brief Count of pooled block sizes. Larger requests go straight to Memory::Allocate().
+		static inline constexpr int32 BlockClassCount = 5;
+		/// @brief Blocks allocated at once when a size class runs dry.
+		static inline constexpr int32 ChunkBlockCount = 16;
+		static inline constexpr sizeint BlockAlignment = 16;
+
+		JobPool();
+		~JobPool();
+
+		JobPool(const JobPool&) = delete;
+		JobPool& operator=(const JobPool&) = delete;
+
+		/// @brief Take a free job, reset to the unsubmitted state.
+		Job* Acquire();
+		/// @brief Give a finished job back. Handles to it become stale.
+		void Release(Job* job);
+		/// @brief Give the free jobs cached by the current thread back to the shared list.\n
+		/// Call it before a thread using the pool exits, otherwise they are only reclaimed when the pool is destroyed.
+		void FlushLocalCache();
+
+		/// @brief Allocate a block for job payloads which don't fit into Job::data, like large callables or results.\n
+		/// Aligned to BlockAlignment. Blocks are recycled per size class under a lock, this is the slow path.
+		void* AllocateBlock(sizeint size);
+		/// @brief Give back a block from AllocateBlock(). Can be called from any thread.
+		void DeallocateBlock(void* block);
+
+		/// @brief Get the count of jobs allocated so far. Stops growing once the pool is warm.
+		int32 GetCapacity() const;
+		/// @brief Get the count of chunk allocations so far.
+		int32 GetChunkCount() const;
+
+	private:
+		struct alignas(ThreadUtil::CacheLineSize) LocalCache {
+			/// @brief The pool the cached jobs belong to. Serials are never reused, unlike addresses.
+			uint64 serial = 0;
+			/// @brief Links through Job::nextFree, the generation of a free job must survive.
+			LocalFreeList<TransferCount, LocalCacheLimit, Job, &Job::nextFree> jobs{};
+		};
+		struct Chunk {
+			void* memory;
+			Job* jobs;
+		};
+		struct alignas(BlockAlignment) BlockHeader {
+			/// @brief -1 for blocks allocated on their own.
+			int32 sizeClass;
+			BlockHeader* nextFree;
+		};
+
+		/// @brief Get the free list of the current thread, dropping it if it belongs to another pool.
+		LocalCache& GetLocalCache();
+		/// @brief Allocate and construct another chunk of jobs, for SharedFreeList::Take().
+		int32 CarveChunk(Job*& head, Job*& tail);
+		/// @brief Allocate another chunk of blocks, for SharedFreeList::Take().
+		int32 CarveBlocks(int32 sizeClass, BlockHeader*& head, BlockHeader*& tail);
+
+		static thread_local LocalCache localCache;
+		static std::atomic<uint64> lastSerial;
+
+		uint64 serial;
+
+		SharedFreeList<Job, &Job::nextFree> freeJobs{};
+		/// @brief Guards chunks, taken under the lock of freeJobs when carving.
+		mutable Mutex mutex;
+		List<Chunk> chunks{ 4 };
+
+		SharedFreeList<BlockHeader, &BlockHeader::nextFree> freeBlocks[BlockClassCount]{};
+		/// @brief Guards blockChunks, taken under the lock of freeBlocks when carving.
+		Mutex blockMutex;
+		List<void*> blockChunks{ 4 };
+	};
+
+	/// @brief A fiber running jobs, reused from job to job.
+	struct JobFiber {
+		JobFiber(JobSystem* system, void (*entry)(void*)) :fiber(entry, this), system(system) {}
+
+		Fiber fiber;
+		JobSystem* system;
+		/// @brief The job to run, nullptr once it has finished.
+		Job* job = nullptr;
 	};
 
 	class JobWorker final {
@@ -48,61 +219,537 @@ namespace Engine {
 
 		/// @brief Job worker thread function. 
 		static void ThreadFunction(JobWorker* worker);
-		/// @brief Job running sequence.
-		static void RunJob(SharedPtr<Job>& job);
 
 		int32 GetId() const;
 
 	private:
 		friend class JobSystem;
 
-		SharedPtr<Job> GetJob();
-		void AddExclusiveJob(SharedPtr<Job> job);
+		/// @brief The worker running on the current thread, nullptr on non-worker threads.
+		static thread_local JobWorker* current;
+		/// @brief Read current through a call the compiler can't see into.\n
+		/// A fiber may resume on another thread, the thread local address must not be cached across a switch.
+		static JobWorker* GetCurrent();
+
+		/// @brief Pick the next job, highest lane first, unless a lower lane has been passed over too often.
+		Job* GetJob();
+		/// @brief Get a job of one lane from anywhere the worker can reach.
+		Job* TakeJob(int32 lane);
+		void AddExclusiveJob(Job* job);
+		/// @brief Push a job into the local deque of its lane. Only called from the worker's own thread.
+		void PushLocalJob(Job* job);
+		/// @brief Steal a job from the top of a local deque. Can be called from any thread.
+		Job* StealJob(int32 lane);
+		/// @brief Take a job nobody else is bound to run: an exclusive one, or one from the local deques.
+		/// In SharedQueue mode the shared queue stands in for the local deques. Ignores the frame deadline.
+		Job* TakeOwnJob();
+		/// @brief Indicates if TakeOwnJob() would find a job.
+		bool HasOwnJob() const;
+		/// @brief Pick a job of a lane from the other workers, those on the same NUMA node first.
+		Job* StealFromOthers(int32 lane);
 
 		JobSystem* manager;
 		std::thread thread;
-		volatile bool running = false;
-		volatile bool shouldRun = false;
+		AtomicValue<bool> running{ false };
+		AtomicValue<bool> shouldRun{ false };
 
-		List<SharedPtr<Job>> exclusiveJobs{ 30 };
+		/// @brief Jobs only this worker may run, in the order they were added.
+		Deque<Job*> exclusiveJobs{};
 		mutable Mutex exclusiveJobMutex;
 
+		WorkStealingQueue<Job*> localJobs[Job::PriorityCount]{};
+		uint32 stealSeed;
+		/// @brief Picks from a higher lane since a job of each lane was last taken. Owner thread only.
+		int32 passedOver[Job::PriorityCount] = {};
+		/// @brief Set when the last GetJob() held background jobs back for the frame deadline.
+		bool deferredBackground = false;
+
+		/// @brief The worker thread's own context, fibers switch back to it. Fiber execution only.
+		Fiber* schedulerFiber = nullptr;
+		/// @brief The fiber the worker has switched to, nullptr while it runs its own context.
+		JobFiber* currentFiber = nullptr;
+		/// @brief The resume job of a fiber which just suspended. Submitted once the fiber is off the stack.
+		Job* pendingResume = nullptr;
+
+		/// @brief The CPU the thread is pinned to, -1 for none.
+		int32 cpu = -1;
+		int32 numaNode = 0;
+		String name;
+
 		int32 id;
 	};
 
 	class JobSystem final {
 	public:
-		JobSystem();
+		/// @brief How the workers share jobs.
+		enum class SchedulingMode :byte {
+			/// @brief Every job goes through one mutex guarded queue.
+			SharedQueue,
+			/// @brief Each worker owns a lock-free deque and steals from its peers when idle.\n
+			/// The shared queue is only used to inject jobs from non-worker threads.
+			WorkStealing
+		};
+
+		/// @brief Where the workers run jobs.
+		enum class ExecutionMode :byte {
+			/// @brief On the worker thread stack. A job waiting for another one holds its worker.
+			Thread,
+			/// @brief Each job on a fiber. A job waiting for another one suspends its fiber,
+			/// the worker picks up other work and any worker resumes the fiber once the awaited job has finished.\n
+			/// Jobs may continue on another thread after WaitJob(). Don't hold thread affine state, like a locked mutex, across it.
+			Fiber
+		};
+
+		/// @brief How a thread waits for a job to finish.
+		enum class WaitStrategy :byte {
+			/// @brief Run other queued jobs while waiting, then spin, then yield, then sleep.\n
+			/// Suspends the fiber instead when called from a job running on a fiber.
+			Adaptive,
+			/// @brief Burn the core until the job finishes. Lowest latency, only for very short waits.
+			Spin,
+			/// @brief Spin for a short while, then keep yielding the time slice.
+			SpinYield,
+			/// @brief Sleep until the job finishes.
+			Block
+		};
+		/// @brief Maximum nesting of jobs run by one thread while waiting, keeps the stack bounded.\n
+		/// Deeper than this a worker only runs its own jobs, see JobWorker::TakeOwnJob(), which could otherwise be left to nobody.
+		static inline constexpr int32 MaxWaitHelpDepth = 8;
+		/// @brief Spin iterations before yielding.
+		static inline constexpr int32 WaitSpinCount = 256;
+		/// @brief Yield iterations before sleeping.
+		static inline constexpr int32 WaitYieldCount = 64;
+		/// @brief Pieces per worker a parallel loop aims for when no grain size is given.
+		static inline constexpr int32 ParallelPiecesPerWorker = 4;
+		/// @brief Default count of picks from higher lanes before a waiting lower lane gets a turn.
+		static inline constexpr int32 DefaultStarvationLimit = 32;
+
+		using Clock = std::chrono::steady_clock;
+
+		/// @brief How to set up the workers.
+		struct Config {
+			/// @brief Worker thread count. -1 for hardware threads - 1. At least one worker is always created.
+			int32 workerCount = -1;
+			/// @brief Job sharing mode between workers.
+			SchedulingMode scheduling = SchedulingMode::WorkStealing;
+			/// @brief Where the workers run jobs.
+			ExecutionMode execution = ExecutionMode::Thread;
+			/// @brief Pin each worker thread to one logical CPU, so it doesn't wander between cores and sockets.
+			bool pinThreads = false;
+			/// @brief The CPUs the workers are pinned to, in worker order, wrapping around.\n
+			/// Empty for CPU 1 onwards, leaving CPU 0 to the main thread.
+			List<int32> cpus;
+			/// @brief Steal from workers on the same NUMA node first, other nodes are only tried once those are empty.\n
+			/// The node of a worker is the node of its CPU, so it needs pinThreads.
+			bool numaAware = false;
+			/// @brief Worker threads are named "<threadName> <id>" for debuggers and profilers. Keep it short, Linux cuts names at 15 bytes.
+			const u8char* threadName = u8"Job Worker";
+		};
+
+		/// @param workerCount Worker thread count. -1 for hardware threads - 1. At least one worker is always created.
+		/// @param mode Job sharing mode between workers.
+		/// @param execution Where the workers run jobs.
+		JobSystem(int32 workerCount = -1, SchedulingMode mode = SchedulingMode::WorkStealing, ExecutionMode execution = ExecutionMode::Thread);
+		explicit JobSystem(const Config& config);
+		~JobSystem();
 
 		/// @brief Start the job system.
 		void Start();
 		/// @brief Stop the job system.\n
 		/// Will block until all the worker threads stop.
 		void Stop();
-		/// @brief Add a job.
-		SharedPtr<Job> AddJob(Job::WorkFunction function, void* data = nullptr, sizeint dataLength = 0, Job::Preference preference = Job::Preference::Null);
+		/// @brief Add a job. It is scheduled immediately.
+		JobHandle AddJob(Job::WorkFunction function, void* data = nullptr, sizeint dataLength = 0, Job::Preference preference = Job::Preference::Null, Job::Priority priority = Job::Priority::Normal);
+		/// @brief Add a job running a callable, like a lambda. It is scheduled immediately.\n
+		/// The callable is moved into the job if it fits into Job::data, otherwise into a block of the job pool.
+		/// @return A JobHandle if the callable returns void, otherwise a JobFuture carrying the result.
+		template<typename F> requires Concept::IsInvocable<std::decay_t<F>&>
+		auto AddJob(F&& function, Job::Preference preference = Job::Preference::Null, Job::Priority priority = Job::Priority::Normal) {
+			using Callable = std::decay_t<F>;
+			using Result = std::invoke_result_t<Callable&>;
+			if constexpr (std::is_void_v<Result>) {
+				JobHandle job = CreateJob(Memory::Forward<F>(function), preference, priority);
+				Submit(job);
+				return job;
+			} else {
+				using State = typename JobFuture<Result>::State;
+				static_assert(alignof(State) <= JobPool::BlockAlignment, "The result type is over-aligned.");
+
+				State* state = (State*)jobPool.AllocateBlock(sizeof(State));
+				Memory::Construct(state, &jobPool);
+				JobHandle job = CreateJob([state, callable = Callable(Memory::Forward<F>(function))]() mutable {
+					Memory::Construct(state->GetValue(), callable());
+					state->Release();
+				}, preference, priority);
+				Submit(job);
+				return JobFuture<Result>(this, job, state);
+			}
+		}
+
+		/// @brief Create a job without scheduling it.\n
+		/// Declare its prerequisites with AddDependency(), then call Submit().
+		/// The job slot is only recycled after running, so every created job must be submitted.
+		JobHandle CreateJob(Job::WorkFunction function, void* data = nullptr, sizeint dataLength = 0, Job::Preference preference = Job::Preference::Null, Job::Priority priority = Job::Priority::Normal);
+		/// @brief Create a job running a callable without scheduling it. The result of the callable is discarded.
+		template<typename F> requires Concept::IsInvocable<std::decay_t<F>&>
+		JobHandle CreateJob(F&& function, Job::Preference preference = Job::Preference::Null, Job::Priority priority = Job::Priority::Normal) {
+			using Callable = std::decay_t<F>;
+
+			Job* job = jobPool.Acquire();
+			job->preference = preference;
+			job->priority = priority;
+			if constexpr (sizeof(Callable) <= Job::DataLength && alignof(Callable) <= Job::DataAlignment) {
+				Memory::Construct((Callable*)job->data, Memory::Forward<F>(function));
+				job->function = RunInlineCallable<Callable>;
+			} else {
+				static_assert(alignof(Callable) <= JobPool::BlockAlignment, "The callable is over-aligned.");
+				Callable* callable = (Callable*)jobPool.AllocateBlock(sizeof(Callable));
+				Memory::Construct(callable, Memory::Forward<F>(function));
+				SpilledCallable spilled{ callable, &jobPool };
+				std::memcpy(job->data, &spilled, sizeof(spilled));
+				job->function = RunSpilledCallable<Callable>;
+			}
+			return JobHandle(job, job->generation.Get());
+		}
+		/// @brief Make a job wait for a prerequisite to finish before running.\n
+		/// Only valid before the job is submitted. Finished prerequisites are ignored.
+		void AddDependency(JobHandle job, JobHandle prerequisite);
+		/// @brief Submit a job created by CreateJob().\n
+		/// It is scheduled as soon as all its prerequisites have finished.
+		void Submit(JobHandle job);
+		/// @brief Submit a job created by CreateJob() once the next frame begins, see AdvanceFrame().
+		void SubmitNextFrame(JobHandle job);
+		/// @brief Submit the jobs held back by SubmitNextFrame(). The main loop calls it when a frame begins.
+		void AdvanceFrame();
+		/// @brief Add a job which runs once the prerequisite has finished.
+		JobHandle AddContinuation(JobHandle prerequisite, Job::WorkFunction function, void* data = nullptr, sizeint dataLength = 0, Job::Preference preference = Job::Preference::Null, Job::Priority priority = Job::Priority::Normal);
+		/// @brief Add a callable which runs once the prerequisite has finished. The result of the callable is discarded.
+		template<typename F> requires Concept::IsInvocable<std::decay_t<F>&>
+		JobHandle AddContinuation(JobHandle prerequisite, F&& function, Job::Preference preference = Job::Preference::Null, Job::Priority priority = Job::Priority::Normal) {
+			JobHandle job = CreateJob(Memory::Forward<F>(function), preference, priority);
+			AddDependency(job, prerequisite);
+			Submit(job);
+			return job;
+		}
+
 		/// @brief Indicates if the job system is still running.
 		bool IsRunning() const;
-		/// @brief Wait for a job stop. Will help run other jobs while waiting.
-		void WaitJob(SharedPtr<Job> job);
+		/// @brief Get the job sharing mode between workers.
+		SchedulingMode GetSchedulingMode() const;
+		/// @brief Get where the workers run jobs.
+		ExecutionMode GetExecutionMode() const;
+		/// @brief Get the count of fibers created so far. Fibers are reused, it only grows with the count of suspended jobs.
+		int32 GetFiberCount() const;
+		/// @brief Get the worker count.
+		int32 GetWorkerCount() const;
+		/// @brief Get the CPU a worker is pinned to, -1 if it isn't.
+		int32 GetWorkerCpu(int32 worker) const;
+		/// @brief Get the NUMA node a worker steals from first.
+		int32 GetWorkerNumaNode(int32 worker) const;
+		/// @brief Get the pool the jobs are drawn from.
+		const JobPool& GetJobPool() const;
+
+		/// @brief Set how many picks from higher lanes a waiting lower lane tolerates before it gets a turn.\n
+		/// 0 turns the protection off, lower lanes then only run when the higher ones are empty.
+		void SetStarvationLimit(int32 limit);
+		int32 GetStarvationLimit() const;
+		/// @brief Tell the workers when the main loop starts its next frame.\n
+		/// Background jobs are not started within the deadline margin before it, so the workers are free once the frame begins.
+		void SetFrameDeadline(Clock::time_point deadline);
+		/// @brief Drop the frame deadline, background jobs are started at any time again.
+		void ClearFrameDeadline();
+		/// @brief Set how long before the frame deadline background jobs are held back.
+		void SetFrameDeadlineMargin(Clock::duration margin);
+		Clock::duration GetFrameDeadlineMargin() const;
+		/// @brief Indicates if the next frame is within the deadline margin.\n
+		/// Long background jobs can check it to stop early and continue in a new job.
+		bool IsNearFrameDeadline() const;
+		/// @brief Wait for a job to finish.
+		/// @param strategy How to spend the time while waiting. By default helps run other jobs.
+		void WaitJob(JobHandle job, WaitStrategy strategy = WaitStrategy::Adaptive);
+
+		/// @brief Run fn over [begin, end) in parallel, returns once every index is processed.\n
+		/// The calling thread works on the range too. A range larger than grain is halved whenever the thread running it
+		/// has no queued work left for thieves, so pieces stay coarse while every worker is busy and split up when some are idle.
+		/// @param grain The largest piece handed to one fn call. 0 or less picks one from the worker count.
+		/// @param fn Called as fn(int32 pieceBegin, int32 pieceEnd), possibly from several threads at once.
+		template<typename F>
+		void ParallelFor(int32 begin, int32 end, int32 grain, F&& fn) {
+			if (begin >= end) {
+				return;
+			}
+
+			ParallelRange range{};
+			range.function = [](void* context, int32 pieceBegin, int32 pieceEnd) {
+				(*(std::remove_reference_t<F>*)context)(pieceBegin, pieceEnd);
+			};
+			range.context = (void*)std::addressof(fn);
+			RunParallel(range, begin, end, grain);
+		}
+		/// @brief Call fn on every element of the list in parallel.\n
+		/// The list must not be resized until it returns.
+		/// @param fn Called as fn(T& element).
+		template<typename T, typename F>
+		void ParallelForEach(List<T>& list, int32 grain, F&& fn) {
+			T* elements = list.GetRawElementPtr();
+			ParallelFor(0, list.GetCount(), grain, [elements, &fn](int32 pieceBegin, int32 pieceEnd) {
+				for (int32 i = pieceBegin; i < pieceEnd; i += 1) {
+					fn(elements[i]);
+				}
+			});
+		}
+		/// @brief Reduce [begin, end) in parallel.\n
+		/// The range is cut into fixed pieces of grain size, whose results are combined in index order on the calling thread.
+		/// The result is the same from run to run, even for operations which are not associative like floating point addition.
+		/// @param identity The result of an empty range.
+		/// @param fn Called as fn(int32 pieceBegin, int32 pieceEnd), returns the result of the piece.
+		/// @param combine Called as combine(const T& left, const T& right), returns the combined result.
+		template<typename T, typename F, typename C>
+		T ParallelReduce(int32 begin, int32 end, int32 grain, const T& identity, F&& fn, C&& combine) {
+			if (begin >= end) {
+				return identity;
+			}
+
+			grain = GetParallelGrain(end - begin, grain);
+			int32 pieces = (end - begin - 1) / grain + 1;
+			List<T> partials(pieces);
+			for (int32 i = 0; i < pieces; i += 1) {
+				partials.Add(identity);
+			}
+
+			T* results = partials.GetRawElementPtr();
+			ParallelFor(0, pieces, 1, [begin, end, grain, results, &fn](int32 pieceBegin, int32 pieceEnd) {
+				for (int32 i = pieceBegin; i < pieceEnd; i += 1) {
+					int32 first = begin + i * grain;
+					results[i] = fn(first, end - first > grain ? first + grain : end);
+				}
+			});
+
+			T result = identity;
+			for (int32 i = 0; i < pieces; i += 1) {
+				result = combine(result, results[i]);
+			}
+			return result;
+		}
 
 	private:
 		friend class JobWorker;
 
-		/// @brief Get a job from the public job queue.
-		SharedPtr<Job> GetJob();
+		static inline constexpr int64 NoFrameDeadline = INT64_MAX;
+
+		/// @brief Returns true once the waited thing is done.
+		using WaitCondition = bool (*)(const void* context);
+
+		/// @brief Shared state of one ParallelFor call, lives on the caller's stack.
+		struct ParallelRange {
+			void (*function)(void* context, int32 pieceBegin, int32 pieceEnd);
+			void* context;
+			int32 grain;
+			/// @brief Indexes not processed yet.
+			AtomicValue<int32> remaining{ 0 };
+			/// @brief An empty job submitted once remaining reaches zero, the caller waits for it.
+			JobHandle completion;
+		};
+		/// @brief Job data of a callable which didn't fit into the job.
+		struct SpilledCallable {
+			void* callable;
+			JobPool* pool;
+		};
+		template<typename Callable>
+		static void RunInlineCallable(Job* job) {
+			Callable* callable = (Callable*)job->data;
+			(*callable)();
+			Memory::Destruct(callable);
+		}
+		template<typename Callable>
+		static void RunSpilledCallable(Job* job) {
+			SpilledCallable spilled;
+			std::memcpy(&spilled, job->data, sizeof(spilled));
+			Callable* callable = (Callable*)spilled.callable;
+			(*callable)();
+			Memory::Destruct(callable);
+			spilled.pool->DeallocateBlock(callable);
+		}
+
+		/// @brief Job data of a split off part of a parallel range.
+		struct ParallelRangeData {
+			JobSystem* system;
+			ParallelRange* range;
+			int32 begin;
+			int32 end;
+		};
+
+		/// @brief Get a job of a lane from the public job queue.
+		Job* GetJob(int32 lane);
+		/// @brief Put a job whose prerequisites have all finished into a queue.
+		void Schedule(Job* job);
+		/// @brief Job running sequence. Releases the dependents once the job has finished, then recycles the job.
+		void RunJob(Job* job);
+		/// @brief Run a job picked by a worker, on a fiber in fiber execution.
+		void RunJobOnWorker(JobWorker* worker, Job* job);
+		/// @brief Suspend the running fiber until the job finishes.
+		/// @return false if the current thread isn't running a fiber of this system.
+		bool SuspendFiber(const JobHandle& job);
+		JobFiber* AcquireFiber();
+		void ReleaseFiber(JobFiber* fiber);
+		/// @brief The entry of every job fiber. Runs the assigned job, then switches back to the worker.
+		static void RunFiber(void* argument);
+		/// @brief Wake up a sleeping worker if there is any.
+		void NotifyWorkers(bool all);
+		/// @brief Wake up the threads in BlockWait() to check again.
+		void NotifyWaiters();
+		/// @brief Find a job the current thread can run while waiting.
+		Job* GetJobForWaiter();
+		/// @brief Wait until the condition holds. It is checked again each time a job finishes.
+		void Wait(WaitCondition condition, const void* context, WaitStrategy strategy);
+		/// @brief Get a job of the current worker for a waiter, whatever the help depth. nullptr on non-worker threads.
+		Job* GetOwnJobForWaiter();
+		/// @brief Spin, then yield, until the condition holds or the budget runs out.
+		static bool SpinWait(WaitCondition condition, const void* context, int32 spinCount, int32 yieldCount);
+		/// @brief Sleep until the condition holds.
+		/// @param wakeForOwnJobs Also wake up when the current worker has jobs of its own to run, see JobWorker::HasOwnJob().
+		void BlockWait(WaitCondition condition, const void* context, bool wakeForOwnJobs);
+
+		/// @brief Pick the grain size of a parallel loop over count indexes.
+		int32 GetParallelGrain(int32 count, int32 grain) const;
+		/// @brief Process a parallel range from the calling thread, then wait for the split off parts.
+		void RunParallel(ParallelRange& range, int32 begin, int32 end, int32 grain);
+		/// @brief Process [begin, end) piece by piece, splitting half of the rest off whenever thieves could use it.
+		void RunParallelRange(ParallelRange* range, int32 begin, int32 end);
+		/// @brief Indicates if a parallel range running on the current thread should split off work.
+		bool ShouldSplitParallelRange() const;
+		static void RunParallelRangeJob(Job* job);
 
 		volatile bool running = false;
+		SchedulingMode mode;
+		ExecutionMode execution;
+		/// @brief Set when the workers span several NUMA nodes and steal within their own first.
+		bool numaAware = false;
+
+		// Declared before the queues, outlives every job pointer they hold.
+		JobPool jobPool;
 
 		List<SharedPtr<JobWorker>> workers{ 12 };
 
-		List<SharedPtr<Job>> jobs{ 100 };
+		/// @brief Jobs added from outside the workers, one queue per lane, run in the order they were added.
+		Deque<Job*> jobs[Job::PriorityCount];
 		mutable Mutex jobsMutex;
 		ConditionVariable jobsCond;
 		mutable Mutex jobsCondMutex;
+		/// @brief The frame deadline in Clock ticks, NoFrameDeadline if there is none.
+		std::atomic<int64> frameDeadline{ NoFrameDeadline };
+		std::atomic<int64> frameDeadlineMargin{ std::chrono::duration_cast<Clock::duration>(std::chrono::milliseconds(2)).count() };
+		std::atomic<int32> starvationLimit{ DefaultStarvationLimit };
+		/// @brief Jobs waiting for AdvanceFrame().
+		List<JobHandle> nextFrameJobs{ 16 };
+		Mutex nextFrameMutex;
+
+		/// @brief Count of workers blocked on jobsCond, lets AddJob skip the notify when everyone is busy.
+		std::atomic<int32> sleepingWorkers{ 0 };
+
+		ConditionVariable finishedCond;
+		mutable Mutex finishedMutex;
+		/// @brief Count of threads blocked on finishedCond, lets RunJob skip the notify when nobody sleeps.
+		std::atomic<int32> blockedWaiters{ 0 };
+
+		/// @brief Nesting depth of jobs run while waiting on the current thread.
+		static thread_local int32 waitHelpDepth;
+
+		/// @brief Every fiber created, freed along with the system.
+		List<JobFiber*> fibers{ 16 };
+		List<JobFiber*> freeFibers{ 16 };
+		mutable Mutex fiberMutex;
 
 		Dictionary<Job::Preference, int32> preferenceToWorker;
 
 		int32 lastId = -1;
 	};
+
+	/// @brief The result of a callable job added with JobSystem::AddJob().\n
+	/// The result lives in a pooled block shared by the job and the future, freed by whichever lets go last.
+	template<typename T>
+	class JobFuture final {
+	public:
+		JobFuture() = default;
+		JobFuture(JobFuture&& obj) noexcept :system(obj.system), job(obj.job), state(obj.state) {
+			obj.system = nullptr;
+			obj.job = nullptr;
+			obj.state = nullptr;
+		}
+		JobFuture& operator=(JobFuture&& obj) noexcept {
+			if (this != &obj) {
+				Reset();
+				system = obj.system;
+				job = obj.job;
+				state = obj.state;
+				obj.system = nullptr;
+				obj.job = nullptr;
+				obj.state = nullptr;
+			}
+			return *this;
+		}
+		~JobFuture() {
+			Reset();
+		}
+
+		JobFuture(const JobFuture&) = delete;
+		JobFuture& operator=(const JobFuture&) = delete;
+
+		bool IsValid() const {
+			return state != nullptr;
+		}
+		bool IsFinished() const {
+			return job.IsFinished();
+		}
+		/// @brief Get the job producing the result, to wait for it or to depend on it.
+		JobHandle GetHandle() const {
+			return job;
+		}
+		/// @brief Wait for the job to finish, then move the result out. Call it once.
+		T Get(JobSystem::WaitStrategy strategy = JobSystem::WaitStrategy::Adaptive) {
+			FATAL_ASSERT(state != nullptr, u8"The future is empty.");
+			system->WaitJob(job, strategy);
+			return Memory::Move(*state->GetValue());
+		}
+		/// @brief Drop the result. The job still runs.
+		void Reset() {
+			if (state != nullptr) {
+				state->Release();
+			}
+			system = nullptr;
+			job = nullptr;
+			state = nullptr;
+		}
+
+	private:
+		friend class JobSystem;
+
+		struct State {
+			explicit State(JobPool* pool) :pool(pool) {}
+
+			T* GetValue() {
+				return (T*)value;
+			}
+			/// @brief Called once by the job after storing the value, and once by the future.
+			void Release() {
+				if (references.Subtract(1) > 0) {
+					return;
+				}
+				JobPool* owner = pool;
+				Memory::Destruct(GetValue());
+				Memory::Destruct(this);
+				owner->DeallocateBlock(this);
+			}
+
+			AtomicValue<int32> references{ 2 };
+			JobPool* pool;
+			alignas(T) byte value[sizeof(T)];
+		};
+
+		JobFuture(JobSystem* system, JobHandle job, State* state) :system(system), job(job), state(state) {}
+
+		JobSystem* system = nullptr;
+		JobHandle job;
+		State* state = nullptr;
+	};
 }
@@ -0,0 +1,95 @@
+#include "Engine/System/Thread/Task.h"
+#include "Engine/System/Memory/FreeList.h"
+#include <atomic>
+
+namespace Engine {
+#pragma region TaskFrameAllocator
+	namespace {
+		struct SharedFrames {
+			SharedFreeList<> lists[TaskFrameAllocator::BlockClassCount];
+			std::atomic<int32> chunkCount{ 0 };
+		};
+		SharedFrames& GetSharedFrames() {
+			static SharedFrames shared;
+			return shared;
+		}
+
+		/// @brief Allocates another chunk when everything is in use, for SharedFreeList::Take().
+		struct ChunkCarver {
+			int32 sizeClass;
+
+			int32 operator()(FreeBlock*& head, FreeBlock*& tail) const {
+				sizeint blockSize = TaskFrameAllocator::MinBlockSize << sizeClass;
+				byte* chunk = (byte*)Memory::Allocate(blockSize * TaskFrameAllocator::ChunkBlockCount);
+				GetSharedFrames().chunkCount.fetch_add(1, std::memory_order_relaxed);
+				return SharedFreeList<>::LinkBlocks(chunk, blockSize, TaskFrameAllocator::ChunkBlockCount, head, tail);
+			}
+		};
+
+		/// @brief Free frames of the current thread. Given back to the shared lists when the thread exits.
+		struct LocalFrames {
+			LocalFreeList<TaskFrameAllocator::TransferCount, TaskFrameAllocator::LocalCacheLimit> lists[TaskFrameAllocator::BlockClassCount];
+
+			~LocalFrames() {
+				SharedFrames& shared = GetSharedFrames();
+				for (int32 i = 0; i < TaskFrameAllocator::BlockClassCount; i += 1) {
+					lists[i].Flush(shared.lists[i]);
+				}
+			}
+		};
+		thread_local LocalFrames localFrames;
+
+		int32 GetSizeClass(sizeint size) {
+			int32 sizeClass = 0;
+			while (sizeClass < TaskFrameAllocator::BlockClassCount && (TaskFrameAllocator::MinBlockSize << sizeClass) < size) {
+				sizeClass += 1;
+			}
+			return sizeClass;
+		}
+	}
+
+	void* TaskFrameAllocator::Allocate(sizeint size) {
+		int32 sizeClass = GetSizeClass(size);
+		if (sizeClass >= BlockClassCount) {
+			return Memory::Allocate(size);
+		}
+
+		return localFrames.lists[sizeClass].Pop(GetSharedFrames().lists[sizeClass], ChunkCarver{ sizeClass });
+	}
+	void TaskFrameAllocator::Deallocate(void* ptr, sizeint size) {
+		int32 sizeClass = GetSizeClass(size);
+		if (sizeClass >= BlockClassCount) {
+			Memory::Deallocate(ptr);
+			return;
+		}
+
+		// Frames often finish on another thread than the one they started on, they join the local list of that one.
+		localFrames.lists[sizeClass].Push(GetSharedFrames().lists[sizeClass], (FreeBlock*)ptr);
+	}
+	int32 TaskFrameAllocator::GetChunkCount() {
+		return GetSharedFrames().chunkCount.load(std::memory_order_relaxed);
+	}
+#pragma endregion
+
+#pragma region Await
+	ResultCode Await::ReadAllBytes(FileSystem& fileSystem, const String& path, List<byte>& result) {
+		if (!fileSystem.IsFileExists(path)) {
+			return ResultCode::NotFound;
+		}
+
+		IntrusivePtr<FileStream> file;
+		ResultCode code = fileSystem.TryOpenFile(path, FileSystem::OpenMode::ReadOnly, file);
+		if (code != ResultCode::OK) {
+			return code;
+		}
+
+		int64 length = file->GetLength();
+		ERR_ASSERT(length <= INT32_MAX, u8"The file is too large to read at once.", return ResultCode::NotSupported);
+
+		int32 readCount = 0;
+		code = file->TryReadBytes(static_cast<int32>(length), readCount, result);
+		file->Close();
+		return code;
+	}
+#pragma endregion
+}
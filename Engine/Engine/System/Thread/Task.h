@@ -0,0 +1,341 @@
+#pragma once
+#include "Engine/System/Definition.h"
+#include "Engine/System/Thread/JobSystem.h"
+#include "Engine/System/File/FileSystem.h"
+#include <coroutine>
+#include <new>
+#include <type_traits>
+
+namespace Engine {
+	template<typename T>
+	class Task;
+
+	/// @brief Pools the frames of Task coroutines, so steady-state tasks don't allocate.\n
+	/// Each thread keeps its own free lists, batches move through shared lists under a lock.
+	/// Chunks are never given back, the pool keeps the high water mark for the lifetime of the process.
+	class TaskFrameAllocator final {
+	public:
+		STATIC_CLASS(TaskFrameAllocator);
+
+		/// @brief Size of the smallest pooled frame. Each following class doubles it.
+		static inline constexpr sizeint MinBlockSize = 128;
+		/// @brief Count of pooled frame sizes. Larger frames go straight to Memory::Allocate().
+		static inline constexpr int32 BlockClassCount = 6;
+		/// @brief Frames allocated at once when a size class runs dry.
+		static inline constexpr int32 ChunkBlockCount = 32;
+		/// @brief Frames moved between a thread free list and the shared one at a time.
+		static inline constexpr int32 TransferCount = 32;
+		/// @brief Free frames of a size class a thread keeps before giving a batch back.
+		static inline constexpr int32 LocalCacheLimit = TransferCount * 2;
+
+		static void* Allocate(sizeint size);
+		/// @param size Must be the size passed to Allocate().
+		static void Deallocate(void* ptr, sizeint size);
+
+		/// @brief Get the count of chunk allocations so far.
+		static int32 GetChunkCount();
+	};
+
+	/// @brief The part of a Task promise which doesn't depend on the result type.
+	class TaskPromiseBase {
+	public:
+		/// @brief Resumes the awaiting task, or submits the completion job of a started one.
+		struct FinalAwaiter {
+			bool await_ready() const noexcept {
+				return false;
+			}
+			template<typename P>
+			std::coroutine_handle<> await_suspend(std::coroutine_handle<P> handle) noexcept {
+				TaskPromiseBase& promise = handle.promise();
+				if (promise.continuation) {
+					return promise.continuation;
+				}
+				// The waiter may destroy the frame as soon as the completion is submitted, copy out first.
+				JobSystem* system = promise.system;
+				JobHandle completion = promise.completion;
+				system->Submit(completion);
+				return std::noop_coroutine();
+			}
+			void await_resume() const noexcept {}
+		};
+
+		static void* operator new(sizeint size) {
+			return TaskFrameAllocator::Allocate(size);
+		}
+		static void operator delete(void* ptr, sizeint size) {
+			TaskFrameAllocator::Deallocate(ptr, size);
+		}
+
+		std::suspend_always initial_suspend() const noexcept {
+			return {};
+		}
+		FinalAwaiter final_suspend() const noexcept {
+			return {};
+		}
+		void unhandled_exception() {
+			FATAL_CRASH(u8"Unhandled exception in a task.");
+		}
+
+		/// @brief Get the job system the task runs on.
+		JobSystem* GetJobSystem() const {
+			return system;
+		}
+		/// @brief Get the lane the task is resumed on.
+		Job::Priority GetPriority() const {
+			return priority;
+		}
+		void SetPriority(Job::Priority priority) {
+			this->priority = priority;
+		}
+
+	private:
+		template<typename T>
+		friend class Task;
+
+		/// @brief The task awaiting this one, null for a started task.
+		std::coroutine_handle<> continuation;
+		JobSystem* system = nullptr;
+		/// @brief An empty job submitted when a started task finishes, Task::Wait() waits for it.
+		JobHandle completion;
+		Job::Priority priority = Job::Priority::Normal;
+	};
+
+	template<typename T>
+	class TaskPromise final :public TaskPromiseBase {
+	public:
+		TaskPromise() = default;
+		~TaskPromise() {
+			if (hasValue) {
+				Memory::Destruct(GetValue());
+			}
+		}
+
+		Task<T> get_return_object();
+
+		template<typename U> requires std::is_convertible_v<U&&, T>
+		void return_value(U&& result) {
+			Memory::Construct(GetValue(), Memory::Forward<U>(result));
+			hasValue = true;
+		}
+		/// @brief Move the result out.
+		T TakeResult() {
+			FATAL_ASSERT(hasValue, u8"The task has no result.");
+			return Memory::Move(*GetValue());
+		}
+
+	private:
+		T* GetValue() {
+			return std::launder((T*)value);
+		}
+
+		alignas(T) byte value[sizeof(T)];
+		bool hasValue = false;
+	};
+
+	template<>
+	class TaskPromise<void> final :public TaskPromiseBase {
+	public:
+		Task<void> get_return_object();
+
+		void return_void() {}
+		void TakeResult() {}
+	};
+
+	/// @brief A coroutine running on the workers of a JobSystem.\n
+	/// Tasks are lazy. A task runs once it is awaited with co_await from another task, on the thread of the awaiting one,
+	/// or once started with Start(). The awaiting task resumes when it finishes.
+	/// A task suspended on an Await function holds no worker, it is queued again as a job when the awaited thing is ready.
+	/// Tasks may continue on another thread after every co_await. Don't hold thread affine state, like a locked mutex, across it.
+	/// A started task must have finished before the Task is destroyed.
+	/// @tparam T The result type, void for none.
+	template<typename T = void>
+	class Task final {
+	public:
+		using promise_type = TaskPromise<T>;
+
+		Task() = default;
+		~Task() {
+			Destroy();
+		}
+
+		Task(const Task&) = delete;
+		Task& operator=(const Task&) = delete;
+		Task(Task&& other) noexcept :handle(other.handle) {
+			other.handle = nullptr;
+		}
+		Task& operator=(Task&& other) noexcept {
+			if (this != &other) {
+				Destroy();
+				handle = other.handle;
+				other.handle = nullptr;
+			}
+			return *this;
+		}
+
+		bool IsValid() const {
+			return static_cast<bool>(handle);
+		}
+		/// @brief Indicates if a started task has finished.
+		bool IsFinished() const {
+			return handle && handle.promise().completion.IsFinished();
+		}
+
+		/// @brief Run the task on the workers. For tasks no other task awaits, like the root of some loading work.
+		void Start(JobSystem& system, Job::Priority priority = Job::Priority::Normal) {
+			ERR_ASSERT(handle, u8"The task is empty.", return);
+			ERR_ASSERT(handle.promise().system == nullptr, u8"The task is already running.", return);
+
+			promise_type& promise = handle.promise();
+			promise.system = &system;
+			promise.priority = priority;
+			promise.completion = system.CreateJob([](Job*) {});
+
+			std::coroutine_handle<> resume = handle;
+			system.AddJob([resume]() {
+				resume.resume();
+			}, Job::Preference::Null, priority);
+		}
+		/// @brief Wait for a started task to finish.
+		void Wait(JobSystem::WaitStrategy strategy = JobSystem::WaitStrategy::Adaptive) {
+			ERR_ASSERT(handle && handle.promise().completion.IsValid(), u8"The task is not started.", return);
+			handle.promise().system->WaitJob(handle.promise().completion, strategy);
+		}
+		/// @brief Wait for a started task to finish, then move its result out.
+		T Get(JobSystem::WaitStrategy strategy = JobSystem::WaitStrategy::Adaptive) {
+			Wait(strategy);
+			return handle.promise().TakeResult();
+		}
+
+		struct Awaiter {
+			std::coroutine_handle<promise_type> handle;
+
+			bool await_ready() const noexcept {
+				return false;
+			}
+			/// @brief Runs the awaited task on the current thread right away.
+			template<typename P> requires std::is_base_of_v<TaskPromiseBase, P>
+			std::coroutine_handle<> await_suspend(std::coroutine_handle<P> awaiting) noexcept {
+				TaskPromiseBase& parent = awaiting.promise();
+				promise_type& promise = handle.promise();
+				promise.continuation = awaiting;
+				promise.system = parent.system;
+				promise.priority = parent.priority;
+				return handle;
+			}
+			T await_resume() {
+				return handle.promise().TakeResult();
+			}
+		};
+		Awaiter operator co_await() const noexcept {
+			FATAL_ASSERT(handle && handle.promise().system == nullptr, u8"Only an empty task which is not running can be awaited.");
+			return Awaiter{ handle };
+		}
+
+	private:
+		friend class TaskPromise<T>;
+
+		explicit Task(std::coroutine_handle<promise_type> handle) :handle(handle) {}
+
+		void Destroy() {
+			if (handle) {
+				handle.destroy();
+				handle = nullptr;
+			}
+		}
+
+		std::coroutine_handle<promise_type> handle;
+	};
+
+	template<typename T>
+	Task<T> TaskPromise<T>::get_return_object() {
+		return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+	}
+	inline Task<void> TaskPromise<void>::get_return_object() {
+		return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+	}
+
+	/// @brief Things a Task can co_await without blocking a worker.
+	class Await final {
+	public:
+		STATIC_CLASS(Await);
+
+		/// @brief The result of ReadFile().
+		struct FileData {
+			ResultCode result = ResultCode::OK;
+			List<byte> bytes;
+		};
+
+		struct ScheduleAwaiter {
+			Job::Priority priority;
+
+			bool await_ready() const noexcept {
+				return false;
+			}
+			template<typename P> requires std::is_base_of_v<TaskPromiseBase, P>
+			void await_suspend(std::coroutine_handle<P> handle) {
+				TaskPromiseBase& promise = handle.promise();
+				promise.SetPriority(priority);
+				promise.GetJobSystem()->AddJob([handle]() {
+					handle.resume();
+				}, Job::Preference::Null, priority);
+			}
+			void await_resume() const noexcept {}
+		};
+		struct NextFrameAwaiter {
+			bool await_ready() const noexcept {
+				return false;
+			}
+			template<typename P> requires std::is_base_of_v<TaskPromiseBase, P>
+			void await_suspend(std::coroutine_handle<P> handle) {
+				TaskPromiseBase& promise = handle.promise();
+				JobSystem* system = promise.GetJobSystem();
+				system->SubmitNextFrame(system->CreateJob([handle]() {
+					handle.resume();
+				}, Job::Preference::Null, promise.GetPriority()));
+			}
+			void await_resume() const noexcept {}
+		};
+		struct ReadFileAwaiter {
+			FileSystem* fileSystem;
+			String path;
+			FileData data;
+
+			bool await_ready() const noexcept {
+				return false;
+			}
+			template<typename P> requires std::is_base_of_v<TaskPromiseBase, P>
+			void await_suspend(std::coroutine_handle<P> handle) {
+				TaskPromiseBase& promise = handle.promise();
+				JobSystem* system = promise.GetJobSystem();
+				Job::Priority priority = promise.GetPriority();
+				// The awaiter lives in the suspended frame, so the read job can fill it in place.
+				system->AddJob([this, handle, system, priority]() {
+					data.result = ReadAllBytes(*fileSystem, path, data.bytes);
+					system->AddJob([handle]() {
+						handle.resume();
+					}, Job::Preference::Null, priority);
+				}, Job::Preference::Null, Job::Priority::Background);
+			}
+			FileData await_resume() {
+				return Memory::Move(data);
+			}
+		};
+
+		/// @brief Continue as a new job on the given lane. The task keeps the lane for later resumptions.\n
+		/// Lets a long task give way to other jobs, or move to a higher or lower lane.
+		static ScheduleAwaiter Schedule(Job::Priority priority = Job::Priority::Normal) {
+			return ScheduleAwaiter{ priority };
+		}
+		/// @brief Continue once the next frame begins, see JobSystem::AdvanceFrame().
+		static NextFrameAwaiter NextFrame() {
+			return NextFrameAwaiter{};
+		}
+		/// @brief Read a whole file. The read runs as a background job, the task continues on its own lane afterwards.
+		static ReadFileAwaiter ReadFile(FileSystem& fileSystem, const String& path) {
+			return ReadFileAwaiter{ &fileSystem, path, FileData{} };
+		}
+
+	private:
+		static ResultCode ReadAllBytes(FileSystem& fileSystem, const String& path, List<byte>& result);
+	};
+}
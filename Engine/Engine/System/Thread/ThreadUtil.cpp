@@ -1,8 +1,120 @@
 #include "Engine/System/Thread/ThreadUtil.h"
 #include <thread>
+#include <cstdio>
+#include <cstring>
+#if defined(_MSC_VER)
+#	include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#	include <immintrin.h>
+#endif
+
+#if defined(_WIN32)
+#	include "Engine/Platform/Windows/BetterWindows.h"
+#else
+#	include <pthread.h>
+#	include <sched.h>
+#	include <unistd.h>
+#endif
 
 namespace Engine {
 	int32 ThreadUtil::GetHardwareThreadCount() {
 		return (int32)std::thread::hardware_concurrency();
 	}
+	int32 ThreadUtil::GetNumaNodeCount() {
+#if defined(_WIN32)
+		ULONG highest = 0;
+		if (!GetNumaHighestNodeNumber(&highest)) {
+			return 1;
+		}
+		return static_cast<int32>(highest) + 1;
+#elif defined(__linux__)
+		int32 count = 0;
+		char path[64];
+		while (true) {
+			std::snprintf(path, sizeof(path), "/sys/devices/system/node/node%d", count);
+			if (access(path, F_OK) != 0) {
+				break;
+			}
+			count += 1;
+		}
+		return count > 0 ? count : 1;
+#else
+		return 1;
+#endif
+	}
+	int32 ThreadUtil::GetCpuNumaNode(int32 cpu) {
+#if defined(_WIN32)
+		PROCESSOR_NUMBER processor{};
+		processor.Group = static_cast<WORD>(cpu / 64);
+		processor.Number = static_cast<BYTE>(cpu % 64);
+		USHORT node = 0;
+		if (!GetNumaProcessorNodeEx(&processor, &node) || node == 0xffff) {
+			return 0;
+		}
+		return static_cast<int32>(node);
+#elif defined(__linux__)
+		// Each node directory lists its CPUs as cpuN links.
+		int32 nodeCount = GetNumaNodeCount();
+		char path[96];
+		for (int32 node = 0; node < nodeCount; node += 1) {
+			std::snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpu%d", node, cpu);
+			if (access(path, F_OK) == 0) {
+				return node;
+			}
+		}
+		return 0;
+#else
+		return 0;
+#endif
+	}
+	bool ThreadUtil::SetCurrentThreadAffinity(int32 cpu) {
+		if (cpu < 0) {
+			return false;
+		}
+#if defined(_WIN32)
+		GROUP_AFFINITY affinity{};
+		affinity.Group = static_cast<WORD>(cpu / 64);
+		affinity.Mask = static_cast<KAFFINITY>(1) << (cpu % 64);
+		return SetThreadGroupAffinity(GetCurrentThread(), &affinity, nullptr) != 0;
+#elif defined(__linux__)
+		if (cpu >= CPU_SETSIZE) {
+			return false;
+		}
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		CPU_SET(cpu, &set);
+		return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+		// macOS only has affinity tags, which are hints between threads rather than CPU pinning.
+		return false;
+#endif
+	}
+	void ThreadUtil::SetCurrentThreadName(const u8char* name) {
+#if defined(_WIN32)
+		wchar_t wide[64];
+		int length = MultiByteToWideChar(CP_UTF8, 0, (const char*)name, -1, wide, 64);
+		if (length > 0) {
+			wide[63] = L'\0';
+			SetThreadDescription(GetCurrentThread(), wide);
+		}
+#elif defined(__APPLE__)
+		pthread_setname_np((const char*)name);
+#else
+		char truncated[16];
+		std::strncpy(truncated, (const char*)name, sizeof(truncated) - 1);
+		truncated[sizeof(truncated) - 1] = '\0';
+		pthread_setname_np(pthread_self(), truncated);
+#endif
+	}
+	void ThreadUtil::Pause() {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+		_mm_pause();
+#elif defined(_MSC_VER) && defined(_M_ARM64)
+		__yield();
+#elif defined(__x86_64__) || defined(__i386__)
+		_mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+		asm volatile("yield");
+#endif
+	}
 }
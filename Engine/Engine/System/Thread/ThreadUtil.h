@@ -18,6 +18,17 @@ namespace Engine{
 
 	public:
 		static int32 GetHardwareThreadCount();
+		/// @brief Get the NUMA node count. 1 when the platform doesn't tell.
+		static int32 GetNumaNodeCount();
+		/// @brief Get the NUMA node a logical CPU belongs to. 0 when the platform doesn't tell.
+		static int32 GetCpuNumaNode(int32 cpu);
+		/// @brief Pin the current thread to one logical CPU.
+		/// @return false if the platform refused or doesn't support it.
+		static bool SetCurrentThreadAffinity(int32 cpu);
+		/// @brief Name the current thread for debuggers and profilers. Linux keeps the first 15 bytes only.
+		static void SetCurrentThreadName(const u8char* name);
+		/// @brief Hint the CPU that the current thread is busy waiting.
+		static void Pause();
 		static inline constexpr sizeint CacheLineSize = 64;//std::hardware_destructive_interference_size;
 	};
 }
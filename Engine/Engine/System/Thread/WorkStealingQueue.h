@@ -0,0 +1,149 @@
+#pragma once
+
+#include "Engine/System/Definition.h"
+#include "Engine/System/Memory/Memory.h"
+#include "Engine/System/Thread/ThreadUtil.h"
+#include <atomic>
+#include <type_traits>
+
+// Chase-Lev work-stealing deque, following the C11 formulation of
+// "Correct and Efficient Work-Stealing for Weak Memory Models" (Le et al. 2013).
+
+namespace Engine {
+	/// @brief A lock-free single-owner, multi-thief deque.\n
+	/// The owner thread pushes and pops at the bottom (LIFO), other threads steal from the top (FIFO).
+	/// @tparam T The element type. Must be trivially copyable, usually a pointer.
+	template<typename T>
+	class WorkStealingQueue final {
+		static_assert(std::is_trivially_copyable_v<T>, "WorkStealingQueue only stores trivially copyable values.");
+
+	public:
+		WorkStealingQueue(int32 capacity = 64) {
+			int64 desired = 1;
+			while (desired < capacity) {
+				desired <<= 1;
+			}
+			buffer.store(Buffer::Create(desired, nullptr), std::memory_order_relaxed);
+		}
+		~WorkStealingQueue() {
+			Buffer* current = buffer.load(std::memory_order_relaxed);
+			while (current != nullptr) {
+				Buffer* previous = current->previous;
+				Buffer::Destroy(current);
+				current = previous;
+			}
+		}
+
+		WorkStealingQueue(const WorkStealingQueue&) = delete;
+		WorkStealingQueue& operator=(const WorkStealingQueue&) = delete;
+
+		/// @brief Push a value at the bottom. Owner thread only.
+		void Push(T value) {
+			int64 b = bottom.load(std::memory_order_relaxed);
+			int64 t = top.load(std::memory_order_acquire);
+			Buffer* current = buffer.load(std::memory_order_relaxed);
+			if (b - t > current->capacity - 1) {
+				current = Grow(current, b, t);
+			}
+			current->Put(b, value);
+			bottom.store(b + 1, std::memory_order_release);
+		}
+		/// @brief Pop a value from the bottom. Owner thread only.
+		bool TryPop(T& result) {
+			int64 b = bottom.load(std::memory_order_relaxed) - 1;
+			Buffer* current = buffer.load(std::memory_order_relaxed);
+			bottom.store(b, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			int64 t = top.load(std::memory_order_relaxed);
+
+			if (t > b) {
+				// Empty.
+				bottom.store(b + 1, std::memory_order_relaxed);
+				return false;
+			}
+
+			result = current->Get(b);
+			if (t == b) {
+				// The last element, race against thieves.
+				bool won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+				bottom.store(b + 1, std::memory_order_relaxed);
+				return won;
+			}
+			return true;
+		}
+		/// @brief Steal a value from the top. Can be called from any thread.
+		bool TrySteal(T& result) {
+			int64 t = top.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			int64 b = bottom.load(std::memory_order_acquire);
+
+			if (t >= b) {
+				return false;
+			}
+
+			Buffer* current = buffer.load(std::memory_order_acquire);
+			T value = current->Get(t);
+			if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+				// Lost the race against the owner or another thief.
+				return false;
+			}
+			result = value;
+			return true;
+		}
+
+		/// @brief Get an approximate element count. Exact only when called from the owner with no thieves around.
+		int32 GetCount() const {
+			int64 b = bottom.load(std::memory_order_relaxed);
+			int64 t = top.load(std::memory_order_relaxed);
+			return b > t ? static_cast<int32>(b - t) : 0;
+		}
+		bool IsEmpty() const {
+			return GetCount() == 0;
+		}
+
+	private:
+		struct Buffer {
+			int64 capacity;
+			int64 mask;
+			/// @brief Retired buffers are kept until destruction as thieves may still be reading them.
+			Buffer* previous;
+			std::atomic<T>* elements;
+
+			static Buffer* Create(int64 capacity, Buffer* previous) {
+				Buffer* result = (Buffer*)Memory::Allocate(sizeof(Buffer) + sizeof(std::atomic<T>) * capacity);
+				result->capacity = capacity;
+				result->mask = capacity - 1;
+				result->previous = previous;
+				result->elements = (std::atomic<T>*)(result + 1);
+				for (int64 i = 0; i < capacity; i += 1) {
+					Memory::Construct(result->elements + i);
+				}
+				return result;
+			}
+			static void Destroy(Buffer* buffer) {
+				Memory::Deallocate(buffer);
+			}
+
+			T Get(int64 index) const {
+				return elements[index & mask].load(std::memory_order_relaxed);
+			}
+			void Put(int64 index, T value) {
+				elements[index & mask].store(value, std::memory_order_relaxed);
+			}
+		};
+
+		Buffer* Grow(Buffer* current, int64 b, int64 t) {
+			Buffer* grown = Buffer::Create(current->capacity * 2, current);
+			for (int64 i = t; i < b; i += 1) {
+				grown->Put(i, current->Get(i));
+			}
+			buffer.store(grown, std::memory_order_release);
+			return grown;
+		}
+
+		// Top and bottom live on their own cache lines, thieves hammer top while the owner works on bottom.
+		alignas(ThreadUtil::CacheLineSize) std::atomic<int64> top{ 0 };
+		alignas(ThreadUtil::CacheLineSize) std::atomic<int64> bottom{ 0 };
+		alignas(ThreadUtil::CacheLineSize) std::atomic<Buffer*> buffer{ nullptr };
+	};
+}
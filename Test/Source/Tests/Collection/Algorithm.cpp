@@ -0,0 +1,315 @@
+#include "doctest.h"
+#include "Engine/System/Collection/Algorithm.h"
+#include "Engine/System/Collection/ParallelAlgorithm.h"
+#include "Engine/System/Collection/List.h"
+#include "Engine/System/Thread/JobSystem.h"
+#include "Engine/System/String.h"
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+using namespace Engine;
+
+namespace {
+	/// @brief What a renderer sorts every frame, a packed key and the object it draws.
+	struct DrawItem {
+		uint64 key;
+		int32 index;
+
+		bool operator<(const DrawItem& obj) const {
+			return key < obj.key;
+		}
+	};
+
+	List<int32> GetRandomInts(int32 count, int32 range, uint32 seed) {
+		std::mt19937 random(seed);
+		List<int32> result(count);
+		for (int32 i = 0; i < count; i += 1) {
+			result.Add(static_cast<int32>(random() % static_cast<uint32>(range)) - range / 2);
+		}
+		return result;
+	}
+	List<DrawItem> GetDrawItems(int32 count, uint32 seed) {
+		std::mt19937_64 random(seed);
+		List<DrawItem> result(count);
+		for (int32 i = 0; i < count; i += 1) {
+			// Few distinct keys, lots of ties to keep in order.
+			result.Add(DrawItem{ random() % 64 << 40, i });
+		}
+		return result;
+	}
+	/// @brief Check items are sorted by key and items with equal keys kept their order.
+	bool IsStablySorted(const List<DrawItem>& items) {
+		for (int32 i = 1; i < items.GetCount(); i += 1) {
+			DrawItem a = items.Get(i - 1);
+			DrawItem b = items.Get(i);
+			if (b.key < a.key || (a.key == b.key && b.index < a.index)) {
+				return false;
+			}
+		}
+		return true;
+	}
+	bool IsSameAsStd(List<int32> values, const List<int32>& sorted) {
+		std::sort(values.GetRawElementPtr(), values.GetRawElementPtr() + values.GetCount());
+		for (int32 i = 0; i < values.GetCount(); i += 1) {
+			if (values.Get(i) != sorted.Get(i)) {
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+TEST_SUITE("Collections") {
+	TEST_CASE("Algorithm") {
+		SUBCASE("Search") {
+			List<int32> values = { 1, 3, 3, 3, 5, 8 };
+			const int32* raw = values.GetRawElementPtr();
+			CHECK(Algorithm::IsSorted(raw, values.GetCount()));
+			CHECK(Algorithm::LowerBound(raw, 6, 3) == 1);
+			CHECK(Algorithm::UpperBound(raw, 6, 3) == 4);
+			CHECK(Algorithm::LowerBound(raw, 6, 0) == 0);
+			CHECK(Algorithm::LowerBound(raw, 6, 9) == 6);
+			CHECK(Algorithm::BinarySearch(raw, 6, 3) == 1);
+			CHECK(Algorithm::BinarySearch(raw, 6, 8) == 5);
+			CHECK(Algorithm::BinarySearch(raw, 6, 4) == -1);
+			CHECK(Algorithm::BinarySearch(raw, 0, 4) == -1);
+
+			// Descending, with a comparer of its own.
+			List<int32> descending = { 9, 7, 7, 2 };
+			auto greater = [](int32 a, int32 b) {
+				return a > b;
+			};
+			CHECK(Algorithm::IsSorted(descending.GetRawElementPtr(), 4, greater));
+			CHECK(!Algorithm::IsSorted(descending.GetRawElementPtr(), 4));
+			CHECK(Algorithm::LowerBound(descending.GetRawElementPtr(), 4, 7, greater) == 1);
+			CHECK(Algorithm::UpperBound(descending.GetRawElementPtr(), 4, 7, greater) == 3);
+		}
+		SUBCASE("Rearrange") {
+			List<int32> values = GetRandomInts(1000, 100, 1);
+			int32* raw = values.GetRawElementPtr();
+			int32 evens = Algorithm::Partition(raw, 1000, [](int32 value) {
+				return value % 2 == 0;
+			});
+			for (int32 i = 0; i < 1000; i += 1) {
+				CHECK((raw[i] % 2 == 0) == (i < evens));
+			}
+			CHECK(Algorithm::Partition(raw, 0, [](int32) { return true; }) == 0);
+			CHECK(Algorithm::Partition(raw, 10, [](int32) { return true; }) == 10);
+			CHECK(Algorithm::Partition(raw, 10, [](int32) { return false; }) == 0);
+
+			Algorithm::Sort(raw, 1000);
+			int32 count = Algorithm::Unique(raw, 1000);
+			CHECK(count == 100);
+			for (int32 i = 0; i < count; i += 1) {
+				CHECK(raw[i] == i - 50);
+			}
+
+			List<String> words = { STRL("a"), STRL("b"), STRL("c") };
+			Algorithm::Reverse(words.GetRawElementPtr(), 3);
+			CHECK(words.Get(0) == STRL("c"));
+			CHECK(words.Get(2) == STRL("a"));
+		}
+		SUBCASE("Sort") {
+			for (int32 count : { 0, 1, 2, 15, 16, 17, 100, 1000, 100000 }) {
+				List<int32> values = GetRandomInts(count, count + 1, count);
+				List<int32> sorted = values;
+				Algorithm::Sort(sorted.GetRawElementPtr(), count);
+				CHECK(IsSameAsStd(values, sorted));
+			}
+
+			// Shapes which break naive pivots.
+			constexpr int32 count = 20000;
+			List<int32> shapes[4] = { List<int32>(count), List<int32>(count), List<int32>(count), List<int32>(count) };
+			for (int32 i = 0; i < count; i += 1) {
+				shapes[0].Add(i);
+				shapes[1].Add(count - i);
+				shapes[2].Add(7);
+				shapes[3].Add(i < count / 2 ? i : count - i);
+			}
+			for (List<int32>& shape : shapes) {
+				List<int32> sorted = shape;
+				Algorithm::Sort(sorted.GetRawElementPtr(), count);
+				CHECK(IsSameAsStd(shape, sorted));
+				sorted = shape;
+				Algorithm::HeapSort(sorted.GetRawElementPtr(), count);
+				CHECK(IsSameAsStd(shape, sorted));
+			}
+
+			List<String> words(1000);
+			for (int32 value : GetRandomInts(1000, 1000, 2)) {
+				words.Add(String::Format(STRL("{0}"), value));
+			}
+			auto byLength = [](const String& a, const String& b) {
+				return a.GetCount() < b.GetCount();
+			};
+			Algorithm::Sort(words.GetRawElementPtr(), words.GetCount(), byLength);
+			CHECK(Algorithm::IsSorted(words.GetRawElementPtr(), words.GetCount(), byLength));
+		}
+		SUBCASE("Stable sort") {
+			for (int32 count : { 0, 1, 31, 32, 33, 1000, 50000 }) {
+				List<DrawItem> items = GetDrawItems(count, count);
+				Algorithm::StableSort(items.GetRawElementPtr(), count);
+				CHECK(IsStablySorted(items));
+			}
+
+			List<String> words(500);
+			for (int32 value : GetRandomInts(500, 1000, 3)) {
+				words.Add(String::Format(STRL("{0}"), value));
+			}
+			List<String> expected = words;
+			auto byLength = [](const String& a, const String& b) {
+				return a.GetCount() < b.GetCount();
+			};
+			std::stable_sort(expected.GetRawElementPtr(), expected.GetRawElementPtr() + expected.GetCount(), byLength);
+			Algorithm::StableSort(words.GetRawElementPtr(), words.GetCount(), byLength);
+			for (int32 i = 0; i < words.GetCount(); i += 1) {
+				CHECK(words.Get(i) == expected.Get(i));
+			}
+		}
+		SUBCASE("Radix sort") {
+			for (int32 count : { 0, 1, 16, 17, 1000, 100000 }) {
+				List<int32> values = GetRandomInts(count, 2000000000, count);
+				List<int32> sorted = values;
+				Algorithm::RadixSort(sorted.GetRawElementPtr(), count);
+				CHECK(IsSameAsStd(values, sorted));
+			}
+
+			// Keys differing in the low byte only skip the other passes.
+			List<uint64> small = { 5, 3, 200, 0, 17, 3, 99, 1, 2, 250, 8, 7, 6, 5, 4, 3, 2 };
+			Algorithm::RadixSort(small.GetRawElementPtr(), small.GetCount());
+			CHECK(Algorithm::IsSorted(small.GetRawElementPtr(), small.GetCount()));
+
+			List<float> floats = { 1.5f, -2.0f, 0.0f, -0.0f, 1e30f, -1e30f, 0.25f, -0.25f, 3.0f, -7.5f, 2.0f, 1e-30f, -1e-30f, 100.0f, -100.0f, 42.0f, 0.5f };
+			Algorithm::RadixSort(floats.GetRawElementPtr(), floats.GetCount());
+			CHECK(Algorithm::IsSorted(floats.GetRawElementPtr(), floats.GetCount()));
+			CHECK(floats.Get(0) == -1e30f);
+			CHECK(floats.Get(floats.GetCount() - 1) == 1e30f);
+
+			List<DrawItem> items = GetDrawItems(5000, 4);
+			Algorithm::RadixSort(items.GetRawElementPtr(), items.GetCount(), [](const DrawItem& item) {
+				return item.key;
+			});
+			CHECK(IsStablySorted(items));
+
+			List<String> words(300);
+			for (int32 value : GetRandomInts(300, 1000, 5)) {
+				words.Add(String::Format(STRL("{0}"), value));
+			}
+			Algorithm::RadixSort(words.GetRawElementPtr(), words.GetCount(), [](const String& word) {
+				return word.GetCount();
+			});
+			for (int32 i = 1; i < words.GetCount(); i += 1) {
+				CHECK(words.Get(i - 1).GetCount() <= words.Get(i).GetCount());
+			}
+		}
+	}
+
+	TEST_CASE("ParallelAlgorithm") {
+		JobSystem system{ 2 };
+		system.Start();
+
+		constexpr int32 count = 200000;
+		List<int32> values = GetRandomInts(count, 1000000, 6);
+		List<int32> sorted = values;
+		ParallelAlgorithm::Sort(system, sorted.GetRawElementPtr(), count);
+		CHECK(IsSameAsStd(values, sorted));
+		sorted = values;
+		ParallelAlgorithm::RadixSort(system, sorted.GetRawElementPtr(), count);
+		CHECK(IsSameAsStd(values, sorted));
+		// Short ranges are sorted on the calling thread.
+		sorted = values;
+		ParallelAlgorithm::Sort(system, sorted.GetRawElementPtr(), 1000);
+		CHECK(Algorithm::IsSorted(sorted.GetRawElementPtr(), 1000));
+
+		List<DrawItem> items = GetDrawItems(count, 7);
+		ParallelAlgorithm::StableSort(system, items.GetRawElementPtr(), count);
+		CHECK(IsStablySorted(items));
+		items = GetDrawItems(count, 8);
+		ParallelAlgorithm::RadixSort(system, items.GetRawElementPtr(), count, [](const DrawItem& item) {
+			return item.key;
+		});
+		CHECK(IsStablySorted(items));
+
+		List<String> words(50000);
+		for (int32 value : GetRandomInts(50000, 100000, 9)) {
+			words.Add(String::Format(STRL("{0}"), value));
+		}
+		auto byLength = [](const String& a, const String& b) {
+			return a.GetCount() < b.GetCount();
+		};
+		List<String> expected = words;
+		std::stable_sort(expected.GetRawElementPtr(), expected.GetRawElementPtr() + expected.GetCount(), byLength);
+		ParallelAlgorithm::StableSort(system, words.GetRawElementPtr(), words.GetCount(), byLength);
+		bool same = true;
+		for (int32 i = 0; i < words.GetCount(); i += 1) {
+			same = same && words.Get(i) == expected.Get(i);
+		}
+		CHECK(same);
+
+		system.Stop();
+	}
+}
+
+TEST_SUITE("Benchmark" * doctest::skip()) {
+	TEST_CASE("Sorting") {
+		using Clock = std::chrono::steady_clock;
+		constexpr int32 count = 1 << 20;
+		constexpr int32 rounds = 5;
+
+		List<DrawItem> source(count);
+		std::mt19937_64 random(10);
+		for (int32 i = 0; i < count; i += 1) {
+			source.Add(DrawItem{ random(), i });
+		}
+		auto keyOf = [](const DrawItem& item) {
+			return item.key;
+		};
+
+		JobSystem system{};
+		system.Start();
+		auto measure = [&](auto sort) {
+			double total = 0;
+			for (int32 round = 0; round < rounds; round += 1) {
+				List<DrawItem> items = source;
+				auto start = Clock::now();
+				sort(items.GetRawElementPtr());
+				total += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+				CHECK(Algorithm::IsSorted(items.GetRawElementPtr(), count));
+			}
+			return total / rounds;
+		};
+
+		double stdSort = measure([](DrawItem* items) {
+			std::sort(items, items + count);
+		});
+		double stdStableSort = measure([](DrawItem* items) {
+			std::stable_sort(items, items + count);
+		});
+		double sort = measure([](DrawItem* items) {
+			Algorithm::Sort(items, count);
+		});
+		double stableSort = measure([](DrawItem* items) {
+			Algorithm::StableSort(items, count);
+		});
+		double radixSort = measure([&keyOf](DrawItem* items) {
+			Algorithm::RadixSort(items, count, keyOf);
+		});
+		double parallelSort = measure([&system](DrawItem* items) {
+			ParallelAlgorithm::Sort(system, items, count);
+		});
+		double parallelRadixSort = measure([&system, &keyOf](DrawItem* items) {
+			ParallelAlgorithm::RadixSort(system, items, count, keyOf);
+		});
+		system.Stop();
+
+		INFO_MSG(String::Format(
+			STRL("{0} draw items, std::sort {1:.1f} ms, std::stable_sort {2:.1f} ms, Sort {3:.1f} ms, StableSort {4:.1f} ms, RadixSort {5:.1f} ms"),
+			count, stdSort, stdStableSort, sort, stableSort, radixSort
+		).GetRawArray());
+		INFO_MSG(String::Format(
+			STRL("{0} workers, ParallelAlgorithm::Sort {1:.1f} ms, ParallelAlgorithm::RadixSort {2:.1f} ms"),
+			system.GetWorkerCount(), parallelSort, parallelRadixSort
+		).GetRawArray());
+	}
+}
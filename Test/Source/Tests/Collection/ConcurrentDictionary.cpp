@@ -0,0 +1,147 @@
+#include "doctest.h"
+#include "Engine/System/Collection/ConcurrentDictionary.h"
+#include "Engine/System/String.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace Engine;
+
+TEST_SUITE("Collections") {
+	TEST_CASE("ConcurrentDictionary") {
+		SUBCASE("Same semantics as Dictionary") {
+			ConcurrentDictionary<String, int32, 4> dic{};
+			CHECK(dic.Add(STRL("a"), 1));
+			CHECK(dic.Add(STRL("b"), 2));
+			dic.Set(STRL("b"), 3);
+			dic.Set(STRL("c"), 4);
+			CHECK(dic.GetCount() == 3);
+
+			int32 value = 0;
+			CHECK(dic.TryGet(STRL("b"), value));
+			CHECK(value == 3);
+			CHECK(dic.ContainsKey(STRL("c")));
+			CHECK(!dic.ContainsKey(STRL("d")));
+
+			CHECK(dic.Remove(STRL("a")));
+			CHECK(!dic.Remove(STRL("a")));
+			CHECK(!dic.TryGet(STRL("a"), value));
+			CHECK(dic.GetCount() == 2);
+
+			dic.Clear();
+			CHECK(dic.GetCount() == 0);
+			CHECK(!dic.ContainsKey(STRL("b")));
+		}
+		SUBCASE("Keys spread over the shards") {
+			ConcurrentDictionary<int64, int64, 8> dic(1000);
+			for (int64 i = 0; i < 1000; i += 1) {
+				CHECK(dic.Add(i, i * 2));
+			}
+			CHECK(dic.GetCount() == 1000);
+			int64 value = 0;
+			for (int64 i = 0; i < 1000; i += 1) {
+				REQUIRE(dic.TryGet(i, value));
+				CHECK(value == i * 2);
+			}
+		}
+		SUBCASE("Changing from several threads") {
+			constexpr int32 threadCount = 4;
+			constexpr int64 count = 20000;
+			ConcurrentDictionary<int64, int64> dic{};
+
+			// Every thread owns a range of keys and reads the ranges of the others on the way.
+			std::atomic<int32> mismatches{ 0 };
+			auto work = [&dic, &mismatches](int64 thread) {
+				int64 first = thread * count;
+				for (int64 i = first; i < first + count; i += 1) {
+					dic.Add(i, -i);
+				}
+				int64 value = 0;
+				for (int64 i = 0; i < threadCount * count; i += 7) {
+					if (dic.TryGet(i, value) && value != -i) {
+						mismatches.fetch_add(1, std::memory_order_relaxed);
+					}
+				}
+				for (int64 i = first; i < first + count; i += 2) {
+					dic.Remove(i);
+				}
+			};
+			std::thread others[threadCount - 1];
+			for (int32 i = 1; i < threadCount; i += 1) {
+				others[i - 1] = std::thread(work, static_cast<int64>(i));
+			}
+			work(0);
+			for (auto& other : others) {
+				other.join();
+			}
+
+			CHECK(mismatches.load() == 0);
+			CHECK(dic.GetCount() == threadCount * count / 2);
+			for (int64 i = 0; i < threadCount * count; i += 1) {
+				REQUIRE(dic.ContainsKey(i) == (i % 2 == 1));
+			}
+		}
+	}
+}
+
+TEST_SUITE("Benchmark" * doctest::skip()) {
+	TEST_CASE("ConcurrentDictionary scaling") {
+		constexpr int64 count = 100000;
+
+		// Each thread adds its own keys, looks them up twice and removes them, like objects living on job workers.
+		auto measure = [](auto& dic, int32 threadCount) {
+			auto work = [&dic](int64 thread) {
+				int64 first = thread * count;
+				int64 value = 0;
+				for (int64 i = first; i < first + count; i += 1) {
+					dic.Add(i, i);
+				}
+				for (int64 i = first; i < first + count * 2; i += 1) {
+					dic.TryGet(i, value);
+				}
+				for (int64 i = first; i < first + count; i += 1) {
+					dic.Remove(i);
+				}
+			};
+			auto start = std::chrono::steady_clock::now();
+			std::thread threads[8];
+			for (int32 i = 0; i < threadCount; i += 1) {
+				threads[i] = std::thread(work, static_cast<int64>(i));
+			}
+			for (int32 i = 0; i < threadCount; i += 1) {
+				threads[i].join();
+			}
+			auto duration = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			return static_cast<double>(count * threadCount) / duration / 1000.0;
+		};
+
+		/// @brief One lock around the whole Dictionary, for comparison.
+		struct LockedDictionary {
+			Mutex mutex;
+			Dictionary<int64, int64> dictionary{};
+			void Add(int64 key, int64 value) {
+				auto lock = SimpleLock<Mutex>(mutex);
+				dictionary.Add(key, value);
+			}
+			void TryGet(int64 key, int64& value) {
+				auto lock = SimpleLock<Mutex>(mutex);
+				dictionary.TryGet(key, value);
+			}
+			void Remove(int64 key) {
+				auto lock = SimpleLock<Mutex>(mutex);
+				dictionary.Remove(key);
+			}
+		};
+
+		for (int32 threadCount = 1; threadCount <= 8; threadCount *= 2) {
+			LockedDictionary locked{};
+			ConcurrentDictionary<int64, int64> concurrent{};
+			double lockedRate = measure(locked, threadCount);
+			double concurrentRate = measure(concurrent, threadCount);
+			INFO_MSG(String::Format(
+				STRL("{0} threads, locked Dictionary: {1:.2f} M keys/s, ConcurrentDictionary: {2:.2f} M keys/s"),
+				threadCount, lockedRate, concurrentRate
+			).GetRawArray());
+		}
+	}
+}
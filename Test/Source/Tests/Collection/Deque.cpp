@@ -1,6 +1,13 @@
 #include "doctest.h"
 #include "Engine/System/Collection/Deque.h"
+#include "Engine/System/Memory/MemoryResource.h"
+#include "Engine/System/Memory/UniquePtr.h"
+#include "Engine/System/String.h"
 #include "../System/MemoryObject.h"
+#include "../System/CountingAllocator.h"
+#include <chrono>
+#include <deque>
+#include <random>
 
 using namespace Engine;
 
@@ -77,4 +84,229 @@ TEST_SUITE("Collections") {
 		deque.PushBack(6);
 		CHECK(deque.GetCount() == 7);
 	}
+	TEST_CASE("Deque allocators") {
+		SUBCASE("Copies and every block given back") {
+			{
+				Deque<MemoryObject, CountingAllocator> deque;
+				for (int32 i = 0; i < 20; i += 1) {
+					deque.PushBack(i);
+					deque.PushFront(-i);
+				}
+				CHECK(CountingAllocator::liveCount > 0);
+
+				Deque<MemoryObject, CountingAllocator> copy = deque;
+				CHECK(copy.GetCount() == 40);
+				CHECK(copy.PopFront().Get() == -19);
+				CHECK(copy.PopBack().Get() == 19);
+				CHECK(deque.GetCount() == 40);
+
+				Deque<MemoryObject, CountingAllocator> moved = Memory::Move(deque);
+				CHECK(deque.GetCount() == 0);
+				CHECK(moved.GetCount() == 40);
+				CHECK(moved.PopFront().Get() == -19);
+			}
+			CHECK(CountingAllocator::liveCount == 0);
+		}
+		SUBCASE("Memory resource") {
+			InlineBufferResource<4096> buffer{};
+			MemoryResource::Scope scope(&buffer);
+			Deque<int32, ResourceAllocator> deque;
+			for (int32 i = 0; i < 32; i += 1) {
+				deque.PushBack(i);
+			}
+			CHECK(buffer.GetUsedSize() > 0);
+			CHECK(deque.PopFront() == 0);
+			CHECK(deque.PopBack() == 31);
+		}
+	}
+	TEST_CASE("Deque ring") {
+		SUBCASE("Random access across wraps") {
+			// Small chunks, so the ring wraps and grows often.
+			Deque<int32, HeapAllocator, 4> deque;
+			std::deque<int32> expected;
+			std::mt19937 random(42);
+			for (int32 i = 0; i < 5000; i += 1) {
+				int32 value = static_cast<int32>(random() % 1000);
+				switch (random() % 5) {
+				case 0:
+				case 1:
+					deque.PushBack(value);
+					expected.push_back(value);
+					break;
+				case 2:
+					deque.PushFront(value);
+					expected.push_front(value);
+					break;
+				case 3:
+					if (!expected.empty()) {
+						REQUIRE(deque.PopFront() == expected.front());
+						expected.pop_front();
+					}
+					break;
+				default:
+					if (!expected.empty()) {
+						REQUIRE(deque.PopBack() == expected.back());
+						expected.pop_back();
+					}
+					break;
+				}
+				REQUIRE(deque.GetCount() == static_cast<int32>(expected.size()));
+			}
+			for (int32 i = 0; i < deque.GetCount(); i += 1) {
+				REQUIRE(deque.Get(i) == expected[i]);
+			}
+			if (deque.GetCount() > 0) {
+				deque.Set(0, -1);
+				deque[deque.GetCount() - 1] = -2;
+				CHECK(deque.Get(0) == -1);
+				CHECK(deque[deque.GetCount() - 1] == -2);
+			}
+		}
+		SUBCASE("A queue going round keeps its chunks") {
+			CountingAllocator::liveCount = 0;
+			{
+				Deque<MemoryObject, CountingAllocator, 8> deque;
+				for (int32 i = 0; i < 20; i += 1) {
+					deque.PushBack(i);
+				}
+				// The first lap round the ring fills in the spare chunk.
+				int64 allocations = 0;
+				for (int32 i = 20; i < 2000; i += 1) {
+					if (i == 100) {
+						allocations = CountingAllocator::allocationCount;
+					}
+					CHECK(deque.PopFront().Get() == i - 20);
+					deque.PushBack(i);
+				}
+				CHECK(CountingAllocator::allocationCount == allocations);
+				CHECK(deque.GetCount() == 20);
+			}
+			CHECK(CountingAllocator::liveCount == 0);
+		}
+		SUBCASE("Shrink to fit") {
+			CountingAllocator::liveCount = 0;
+			{
+				Deque<MemoryObject, CountingAllocator, 4> deque;
+				for (int32 i = 0; i < 100; i += 1) {
+					deque.PushFront(i);
+				}
+				int32 chunkCount = deque.GetAllocatedChunkCount();
+				CHECK(chunkCount >= 25);
+				for (int32 i = 0; i < 90; i += 1) {
+					deque.PopBack();
+				}
+				CHECK(deque.GetAllocatedChunkCount() == chunkCount);
+
+				deque.ShrinkToFit();
+				CHECK(deque.GetAllocatedChunkCount() <= 4);
+				CHECK(CountingAllocator::liveCount == deque.GetAllocatedChunkCount() + 1);
+				REQUIRE(deque.GetCount() == 10);
+				for (int32 i = 0; i < 10; i += 1) {
+					CHECK(deque.Get(i).Get() == 99 - i);
+				}
+
+				// Still works after shrinking.
+				deque.PushFront(100);
+				deque.PushBack(-1);
+				CHECK(deque.PopFront().Get() == 100);
+				CHECK(deque.PopBack().Get() == -1);
+
+				deque.Clear();
+				deque.ShrinkToFit();
+				CHECK(CountingAllocator::liveCount == 0);
+			}
+			CHECK(CountingAllocator::liveCount == 0);
+		}
+		SUBCASE("Move only values") {
+			Deque<UniquePtr<int32>, HeapAllocator, 4> deque;
+			for (int32 i = 0; i < 10; i += 1) {
+				deque.EmplaceBack(MEMNEW(int32(i)));
+				deque.PushFront(UniquePtr<int32>(MEMNEW(int32(-i))));
+			}
+			UniquePtr<int32> value;
+			CHECK(deque.TryPopFront(value));
+			CHECK(*value == -9);
+			CHECK(deque.TryPopBack(value));
+			CHECK(*value == 9);
+			CHECK(*deque[0] == -8);
+
+			Deque<UniquePtr<int32>, HeapAllocator, 4> moved = Memory::Move(deque);
+			CHECK(deque.GetCount() == 0);
+			CHECK(moved.GetCount() == 18);
+			CHECK(*moved.PopBack() == 8);
+		}
+		SUBCASE("Pushing an element of itself") {
+			Deque<String, HeapAllocator, 4> deque;
+			deque.PushBack(STRL("first"));
+			for (int32 i = 0; i < 20; i += 1) {
+				deque.PushBack(deque[0]);
+				deque.PushFront(deque[deque.GetCount() - 1]);
+			}
+			CHECK(deque.GetCount() == 41);
+			for (int32 i = 0; i < deque.GetCount(); i += 1) {
+				REQUIRE(deque.Get(i) == STRL("first"));
+			}
+		}
+	}
+}
+
+TEST_SUITE("Benchmark" * doctest::skip()) {
+	TEST_CASE("Deque push and pop") {
+		constexpr int32 count = 100000;
+		constexpr int32 rounds = 20;
+
+		// Fill from both ends and empty from both ends, then run as a queue of 256 jobs.
+		auto measure = [](auto& deque, auto pushFront, auto pushBack, auto popFront, auto popBack, double& ends, double& queue) {
+			int64 sum = 0;
+			auto start = std::chrono::steady_clock::now();
+			for (int32 round = 0; round < rounds; round += 1) {
+				for (int32 i = 0; i < count; i += 1) {
+					pushBack(deque, i);
+					pushFront(deque, i);
+				}
+				for (int32 i = 0; i < count; i += 1) {
+					sum += popFront(deque);
+					sum += popBack(deque);
+				}
+			}
+			auto filled = std::chrono::steady_clock::now();
+			for (int32 i = 0; i < 256; i += 1) {
+				pushBack(deque, i);
+			}
+			for (int32 round = 0; round < rounds; round += 1) {
+				for (int32 i = 0; i < count * 2; i += 1) {
+					sum += popFront(deque);
+					pushBack(deque, i);
+				}
+			}
+			auto done = std::chrono::steady_clock::now();
+			ends = std::chrono::duration<double, std::nano>(filled - start).count() / (static_cast<double>(count) * 4 * rounds);
+			queue = std::chrono::duration<double, std::nano>(done - filled).count() / (static_cast<double>(count) * 4 * rounds);
+			return sum;
+		};
+
+		double ringEnds = 0, ringQueue = 0;
+		Deque<void*> ring;
+		measure(ring,
+			[](auto& deque, int32 i) { deque.PushFront((void*)(intptr_t)i); },
+			[](auto& deque, int32 i) { deque.PushBack((void*)(intptr_t)i); },
+			[](auto& deque) { return (intptr_t)deque.PopFront(); },
+			[](auto& deque) { return (intptr_t)deque.PopBack(); },
+			ringEnds, ringQueue
+		);
+		double stdEnds = 0, stdQueue = 0;
+		std::deque<void*> standard;
+		measure(standard,
+			[](auto& deque, int32 i) { deque.push_front((void*)(intptr_t)i); },
+			[](auto& deque, int32 i) { deque.push_back((void*)(intptr_t)i); },
+			[](auto& deque) { intptr_t value = (intptr_t)deque.front(); deque.pop_front(); return value; },
+			[](auto& deque) { intptr_t value = (intptr_t)deque.back(); deque.pop_back(); return value; },
+			stdEnds, stdQueue
+		);
+
+		INFO_MSG(String::Format(
+			STRL("Both ends / queue, Deque: {0:.2f} / {1:.2f} ns, std::deque: {2:.2f} / {3:.2f} ns"),
+			ringEnds, ringQueue, stdEnds, stdQueue
+		).GetRawArray());
+	}
 }
@@ -1,10 +1,58 @@
 #include "doctest.h"
 #include "Engine/System/Collection/Dictionary.h"
 #include "Engine/System/String.h"
+#include "Engine/System/Memory/FrameArena.h"
 #include "../System/MemoryObject.h"
+#include "../System/CountingAllocator.h"
+#include <chrono>
+#include <unordered_map>
 
 using namespace Engine;
 
+namespace {
+	/// @brief Every key lands on the same slot with the same control byte.
+	struct CollidingKey {
+		int32 value = 0;
+
+		int32 GetHashCode() const {
+			return 7;
+		}
+		bool operator==(const CollidingKey& obj) const {
+			return value == obj.value;
+		}
+	};
+
+	/// @brief std::unordered_map behind the interface of Dictionary, the baseline of the lookup benchmark.
+	template<typename TKey, typename TValue>
+	struct StdDictionary {
+		struct Hash {
+			sizeint operator()(const TKey& key) const {
+				if constexpr (std::is_same_v<TKey, String>) {
+					return static_cast<sizeint>(key.GetHashCode());
+				} else {
+					return std::hash<TKey>{}(key);
+				}
+			}
+		};
+		std::unordered_map<TKey, TValue, Hash> map{};
+
+		bool Add(const TKey& key, const TValue& value) {
+			return map.emplace(key, value).second;
+		}
+		bool TryGet(const TKey& key, TValue& value) const {
+			auto found = map.find(key);
+			if (found == map.end()) {
+				return false;
+			}
+			value = found->second;
+			return true;
+		}
+		bool Remove(const TKey& key) {
+			return map.erase(key) > 0;
+		}
+	};
+}
+
 TEST_SUITE("Collections") {
 	TEST_CASE("Dictionary") {
 		{
@@ -72,4 +120,182 @@ TEST_SUITE("Collections") {
 			CHECK(result);
 		}
 	}
-}
\ No newline at end of file
+	TEST_CASE("Dictionary allocators") {
+		SUBCASE("Every block is given back") {
+			{
+				Dictionary<int32, MemoryObject, CountingAllocator> dic{};
+				for (int32 i = 0; i < 100; i += 1) {
+					CHECK(dic.Add(i, MemoryObject(i)));
+				}
+				CHECK(CountingAllocator::liveCount == 1);
+
+				Dictionary<int32, MemoryObject, CountingAllocator> copy = dic;
+				CHECK(copy.Get(42).Get() == 42);
+				copy = dic;
+				Dictionary<int32, MemoryObject, CountingAllocator> moved = Memory::Move(copy);
+				CHECK(moved.Get(99).Get() == 99);
+				CHECK(CountingAllocator::liveCount == 2);
+			}
+			CHECK(CountingAllocator::liveCount == 0);
+		}
+		SUBCASE("Frame arena") {
+			FrameArena arena{};
+			FrameArena::SetCurrent(&arena);
+			{
+				Dictionary<int32, int32, FrameAllocator> dic{};
+				for (int32 i = 0; i < 100; i += 1) {
+					dic.Set(i, i * 2);
+				}
+				CHECK(dic.Get(50) == 100);
+				CHECK(arena.GetUsedSize() > 0);
+			}
+			FrameArena::SetCurrent(nullptr);
+		}
+	}
+	TEST_CASE("Dictionary probing") {
+		SUBCASE("Growing and removing") {
+			Dictionary<int32, int32> dic{};
+			for (int32 i = 0; i < 10000; i += 1) {
+				CHECK(dic.Add(i, i * 3));
+			}
+			CHECK(dic.GetCount() == 10000);
+			CHECK(dic.GetCapacity() == 16384);
+
+			for (int32 i = 0; i < 10000; i += 2) {
+				CHECK(dic.Remove(i));
+			}
+			CHECK(dic.GetCount() == 5000);
+			CHECK(!dic.Remove(0));
+			for (int32 i = 0; i < 10000; i += 1) {
+				int32 value = -1;
+				CHECK(dic.TryGet(i, value) == (i % 2 == 1));
+				if (i % 2 == 1) {
+					CHECK(value == i * 3);
+				}
+			}
+
+			int32 visited = 0;
+			for (const auto& entry : dic) {
+				CHECK(entry.key % 2 == 1);
+				CHECK(entry.value == entry.key * 3);
+				visited += 1;
+			}
+			CHECK(visited == 5000);
+
+			dic.Clear();
+			CHECK(dic.GetCount() == 0);
+			CHECK(!dic.ContainsKey(1));
+			CHECK(!(dic.begin() != dic.end()));
+		}
+		SUBCASE("Deleted slots are reused") {
+			// Sliding window of keys, the table must not keep growing from deleted slots.
+			Dictionary<int32, int32> dic{};
+			for (int32 i = 0; i < 100000; i += 1) {
+				dic.Add(i, i);
+				if (i >= 50) {
+					CHECK(dic.Remove(i - 50));
+				}
+			}
+			CHECK(dic.GetCount() == 50);
+			CHECK(dic.GetCapacity() <= 128);
+			for (int32 i = 100000 - 50; i < 100000; i += 1) {
+				CHECK(dic.Get(i) == i);
+			}
+		}
+		SUBCASE("Colliding hashes") {
+			Dictionary<CollidingKey, int32> dic{};
+			for (int32 i = 0; i < 200; i += 1) {
+				CHECK(dic.Add(CollidingKey{ i }, i));
+			}
+			for (int32 i = 0; i < 200; i += 3) {
+				CHECK(dic.Remove(CollidingKey{ i }));
+			}
+			for (int32 i = 0; i < 200; i += 1) {
+				CHECK(dic.ContainsKey(CollidingKey{ i }) == (i % 3 != 0));
+			}
+			dic.Set(CollidingKey{ 1 }, 100);
+			CHECK(dic.Get(CollidingKey{ 1 }) == 100);
+		}
+		SUBCASE("Lookup by view and hash code") {
+			Dictionary<String, int32> dic{};
+			dic.Add(STRL("Update"), 1);
+			dic.Add(String(u8"Physics").Substring(0, 4), 2);
+
+			int32 value = 0;
+			CHECK(dic.TryGet(std::u8string_view(u8"Update"), value));
+			CHECK(value == 1);
+			CHECK(dic.ContainsKey(std::u8string_view(u8"Phys")));
+			CHECK(!dic.ContainsKey(std::u8string_view(u8"Physics")));
+
+			String name = STRL("Phys");
+			CHECK(dic.TryGetWithHash(name, name.GetHashCode(), value));
+			CHECK(value == 2);
+			CHECK(dic.TryGetWithHash(std::u8string_view(u8"Update"), String::GetHashCode(u8"Update"), value));
+			CHECK(value == 1);
+		}
+		SUBCASE("Capacity") {
+			Dictionary<String, int32> dic{ 100 };
+			CHECK(dic.GetCapacity() == 128);
+			dic.Set(STRL("A"), 1);
+			CHECK(dic.SetCapacity(1));
+			CHECK(dic.GetCapacity() == 16);
+			CHECK(dic.Get(STRL("A")) == 1);
+		}
+	}
+}
+
+TEST_SUITE("Benchmark" * doctest::skip()) {
+	TEST_CASE("Dictionary lookup") {
+		constexpr int32 count = 10000;
+		constexpr int32 rounds = 100;
+
+		List<String> names(count);
+		for (int32 i = 0; i < count; i += 1) {
+			names.Add(String::Format(STRL("Property{0}"), i));
+		}
+
+		// Add every key, look all of them up with as many misses, then remove them.
+		auto measure = [&]<typename TInt, typename TString>(double& lookup, double& change) {
+			double lookupTime = 0;
+			double changeTime = 0;
+			int64 found = 0;
+			for (int32 round = 0; round < rounds; round += 1) {
+				TInt ints{};
+				TString strings{};
+				auto start = std::chrono::steady_clock::now();
+				for (int32 i = 0; i < count; i += 1) {
+					ints.Add(i * 7, i);
+					strings.Add(names.GetRawElementPtr()[i], i);
+				}
+				auto added = std::chrono::steady_clock::now();
+				int32 value = 0;
+				for (int32 i = 0; i < count * 2; i += 1) {
+					found += ints.TryGet(i * 7, value);
+					found += strings.TryGet(names.GetRawElementPtr()[i % count], value);
+				}
+				auto looked = std::chrono::steady_clock::now();
+				for (int32 i = 0; i < count; i += 1) {
+					ints.Remove(i * 7);
+					strings.Remove(names.GetRawElementPtr()[i]);
+				}
+				auto removed = std::chrono::steady_clock::now();
+
+				lookupTime += std::chrono::duration<double, std::nano>(looked - added).count();
+				changeTime += std::chrono::duration<double, std::nano>((added - start) + (removed - looked)).count();
+			}
+			CHECK(found == static_cast<int64>(count) * 3 * rounds);
+			lookup = lookupTime / (static_cast<double>(count) * 4 * rounds);
+			change = changeTime / (static_cast<double>(count) * 4 * rounds);
+		};
+
+		double stdLookup = 0, stdChange = 0;
+		measure.template operator()<StdDictionary<int32, int32>, StdDictionary<String, int32>>(stdLookup, stdChange);
+		double lookup = 0, change = 0;
+		measure.template operator()<Dictionary<int32, int32>, Dictionary<String, int32>>(lookup, change);
+
+		INFO_MSG(String::Format(
+			STRL("Int and String keys, std::unordered_map: {0:.1f} ns/lookup, {1:.1f} ns/change, Dictionary: {2:.1f} ns/lookup, {3:.1f} ns/change"),
+			stdLookup, stdChange, lookup, change
+		).GetRawArray());
+	}
+}
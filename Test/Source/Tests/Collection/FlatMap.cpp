@@ -0,0 +1,266 @@
+#include "doctest.h"
+#include "Engine/System/Collection/FlatMap.h"
+#include "Engine/System/Collection/FlatSet.h"
+#include "Engine/System/Collection/Dictionary.h"
+#include "Engine/System/String.h"
+#include "../System/MemoryObject.h"
+#include "../System/CountingAllocator.h"
+#include <chrono>
+#include <cstring>
+#include <random>
+
+using namespace Engine;
+
+namespace {
+	/// @brief Keys in pairs share a hash code.
+	struct PairedKey {
+		int32 value = 0;
+
+		int32 GetHashCode() const {
+			return value / 2;
+		}
+		bool operator==(const PairedKey& obj) const {
+			return value == obj.value;
+		}
+	};
+
+	/// @brief A container allocation policy counting the live bytes.
+	class ByteCountingAllocator {
+	public:
+		STATIC_CLASS(ByteCountingAllocator);
+
+		static void* Allocate(sizeint size) {
+			liveBytes += static_cast<int64>(size);
+			byte* block = (byte*)Memory::Allocate(size + HeaderSize);
+			*reinterpret_cast<sizeint*>(block) = size;
+			return block + HeaderSize;
+		}
+		static void* Reallocate(void* ptr, sizeint oldSize, sizeint newSize) {
+			void* result = Allocate(newSize);
+			std::memcpy(result, ptr, oldSize < newSize ? oldSize : newSize);
+			Deallocate(ptr);
+			return result;
+		}
+		static void Deallocate(void* ptr) {
+			if (ptr == nullptr) {
+				return;
+			}
+			byte* block = (byte*)ptr - HeaderSize;
+			liveBytes -= static_cast<int64>(*reinterpret_cast<sizeint*>(block));
+			Memory::Deallocate(block);
+		}
+
+		static inline int64 liveBytes = 0;
+	private:
+		static constexpr sizeint HeaderSize = 16;
+	};
+}
+
+TEST_SUITE("Collections") {
+	TEST_CASE("FlatMap") {
+		SUBCASE("Sorted adds") {
+			FlatMap<String, int32> map{};
+			CHECK(map.Add(STRL("Update"), 1));
+			CHECK(map.Add(STRL("Physics"), 2));
+			CHECK(map.Add(STRL("Draw"), 3));
+			CHECK(map.GetCount() == 3);
+			CHECK(!map.Add(STRL("Draw"), 4));
+			CHECK(map.Get(STRL("Draw")) == 3);
+			map.Set(STRL("Draw"), 4);
+			CHECK(map.Get(STRL("Draw")) == 4);
+
+			int32 value = 0;
+			CHECK(!map.TryGet(STRL("Ready"), value));
+			CHECK(map.TryGet(std::u8string_view(u8"Update"), value));
+			CHECK(value == 1);
+			CHECK(map.ContainsKey(std::u8string_view(u8"Physics")));
+			String name = STRL("Physics");
+			CHECK(map.TryGetWithHash(name, name.GetHashCode(), value));
+			CHECK(value == 2);
+
+			// Entries are walked in the order of their hash codes.
+			uint32 last = 0;
+			int32 count = 0;
+			for (const auto& entry : map) {
+				uint32 hash = static_cast<uint32>(entry.key.GetHashCode());
+				CHECK(hash >= last);
+				last = hash;
+				count += 1;
+			}
+			CHECK(count == 3);
+
+			CHECK(map.Remove(STRL("Update")));
+			CHECK(!map.Remove(STRL("Update")));
+			CHECK(!map.ContainsKey(STRL("Update")));
+			CHECK(map.GetCount() == 2);
+		}
+		SUBCASE("Shared hash codes") {
+			FlatMap<PairedKey, int32> map{};
+			for (int32 i = 0; i < 20; i += 1) {
+				CHECK(map.Add(PairedKey{ 19 - i }, i));
+			}
+			for (int32 i = 0; i < 20; i += 3) {
+				CHECK(map.Remove(PairedKey{ i }));
+			}
+			for (int32 i = 0; i < 20; i += 1) {
+				int32 value = -1;
+				CHECK(map.TryGet(PairedKey{ i }, value) == (i % 3 != 0));
+				if (i % 3 != 0) {
+					CHECK(value == 19 - i);
+				}
+			}
+		}
+		SUBCASE("Build and freeze") {
+			FlatMap<int32, int32> map{};
+			std::mt19937 random(3);
+			for (int32 i = 0; i < 500; i += 1) {
+				map.AddUnsorted(static_cast<int32>(random()), i);
+			}
+			CHECK(map.Build());
+			CHECK(map.GetCount() == 500);
+
+			random.seed(3);
+			for (int32 i = 0; i < 500; i += 1) {
+				CHECK(map.Get(static_cast<int32>(random())) == i);
+			}
+
+			// Duplicates keep the first value.
+			map.AddUnsorted(5, 1);
+			map.AddUnsorted(5, 2);
+			map.AddUnsorted(6, 3);
+			CHECK(!map.Build());
+			CHECK(map.Get(5) == 1);
+			CHECK(map.Get(6) == 3);
+
+			map.Freeze();
+			CHECK(map.GetCapacity() == map.GetCount());
+			CHECK(map.Add(7, 4));
+			CHECK(map.Get(7) == 4);
+		}
+		SUBCASE("Looks up the same as Dictionary") {
+			FlatMap<int32, int32> map{};
+			Dictionary<int32, int32> dictionary{};
+			std::mt19937 random(11);
+			for (int32 i = 0; i < 5000; i += 1) {
+				int32 key = static_cast<int32>(random() % 1000);
+				switch (random() % 3) {
+				case 0:
+					CHECK(map.Remove(key) == dictionary.Remove(key));
+					break;
+				default:
+					map.Set(key, i);
+					dictionary.Set(key, i);
+					break;
+				}
+			}
+			CHECK(map.GetCount() == dictionary.GetCount());
+			for (int32 key = 0; key < 1000; key += 1) {
+				int32 expected = -1, value = -1;
+				CHECK(map.TryGet(key, value) == dictionary.TryGet(key, expected));
+				CHECK(value == expected);
+			}
+		}
+		SUBCASE("Values are freed") {
+			CountingAllocator::liveCount = 0;
+			{
+				FlatMap<int32, MemoryObject, CountingAllocator> map{};
+				for (int32 i = 0; i < 40; i += 1) {
+					map.AddUnsorted(i % 30, MemoryObject(i));
+				}
+				CHECK(!map.Build());
+				map.Freeze();
+				CHECK(map.GetCount() == 30);
+				CHECK(map.Get(3).Get() == 3);
+				CHECK(map.Remove(3));
+				map.Clear();
+				CHECK(map.GetCount() == 0);
+			}
+			CHECK(CountingAllocator::liveCount == 0);
+		}
+	}
+	TEST_CASE("FlatSet") {
+		FlatSet<String> set{};
+		CHECK(set.Add(STRL("a")));
+		CHECK(set.Add(STRL("b")));
+		CHECK(!set.Add(STRL("a")));
+		set.AddUnsorted(STRL("c"));
+		set.AddUnsorted(STRL("b"));
+		CHECK(!set.Build());
+		CHECK(set.GetCount() == 3);
+		CHECK(set.Contains(STRL("c")));
+		CHECK(set.Contains(std::u8string_view(u8"b")));
+		CHECK(!set.Contains(STRL("d")));
+
+		set.Freeze();
+		CHECK(set.GetCapacity() == 3);
+		CHECK(set.Remove(STRL("a")));
+		CHECK(!set.Contains(STRL("a")));
+
+		FlatSet<PairedKey> paired{};
+		for (int32 i = 0; i < 10; i += 1) {
+			paired.AddUnsorted(PairedKey{ i });
+		}
+		CHECK(paired.Build());
+		for (int32 i = 0; i < 10; i += 1) {
+			CHECK(paired.Contains(PairedKey{ i }));
+		}
+		CHECK(!paired.Contains(PairedKey{ 10 }));
+	}
+}
+
+TEST_SUITE("Benchmark" * doctest::skip()) {
+	TEST_CASE("FlatMap lookup and size") {
+		constexpr int32 lookups = 1000000;
+		constexpr int32 counts[] = { 8, 32, 128, 1024 };
+
+		// Tables the size of reflection tables, keyed by member names.
+		for (int32 count : counts) {
+			List<String> names(count);
+			for (int32 i = 0; i < count; i += 1) {
+				names.Add(String::Format(STRL("Member{0}"), i));
+			}
+
+			ByteCountingAllocator::liveBytes = 0;
+			FlatMap<String, int32, ByteCountingAllocator> map{};
+			for (int32 i = 0; i < count; i += 1) {
+				map.AddUnsorted(names.Get(i), i);
+			}
+			map.Freeze();
+			int64 mapBytes = ByteCountingAllocator::liveBytes;
+			Dictionary<String, int32, ByteCountingAllocator> dictionary{};
+			for (int32 i = 0; i < count; i += 1) {
+				dictionary.Add(names.Get(i), i);
+			}
+			int64 dictionaryBytes = ByteCountingAllocator::liveBytes - mapBytes;
+
+			// Hash every name up front, lookups along the class tree reuse the hash code too.
+			// The names are looked up scattered, not in the order of the table.
+			List<int32> hashCodes(count);
+			for (int32 i = 0; i < count; i += 1) {
+				hashCodes.Add(names.Get(i).GetHashCode());
+			}
+
+			int64 found = 0;
+			int32 value = 0;
+			auto start = std::chrono::steady_clock::now();
+			for (int32 i = 0; i < lookups; i += 1) {
+				int32 index = static_cast<int32>((static_cast<uint32>(i) * 2654435761u) % count);
+				found += map.TryGetWithHash(names.GetRawElementPtr()[index], hashCodes.GetRawElementPtr()[index], value);
+			}
+			auto mapped = std::chrono::steady_clock::now();
+			for (int32 i = 0; i < lookups; i += 1) {
+				int32 index = static_cast<int32>((static_cast<uint32>(i) * 2654435761u) % count);
+				found += dictionary.TryGetWithHash(names.GetRawElementPtr()[index], hashCodes.GetRawElementPtr()[index], value);
+			}
+			auto looked = std::chrono::steady_clock::now();
+			CHECK(found == static_cast<int64>(lookups) * 2);
+
+			INFO_MSG(String::Format(
+				STRL("{0} entries, FlatMap: {1:.2f} ns/lookup {2} bytes, Dictionary: {3:.2f} ns/lookup {4} bytes"),
+				count,
+				std::chrono::duration<double, std::nano>(mapped - start).count() / lookups, mapBytes,
+				std::chrono::duration<double, std::nano>(looked - mapped).count() / lookups, dictionaryBytes
+			).GetRawArray());
+		}
+	}
+}
@@ -0,0 +1,151 @@
+#include "doctest.h"
+#include "Engine/System/Collection/InlineList.h"
+#include "Engine/System/Collection/List.h"
+#include "Engine/System/Memory/UniquePtr.h"
+#include "Engine/System/Object/Variant.h"
+#include "Engine/System/String.h"
+#include "../System/MemoryObject.h"
+#include "../System/CountingAllocator.h"
+#include <chrono>
+
+using namespace Engine;
+
+TEST_SUITE("Collections") {
+	TEST_CASE("InlineList") {
+		SUBCASE("Inline and spilled") {
+			CountingAllocator::liveCount = 0;
+			{
+				InlineList<MemoryObject, 4, CountingAllocator> list{};
+				for (int32 i = 0; i < 4; i += 1) {
+					list.Add(MemoryObject(i));
+				}
+				CHECK(!list.IsSpilled());
+				CHECK(list.GetCapacity() == 4);
+				CHECK(CountingAllocator::liveCount == 0);
+
+				list.Add(MemoryObject(4));
+				CHECK(list.IsSpilled());
+				CHECK(list.GetCapacity() == 8);
+				CHECK(CountingAllocator::liveCount == 1);
+
+				// 0 1 2 3 4 -> 0 2 3 100 4
+				list.RemoveAt(1);
+				list.Insert(3, MemoryObject(100));
+				int32 expected[] = { 0, 2, 3, 100, 4 };
+				REQUIRE(list.GetCount() == 5);
+				for (int32 i = 0; i < list.GetCount(); i += 1) {
+					CHECK(list.Get(i).Get() == expected[i]);
+				}
+
+				// Back inline once it fits again.
+				list.RemoveAt(0);
+				list.SetCapacity(list.GetCount());
+				CHECK(!list.IsSpilled());
+				CHECK(CountingAllocator::liveCount == 0);
+				CHECK(list.Get(0).Get() == 2);
+				CHECK(list.Get(3).Get() == 4);
+
+				int32 i = 0;
+				for (const auto& value : list) {
+					CHECK(value.Get() == expected[i + 1]);
+					i += 1;
+				}
+				CHECK(i == 4);
+			}
+			CHECK(CountingAllocator::liveCount == 0);
+		}
+		SUBCASE("Copy and move") {
+			CountingAllocator::liveCount = 0;
+			{
+				InlineList<String, 2, CountingAllocator> small{ STRL("A"), STRL("B") };
+				InlineList<String, 2, CountingAllocator> large{ STRL("A"), STRL("B"), STRL("C") };
+				CHECK(!small.IsSpilled());
+				CHECK(large.IsSpilled());
+
+				InlineList<String, 2, CountingAllocator> copied = large;
+				CHECK(copied.GetCount() == 3);
+				CHECK(copied.Get(2) == STRL("C"));
+				CHECK(CountingAllocator::liveCount == 2);
+
+				// Moving a spilled list hands over its block.
+				InlineList<String, 2, CountingAllocator> moved = Memory::Move(copied);
+				CHECK(moved.Get(2) == STRL("C"));
+				CHECK(copied.GetCount() == 0);
+				CHECK(!copied.IsSpilled());
+				CHECK(CountingAllocator::liveCount == 2);
+
+				// Moving an inline list moves the elements.
+				moved = Memory::Move(small);
+				CHECK(!moved.IsSpilled());
+				CHECK(moved.GetCount() == 2);
+				CHECK(moved.Get(1) == STRL("B"));
+				CHECK(CountingAllocator::liveCount == 1);
+
+				copied = moved;
+				CHECK(copied.Get(0) == STRL("A"));
+				copied = copied;
+				CHECK(copied.GetCount() == 2);
+			}
+			CHECK(CountingAllocator::liveCount == 0);
+		}
+		SUBCASE("Move only values") {
+			InlineList<UniquePtr<int32>, 2> list{};
+			for (int32 i = 0; i < 5; i += 1) {
+				list.Emplace(MEMNEW(int32(i)));
+			}
+			list.Insert(0, UniquePtr<int32>(MEMNEW(int32(-1))));
+			list.RemoveAt(3);
+
+			InlineList<UniquePtr<int32>, 2> moved = Memory::Move(list);
+			int32 expected[] = { -1, 0, 1, 3, 4 };
+			REQUIRE(moved.GetCount() == 5);
+			for (int32 i = 0; i < moved.GetCount(); i += 1) {
+				CHECK(*moved.GetRawElementPtr()[i] == expected[i]);
+			}
+		}
+	}
+}
+
+TEST_SUITE("Benchmark" * doctest::skip()) {
+	TEST_CASE("Small list allocations") {
+		constexpr int32 rounds = 100000;
+
+		// Fill lists shaped like node children, node path names and signal extra arguments.
+		auto measure = [](auto fill, double& allocations) {
+			CountingAllocator::allocationCount = 0;
+			auto start = std::chrono::steady_clock::now();
+			for (int32 round = 0; round < rounds; round += 1) {
+				fill();
+			}
+			auto duration = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+			allocations = static_cast<double>(CountingAllocator::allocationCount) / rounds;
+			return duration / rounds;
+		};
+		auto fill = []<typename TNodes, typename TNames, typename TArguments>() {
+			TNodes children{};
+			children.Add(nullptr);
+			children.Add(nullptr);
+			TNames names{};
+			names.Add(STRL("root"));
+			names.Add(STRL("Player"));
+			names.Add(STRL("Sprite"));
+			TArguments arguments{};
+			arguments.Add(Variant(static_cast<int64>(1)));
+		};
+
+		double listAllocations = 0;
+		double list = measure([&]() {
+			fill.template operator()<List<void*, CountingAllocator>, List<String, CountingAllocator>, List<Variant, CountingAllocator>>();
+		}, listAllocations);
+		double inlineAllocations = 0;
+		double inlineList = measure([&]() {
+			fill.template operator()<InlineList<void*, 4, CountingAllocator>, InlineList<String, 4, CountingAllocator>, InlineList<Variant, 2, CountingAllocator>>();
+		}, inlineAllocations);
+
+		INFO_MSG(String::Format(
+			STRL("Children, names and extra arguments, List: {0:.1f} ns, {1:.1f} allocations, InlineList: {2:.1f} ns, {3:.1f} allocations"),
+			list, listAllocations, inlineList, inlineAllocations
+		).GetRawArray());
+		CHECK(inlineAllocations < listAllocations);
+	}
+}
@@ -1,9 +1,51 @@
 #include "doctest.h"
 #include "Engine/System/Collection/List.h"
+#include "Engine/System/Memory/UniquePtr.h"
+#include "Engine/System/Memory/SharedPtr.h"
+#include "Engine/System/String.h"
 #include "../System/MemoryObject.h"
 
 using namespace Engine;
 
+namespace {
+	/// @brief Knows its own address, so it must never be moved as raw bytes.
+	class SelfPointing {
+	public:
+		SelfPointing(int32 value = 0) :value(value) {}
+		SelfPointing(const SelfPointing& obj) :value(obj.value) {
+			copyCount += 1;
+		}
+		SelfPointing(SelfPointing&& obj) :value(obj.value) {
+			obj.value = -1;
+		}
+		SelfPointing& operator=(const SelfPointing& obj) {
+			value = obj.value;
+			copyCount += 1;
+			return *this;
+		}
+		SelfPointing& operator=(SelfPointing&& obj) {
+			value = obj.value;
+			obj.value = -1;
+			return *this;
+		}
+
+		bool IsInPlace() const {
+			return self == this;
+		}
+
+		int32 value;
+		static inline int32 copyCount = 0;
+	private:
+		const SelfPointing* self = this;
+	};
+}
+
+static_assert(Memory::IsTriviallyRelocatable<int32>());
+static_assert(Memory::IsTriviallyRelocatable<String>());
+static_assert(Memory::IsTriviallyRelocatable<SharedPtr<int32>>());
+static_assert(Memory::IsTriviallyRelocatable<List<String>>());
+static_assert(!Memory::IsTriviallyRelocatable<SelfPointing>());
+
 TEST_SUITE("Collections") {
 	TEST_CASE("List") {
 		List<MemoryObject> list{};
@@ -70,4 +112,98 @@ TEST_SUITE("Collections") {
 
 		List<MemoryObject> list4 = Memory::Move(list);
 	}
-}
\ No newline at end of file
+
+	TEST_CASE("List copies") {
+		SUBCASE("Copy-assigning an empty list") {
+			List<MemoryObject> list{};
+			list.Add(MemoryObject(1));
+			List<MemoryObject> empty{};
+			list = empty;
+			CHECK(list.GetCount() == 0);
+
+			list.Add(MemoryObject(2));
+			CHECK(list.GetCount() == 1);
+			CHECK(list.Get(0).Get() == 2);
+		}
+	}
+
+	TEST_CASE("List moves") {
+		SUBCASE("Move only values") {
+			List<UniquePtr<int32>> list{};
+			for (int32 i = 0; i < 10; i += 1) {
+				list.Add(UniquePtr<int32>(MEMNEW(int32(i))));
+			}
+			list.Emplace(MEMNEW(int32(10)));
+			list.Insert(0, UniquePtr<int32>(MEMNEW(int32(-1))));
+			list.RemoveAt(5);
+
+			// -1 0 1 2 3 5 6 7 8 9 10
+			int32 expected[] = { -1, 0, 1, 2, 3, 5, 6, 7, 8, 9, 10 };
+			REQUIRE(list.GetCount() == 11);
+			for (int32 i = 0; i < list.GetCount(); i += 1) {
+				CHECK(*list.GetRawElementPtr()[i] == expected[i]);
+			}
+		}
+		SUBCASE("Shifting does not copy") {
+			SelfPointing::copyCount = 0;
+			List<SelfPointing> list{};
+			for (int32 i = 0; i < 20; i += 1) {
+				list.Emplace(i);
+			}
+			list.Insert(3, SelfPointing(100));
+			list.Insert(0, SelfPointing(200));
+			list.RemoveAt(10);
+			list.RemoveAt(0);
+			list.SetCapacity(100);
+			CHECK(SelfPointing::copyCount == 0);
+
+			// 0 1 2 100 3 4 5 6 7 9 ... 19
+			REQUIRE(list.GetCount() == 20);
+			const SelfPointing* elements = list.GetRawElementPtr();
+			for (int32 i = 0; i < list.GetCount(); i += 1) {
+				CHECK(elements[i].IsInPlace());
+			}
+			CHECK(elements[2].value == 2);
+			CHECK(elements[3].value == 100);
+			CHECK(elements[4].value == 3);
+			CHECK(elements[8].value == 7);
+			CHECK(elements[9].value == 9);
+			CHECK(elements[19].value == 19);
+		}
+		SUBCASE("Relocating keeps references") {
+			SharedPtr<int32> shared = SharedPtr<int32>::Create(1);
+			List<SharedPtr<int32>> list{};
+			for (int32 i = 0; i < 20; i += 1) {
+				list.Insert(0, shared);
+			}
+			CHECK(shared.GetReferenceCount() == 21);
+			for (int32 i = 0; i < 10; i += 1) {
+				list.RemoveAt(list.GetCount() / 2);
+			}
+			CHECK(shared.GetReferenceCount() == 11);
+			list.Clear();
+			CHECK(shared.GetReferenceCount() == 1);
+
+			List<String> strings{};
+			for (int32 i = 0; i < 10; i += 1) {
+				strings.Insert(0, String::Format(STRL("{0}"), i));
+			}
+			CHECK(strings.Get(0) == STRL("9"));
+			CHECK(strings.Get(9) == STRL("0"));
+		}
+		SUBCASE("Adding an element of the same list") {
+			List<String> list{};
+			list.Add(STRL("First"));
+			while (list.GetCount() < list.GetCapacity()) {
+				list.Add(STRL("Filler"));
+			}
+			// Full, the element must survive the growth.
+			list.Add(list.GetRawElementPtr()[0]);
+			CHECK(list.Get(list.GetCount() - 1) == STRL("First"));
+
+			list.Insert(0, list.GetRawElementPtr()[1]);
+			CHECK(list.Get(0) == STRL("Filler"));
+			CHECK(list.Get(1) == STRL("First"));
+		}
+	}
+}
@@ -0,0 +1,97 @@
+#include "doctest.h"
+#include "Engine/System/Collection/MpmcQueue.h"
+#include "Engine/System/Memory/SharedPtr.h"
+#include "Engine/System/Memory/UniquePtr.h"
+#include "Engine/System/String.h"
+#include "../System/CountingAllocator.h"
+#include "ProducerConsumer.h"
+
+using namespace Engine;
+
+TEST_SUITE("Collections") {
+	TEST_CASE("MpmcQueue") {
+		SUBCASE("First in first out") {
+			MpmcQueue<int32> queue(5);
+			CHECK(queue.GetCapacity() == 8);
+			CHECK(queue.IsEmpty());
+
+			int32 value = 0;
+			CHECK(!queue.TryPop(value));
+			for (int32 i = 0; i < 8; i += 1) {
+				CHECK(queue.TryPush(i));
+			}
+			CHECK(!queue.TryPush(8));
+			CHECK(queue.GetCount() == 8);
+
+			// Go round the ring a few times.
+			for (int32 i = 0; i < 100; i += 1) {
+				REQUIRE(queue.TryPop(value));
+				CHECK(value == i);
+				CHECK(queue.TryPush(i + 8));
+			}
+			for (int32 i = 100; i < 108; i += 1) {
+				REQUIRE(queue.TryPop(value));
+				CHECK(value == i);
+			}
+			CHECK(!queue.TryPop(value));
+		}
+		SUBCASE("Values left are destructed") {
+			CountingAllocator::liveCount = 0;
+			SharedPtr<int32> shared = SharedPtr<int32>::Create(1);
+			{
+				MpmcQueue<SharedPtr<int32>, CountingAllocator> queue(4);
+				CHECK(CountingAllocator::liveCount == 1);
+				queue.TryPush(shared);
+				queue.TryPush(shared);
+				queue.TryPush(shared);
+				SharedPtr<int32> popped;
+				CHECK(queue.TryPop(popped));
+				CHECK(shared.GetReferenceCount() == 4);
+			}
+			CHECK(shared.GetReferenceCount() == 1);
+			CHECK(CountingAllocator::liveCount == 0);
+		}
+		SUBCASE("Move only values") {
+			MpmcQueue<UniquePtr<int32>> queue(4);
+			CHECK(queue.TryEmplace(MEMNEW(int32(1))));
+			CHECK(queue.TryPush(UniquePtr<int32>(MEMNEW(int32(2)))));
+			UniquePtr<int32> value;
+			CHECK(queue.TryPop(value));
+			CHECK(*value == 1);
+			CHECK(queue.TryPop(value));
+			CHECK(*value == 2);
+		}
+		SUBCASE("Several producers and consumers") {
+			constexpr int64 count = 50000;
+			MpmcQueue<int64> queue(64);
+			int32 outOfOrder = 0;
+			int64 sum = 0;
+			RunProducersAndConsumers(queue, 4, 4, count, outOfOrder, sum);
+
+			int64 all = count * 4;
+			CHECK(outOfOrder == 0);
+			CHECK(sum == all * (all - 1) / 2);
+			CHECK(queue.IsEmpty());
+		}
+	}
+}
+
+TEST_SUITE("Benchmark" * doctest::skip()) {
+	TEST_CASE("MpmcQueue throughput") {
+		constexpr int64 count = 200000;
+		constexpr int32 shapes[][2] = { { 1, 1 }, { 1, 4 }, { 4, 1 }, { 2, 2 }, { 4, 4 }, { 8, 8 } };
+
+		for (const auto& shape : shapes) {
+			int32 outOfOrder = 0;
+			int64 sum = 0;
+			LockedQueue<int64> locked(1024);
+			double lockedRate = RunProducersAndConsumers(locked, shape[0], shape[1], count, outOfOrder, sum);
+			MpmcQueue<int64> queue(1024);
+			double rate = RunProducersAndConsumers(queue, shape[0], shape[1], count, outOfOrder, sum);
+			INFO_MSG(String::Format(
+				STRL("{0} producers, {1} consumers, locked Deque: {2:.2f} M values/s, MpmcQueue: {3:.2f} M values/s"),
+				shape[0], shape[1], lockedRate, rate
+			).GetRawArray());
+		}
+	}
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include "Engine/System/Collection/Deque.h"
+#include "Engine/System/Thread/ThreadUtil.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace Engine {
+	/// @brief A Deque behind a mutex, like the JobSystem queues. The baseline of the queue benchmarks.
+	template<typename T>
+	class LockedQueue {
+	public:
+		LockedQueue(int32 capacity) :capacity(capacity) {}
+
+		bool TryPush(const T& value) {
+			auto lock = SimpleLock<Mutex>(mutex);
+			if (deque.GetCount() >= capacity) {
+				return false;
+			}
+			deque.PushBack(value);
+			return true;
+		}
+		bool TryPop(T& result) {
+			auto lock = SimpleLock<Mutex>(mutex);
+			return deque.TryPopFront(result);
+		}
+
+	private:
+		Mutex mutex;
+		Deque<T> deque{};
+		int32 capacity;
+	};
+
+	/// @brief Push count values from each producer and pop them all with the consumers.
+	/// Values are producer * count + index, a consumer must see the values of a producer in order.
+	/// @return Values moved per microsecond.
+	template<typename TQueue>
+	inline double RunProducersAndConsumers(TQueue& queue, int32 producerCount, int32 consumerCount, int64 count, int32& outOfOrder, int64& sum) {
+		std::atomic<int64> popped{ 0 };
+		std::atomic<int64> total{ 0 };
+		std::atomic<int32> misordered{ 0 };
+		int64 expected = count * producerCount;
+
+		auto produce = [&queue, count](int64 producer) {
+			for (int64 i = 0; i < count; i += 1) {
+				while (!queue.TryPush(producer * count + i)) {
+					std::this_thread::yield();
+				}
+			}
+		};
+		auto consume = [&queue, &popped, &total, &misordered, count, expected, producerCount]() {
+			int64 last[16];
+			for (int32 i = 0; i < producerCount; i += 1) {
+				last[i] = -1;
+			}
+			int64 localSum = 0;
+			int64 value = 0;
+			while (popped.load(std::memory_order_relaxed) < expected) {
+				if (!queue.TryPop(value)) {
+					std::this_thread::yield();
+					continue;
+				}
+				popped.fetch_add(1, std::memory_order_relaxed);
+				int64 producer = value / count;
+				if (value <= last[producer]) {
+					misordered.fetch_add(1, std::memory_order_relaxed);
+				}
+				last[producer] = value;
+				localSum += value;
+			}
+			total.fetch_add(localSum, std::memory_order_relaxed);
+		};
+
+		auto start = std::chrono::steady_clock::now();
+		std::thread threads[32];
+		for (int32 i = 0; i < consumerCount; i += 1) {
+			threads[i] = std::thread(consume);
+		}
+		for (int32 i = 0; i < producerCount; i += 1) {
+			threads[consumerCount + i] = std::thread(produce, static_cast<int64>(i));
+		}
+		for (int32 i = 0; i < producerCount + consumerCount; i += 1) {
+			threads[i].join();
+		}
+		auto duration = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+		outOfOrder = misordered.load();
+		sum = total.load();
+		return static_cast<double>(expected) / duration;
+	}
+}
@@ -0,0 +1,187 @@
+#include "doctest.h"
+#include "Engine/System/Collection/SlotMap.h"
+#include "Engine/System/Collection/Dictionary.h"
+#include "Engine/System/Memory/UniquePtr.h"
+#include "Engine/System/String.h"
+#include "../System/MemoryObject.h"
+#include "../System/CountingAllocator.h"
+#include <chrono>
+#include <random>
+
+using namespace Engine;
+
+TEST_SUITE("Collections") {
+	TEST_CASE("SlotMap") {
+		SUBCASE("Handles survive other removes") {
+			SlotMap<String> map{};
+			SlotHandle a = map.Add(STRL("a"));
+			SlotHandle b = map.Add(STRL("b"));
+			SlotHandle c = map.Add(STRL("c"));
+			CHECK(map.GetCount() == 3);
+			CHECK(!a.IsNull());
+			CHECK(a != b);
+
+			// c moves into the place of a.
+			CHECK(map.Remove(a));
+			CHECK(map.GetCount() == 2);
+			CHECK(map.GetRawElementPtr()[0] == STRL("c"));
+			CHECK(map.GetHandle(0) == c);
+
+			String value;
+			CHECK(map.TryGet(b, value));
+			CHECK(value == STRL("b"));
+			REQUIRE(map.GetPtr(c) != nullptr);
+			*map.GetPtr(c) = STRL("C");
+			CHECK(map.TryGet(c, value));
+			CHECK(value == STRL("C"));
+
+			int32 count = 0;
+			for (const String& item : map) {
+				CHECK((item == STRL("b") || item == STRL("C")));
+				count += 1;
+			}
+			CHECK(count == 2);
+		}
+		SUBCASE("Stale handles are detected") {
+			SlotMap<int32> map{};
+			SlotHandle first = map.Add(1);
+			CHECK(map.Remove(first));
+			CHECK(!map.Contains(first));
+			CHECK(!map.Remove(first));
+			CHECK(map.GetPtr(first) == nullptr);
+
+			// The slot is reused with a new generation.
+			SlotHandle second = map.Add(2);
+			CHECK(second.index == first.index);
+			CHECK(second.generation != first.generation);
+			CHECK(!map.Contains(first));
+			CHECK(map.Contains(second));
+
+			int32 value = 0;
+			CHECK(!map.TryGet(SlotHandle(), value));
+			CHECK(!map.TryGet(SlotHandle{ 100, 1 }, value));
+			// A free slot never matches, whatever its generation.
+			CHECK(map.Remove(second));
+			CHECK(!map.Contains(SlotHandle{ second.index, second.generation + 1 }));
+
+			SlotHandle third = map.Add(3);
+			map.Clear();
+			CHECK(map.GetCount() == 0);
+			CHECK(!map.Contains(third));
+			CHECK(map.Contains(map.Add(4)));
+		}
+		SUBCASE("Random adds and removes") {
+			CountingAllocator::liveCount = 0;
+			{
+				SlotMap<MemoryObject, CountingAllocator> map{};
+				List<SlotHandle> live{};
+				List<int32> liveValues{};
+				List<SlotHandle> dead{};
+				std::mt19937 random(7);
+				for (int32 i = 0; i < 3000; i += 1) {
+					if (live.GetCount() == 0 || random() % 3 != 0) {
+						live.Add(map.Add(MemoryObject(i)));
+						liveValues.Add(i);
+					} else {
+						int32 picked = static_cast<int32>(random() % live.GetCount());
+						REQUIRE(map.Remove(live.Get(picked)));
+						dead.Add(live.Get(picked));
+						live.RemoveAt(picked);
+						liveValues.RemoveAt(picked);
+					}
+				}
+				REQUIRE(map.GetCount() == live.GetCount());
+				for (int32 i = 0; i < live.GetCount(); i += 1) {
+					const MemoryObject* value = map.GetPtr(live.Get(i));
+					REQUIRE(value != nullptr);
+					CHECK(value->Get() == liveValues.Get(i));
+				}
+				for (int32 i = 0; i < dead.GetCount(); i += 1) {
+					REQUIRE(!map.Contains(dead.Get(i)));
+				}
+				// Every dense value knows its handle.
+				for (int32 i = 0; i < map.GetCount(); i += 1) {
+					REQUIRE(map.GetPtr(map.GetHandle(i)) == map.GetRawElementPtr() + i);
+				}
+			}
+			CHECK(CountingAllocator::liveCount == 0);
+		}
+		SUBCASE("Move only values") {
+			SlotMap<UniquePtr<int32>> map{};
+			SlotHandle a = map.Emplace(MEMNEW(int32(1)));
+			SlotHandle b = map.Add(UniquePtr<int32>(MEMNEW(int32(2))));
+			CHECK(map.Remove(a));
+			CHECK(**map.GetPtr(b) == 2);
+		}
+	}
+}
+
+TEST_SUITE("Benchmark" * doctest::skip()) {
+	TEST_CASE("SlotMap lookup and iteration") {
+		constexpr int32 count = 10000;
+		constexpr int32 rounds = 100;
+
+		struct Body {
+			float position[3];
+			float velocity[3];
+		};
+
+		// Look every value up through its handle or its id, then walk the dense values or the scattered heap objects.
+		// A tenth of the values is replaced every round.
+		SlotMap<Body> map{};
+		List<SlotHandle> handles(count);
+		Dictionary<uint64, Body*> dictionary{};
+		List<uint64> ids(count);
+		List<Body*> pointers(count);
+		for (int32 i = 0; i < count; i += 1) {
+			handles.Add(map.Add(Body{}));
+			ids.Add(static_cast<uint64>(i) * 7919);
+			pointers.Add(MEMNEW(Body{}));
+			dictionary.Add(ids.Get(i), pointers.Get(i));
+		}
+
+		double mapLookup = 0, mapWalk = 0, dictionaryLookup = 0, pointerWalk = 0;
+		float sum = 0;
+		for (int32 round = 0; round < rounds; round += 1) {
+			for (int32 i = round % 10; i < count; i += 10) {
+				map.Remove(handles.Get(i));
+				handles.Set(i, map.Add(Body{}));
+			}
+
+			auto start = std::chrono::steady_clock::now();
+			for (int32 i = 0; i < count; i += 1) {
+				sum += map.GetPtr(handles.Get(i))->velocity[0];
+			}
+			auto looked = std::chrono::steady_clock::now();
+			for (const Body& body : map) {
+				sum += body.position[1];
+			}
+			auto walked = std::chrono::steady_clock::now();
+			Body* body = nullptr;
+			for (int32 i = 0; i < count; i += 1) {
+				dictionary.TryGet(ids.Get(i), body);
+				sum += body->velocity[0];
+			}
+			auto dictionaryLooked = std::chrono::steady_clock::now();
+			for (Body* pointer : pointers) {
+				sum += pointer->position[1];
+			}
+			auto pointersWalked = std::chrono::steady_clock::now();
+
+			mapLookup += std::chrono::duration<double, std::nano>(looked - start).count();
+			mapWalk += std::chrono::duration<double, std::nano>(walked - looked).count();
+			dictionaryLookup += std::chrono::duration<double, std::nano>(dictionaryLooked - walked).count();
+			pointerWalk += std::chrono::duration<double, std::nano>(pointersWalked - dictionaryLooked).count();
+		}
+		for (Body* pointer : pointers) {
+			MEMDEL(pointer);
+		}
+		CHECK(sum == 0);
+
+		double perValue = static_cast<double>(count) * rounds;
+		INFO_MSG(String::Format(
+			STRL("Lookup / walk, SlotMap: {0:.2f} / {1:.2f} ns per value, Dictionary by id / List of pointers: {2:.2f} / {3:.2f} ns per value"),
+			mapLookup / perValue, mapWalk / perValue, dictionaryLookup / perValue, pointerWalk / perValue
+		).GetRawArray());
+	}
+}
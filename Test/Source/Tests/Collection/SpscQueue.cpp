@@ -0,0 +1,93 @@
+#include "doctest.h"
+#include "Engine/System/Collection/SpscQueue.h"
+#include "Engine/System/Collection/MpmcQueue.h"
+#include "Engine/System/Memory/SharedPtr.h"
+#include "Engine/System/Memory/UniquePtr.h"
+#include "Engine/System/String.h"
+#include "../System/CountingAllocator.h"
+#include "ProducerConsumer.h"
+
+using namespace Engine;
+
+TEST_SUITE("Collections") {
+	TEST_CASE("SpscQueue") {
+		SUBCASE("First in first out") {
+			SpscQueue<int32> queue(3);
+			CHECK(queue.GetCapacity() == 4);
+			CHECK(queue.IsEmpty());
+
+			int32 value = 0;
+			CHECK(!queue.TryPop(value));
+			for (int32 i = 0; i < 4; i += 1) {
+				CHECK(queue.TryPush(i));
+			}
+			CHECK(!queue.TryPush(4));
+			CHECK(queue.GetCount() == 4);
+
+			for (int32 i = 0; i < 100; i += 1) {
+				REQUIRE(queue.TryPop(value));
+				CHECK(value == i);
+				CHECK(queue.TryPush(i + 4));
+			}
+			for (int32 i = 100; i < 104; i += 1) {
+				REQUIRE(queue.TryPop(value));
+				CHECK(value == i);
+			}
+			CHECK(!queue.TryPop(value));
+		}
+		SUBCASE("Values left are destructed") {
+			CountingAllocator::liveCount = 0;
+			SharedPtr<int32> shared = SharedPtr<int32>::Create(1);
+			{
+				SpscQueue<SharedPtr<int32>, CountingAllocator> queue(4);
+				queue.TryPush(shared);
+				queue.TryPush(shared);
+				SharedPtr<int32> popped;
+				CHECK(queue.TryPop(popped));
+				CHECK(shared.GetReferenceCount() == 3);
+			}
+			CHECK(shared.GetReferenceCount() == 1);
+			CHECK(CountingAllocator::liveCount == 0);
+		}
+		SUBCASE("Move only values") {
+			SpscQueue<UniquePtr<int32>> queue(2);
+			CHECK(queue.TryEmplace(MEMNEW(int32(1))));
+			CHECK(queue.TryPush(UniquePtr<int32>(MEMNEW(int32(2)))));
+			UniquePtr<int32> value;
+			CHECK(queue.TryPop(value));
+			CHECK(*value == 1);
+			CHECK(queue.TryPop(value));
+			CHECK(*value == 2);
+		}
+		SUBCASE("Producer and consumer threads") {
+			constexpr int64 count = 200000;
+			SpscQueue<int64> queue(64);
+			int32 outOfOrder = 0;
+			int64 sum = 0;
+			RunProducersAndConsumers(queue, 1, 1, count, outOfOrder, sum);
+
+			CHECK(outOfOrder == 0);
+			CHECK(sum == count * (count - 1) / 2);
+			CHECK(queue.IsEmpty());
+		}
+	}
+}
+
+TEST_SUITE("Benchmark" * doctest::skip()) {
+	TEST_CASE("SpscQueue throughput") {
+		constexpr int64 count = 2000000;
+
+		int32 outOfOrder = 0;
+		int64 sum = 0;
+		LockedQueue<int64> locked(1024);
+		double lockedRate = RunProducersAndConsumers(locked, 1, 1, count, outOfOrder, sum);
+		MpmcQueue<int64> mpmc(1024);
+		double mpmcRate = RunProducersAndConsumers(mpmc, 1, 1, count, outOfOrder, sum);
+		SpscQueue<int64> spsc(1024);
+		double spscRate = RunProducersAndConsumers(spsc, 1, 1, count, outOfOrder, sum);
+		INFO_MSG(String::Format(
+			STRL("1 producer, 1 consumer, locked Deque: {0:.2f} M values/s, MpmcQueue: {1:.2f} M values/s, SpscQueue: {2:.2f} M values/s"),
+			lockedRate, mpmcRate, spscRate
+		).GetRawArray());
+	}
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include "Engine/System/Memory/Memory.h"
+
+/// @brief A container allocation policy counting the live blocks, for checking containers free what they allocate.
+/// allocationCount keeps every Allocate() ever made.
+class CountingAllocator {
+public:
+	STATIC_CLASS(CountingAllocator);
+
+	static void* Allocate(::Engine::sizeint size) {
+		liveCount += 1;
+		allocationCount += 1;
+		return ::Engine::Memory::Allocate(size);
+	}
+	static void* Reallocate(void* ptr, ::Engine::sizeint oldSize, ::Engine::sizeint newSize) {
+		return ::Engine::Memory::Reallocate(ptr, newSize);
+	}
+	static void Deallocate(void* ptr) {
+		if (ptr != nullptr) {
+			liveCount -= 1;
+		}
+		::Engine::Memory::Deallocate(ptr);
+	}
+
+	static inline ::Engine::int32 liveCount = 0;
+	static inline ::Engine::int64 allocationCount = 0;
+};
\ No newline at end of file
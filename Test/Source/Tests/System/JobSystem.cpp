@@ -0,0 +1,777 @@
+#include "doctest.h"
+#include "Engine/System/Thread/JobSystem.h"
+#include "Engine/System/Thread/Fiber.h"
+#include "Engine/System/String.h"
+#include <chrono>
+
+using namespace Engine;
+
+namespace {
+	struct CounterData {
+		AtomicValue<int32>* counter;
+	};
+	void IncreaseCounter(Job* job) {
+		volatile CounterData* data = job->GetDataAs<CounterData>();
+		data->counter->Add(1);
+	}
+
+	struct SpawnData {
+		JobSystem* system;
+		AtomicValue<int32>* counter;
+		int32 children;
+	};
+	// Spawns jobs from inside a worker, which go to its local deque in work stealing mode.
+	void SpawnChildren(Job* job) {
+		volatile SpawnData* data = job->GetDataAs<SpawnData>();
+		CounterData child{ data->counter };
+		for (int32 i = 0; i < data->children; i += 1) {
+			data->system->AddJob(IncreaseCounter, &child, sizeof(child));
+		}
+		data->counter->Add(1);
+	}
+
+	struct OrderData {
+		AtomicValue<int32>* sequence;
+		int32* slot;
+	};
+	// Records the position of the job in the global running sequence.
+	void RecordOrder(Job* job) {
+		volatile OrderData* data = job->GetDataAs<OrderData>();
+		*(data->slot) = data->sequence->FetchAdd(1);
+	}
+
+	struct NestedData {
+		JobSystem* system;
+		AtomicValue<int32>* counter;
+		int32 depth;
+	};
+	// Waits on a child job from inside a job. Only finishes on one worker if the waiter helps.
+	void WaitNested(Job* job) {
+		volatile NestedData* data = job->GetDataAs<NestedData>();
+		if (data->depth > 0) {
+			NestedData child{ data->system, data->counter, data->depth - 1 };
+			JobHandle childJob = data->system->AddJob(WaitNested, &child, sizeof(child));
+			data->system->WaitJob(childJob);
+		}
+		data->counter->Add(1);
+	}
+
+	void WaitForCounter(AtomicValue<int32>& counter, int32 target) {
+		while (counter.Get() < target) {
+			std::this_thread::yield();
+		}
+	}
+
+	struct ParallelData {
+		JobSystem* system;
+		int32* visits;
+		int32 count;
+	};
+	// Runs a parallel loop from inside a job.
+	void RunNestedParallel(Job* job) {
+		volatile ParallelData* data = job->GetDataAs<ParallelData>();
+		int32* visits = data->visits;
+		data->system->ParallelFor(0, data->count, 7, [visits](int32 begin, int32 end) {
+			for (int32 i = begin; i < end; i += 1) {
+				visits[i] += 1;
+			}
+		});
+	}
+
+	// Some work heavy enough to measure.
+	float ParallelWork(int32 index) {
+		float value = static_cast<float>(index);
+		for (int32 i = 0; i < 64; i += 1) {
+			value = value * 0.999f + 1.0f;
+		}
+		return value;
+	}
+
+	// Counts live copies, to check callables are destroyed once run.
+	struct LifeCounter {
+		LifeCounter(AtomicValue<int32>* alive) :alive(alive) {
+			alive->Add(1);
+		}
+		LifeCounter(const LifeCounter& obj) :alive(obj.alive) {
+			alive->Add(1);
+		}
+		~LifeCounter() {
+			alive->Subtract(1);
+		}
+		AtomicValue<int32>* alive;
+	};
+
+	struct PingPong {
+		Fiber* main;
+		Fiber* other;
+		int32 steps = 0;
+	};
+	void RunPingPong(void* argument) {
+		PingPong* data = (PingPong*)argument;
+		while (true) {
+			data->steps += 1;
+			Fiber::Switch(data->other, data->main);
+		}
+	}
+
+	void RunSpawnRounds(JobSystem& system, int32 spawners, int32 children) {
+		AtomicValue<int32> counter{ 0 };
+		SpawnData data{ &system, &counter, children };
+		for (int32 i = 0; i < spawners; i += 1) {
+			system.AddJob(SpawnChildren, &data, sizeof(data));
+		}
+		WaitForCounter(counter, spawners * (children + 1));
+	}
+}
+
+TEST_SUITE("Thread") {
+	TEST_CASE("WorkStealingQueue") {
+		WorkStealingQueue<int32> queue{ 2 };
+		for (int32 i = 0; i < 10; i += 1) {
+			queue.Push(i);
+		}
+		CHECK(queue.GetCount() == 10);
+
+		int32 value = -1;
+		// Owner pops LIFO, thieves steal FIFO.
+		CHECK(queue.TryPop(value));
+		CHECK(value == 9);
+		CHECK(queue.TrySteal(value));
+		CHECK(value == 0);
+		CHECK(queue.GetCount() == 8);
+
+		int32 popped = 0;
+		while (queue.TryPop(value)) {
+			popped += 1;
+		}
+		CHECK(popped == 8);
+		CHECK(queue.IsEmpty());
+		CHECK(!queue.TrySteal(value));
+	}
+
+	TEST_CASE("JobSystem") {
+		for (auto mode : { JobSystem::SchedulingMode::SharedQueue, JobSystem::SchedulingMode::WorkStealing }) {
+			JobSystem system{ 2, mode };
+			CHECK(system.GetWorkerCount() == 2);
+			CHECK(system.GetSchedulingMode() == mode);
+			system.Start();
+
+			AtomicValue<int32> counter{ 0 };
+			CounterData data{ &counter };
+			JobHandle last;
+			for (int32 i = 0; i < 100; i += 1) {
+				last = system.AddJob(IncreaseCounter, &data, sizeof(data));
+			}
+			WaitForCounter(counter, 100);
+			CHECK(counter.Get() == 100);
+
+			RunSpawnRounds(system, 8, 50);
+
+			system.Stop();
+			CHECK(!system.IsRunning());
+		}
+	}
+
+	TEST_CASE("JobSystem dependency graph") {
+		JobSystem system{ 2 };
+		system.Start();
+
+		// Diamond: A -> (B, C) -> D
+		AtomicValue<int32> sequence{ 0 };
+		int32 order[4] = { -1, -1, -1, -1 };
+		OrderData data[4];
+		for (int32 i = 0; i < 4; i += 1) {
+			data[i] = OrderData{ &sequence, order + i };
+		}
+		JobHandle a = system.CreateJob(RecordOrder, data + 0, sizeof(OrderData));
+		JobHandle b = system.CreateJob(RecordOrder, data + 1, sizeof(OrderData));
+		JobHandle c = system.CreateJob(RecordOrder, data + 2, sizeof(OrderData));
+		JobHandle d = system.CreateJob(RecordOrder, data + 3, sizeof(OrderData));
+		system.AddDependency(b, a);
+		system.AddDependency(c, a);
+		system.AddDependency(d, b);
+		system.AddDependency(d, c);
+		// Submit in reverse order, nothing should start before its inputs are done.
+		system.Submit(d);
+		system.Submit(c);
+		system.Submit(b);
+		CHECK(!d.IsFinished());
+		system.Submit(a);
+		system.WaitJob(d);
+
+		CHECK(order[0] < order[1]);
+		CHECK(order[0] < order[2]);
+		CHECK(order[1] < order[3]);
+		CHECK(order[2] < order[3]);
+
+		// Continuation of a finished job runs straight away.
+		int32 lateOrder = -1;
+		OrderData late{ &sequence, &lateOrder };
+		JobHandle continuation = system.AddContinuation(d, RecordOrder, &late, sizeof(late));
+		system.WaitJob(continuation);
+		CHECK(lateOrder == 4);
+
+		// Fan-in.
+		AtomicValue<int32> counter{ 0 };
+		CounterData counterData{ &counter };
+		int32 sinkOrder = -1;
+		OrderData sinkData{ &sequence, &sinkOrder };
+		JobHandle sink = system.CreateJob(RecordOrder, &sinkData, sizeof(sinkData));
+		for (int32 i = 0; i < 100; i += 1) {
+			system.AddDependency(sink, system.AddJob(IncreaseCounter, &counterData, sizeof(counterData)));
+		}
+		system.Submit(sink);
+		system.WaitJob(sink);
+		CHECK(counter.Get() == 100);
+
+		system.Stop();
+	}
+
+	TEST_CASE("JobSystem wait strategies") {
+		JobSystem system{ 1 };
+		system.Start();
+
+		AtomicValue<int32> counter{ 0 };
+		CounterData data{ &counter };
+		for (auto strategy : {
+			JobSystem::WaitStrategy::Adaptive, JobSystem::WaitStrategy::Spin,
+			JobSystem::WaitStrategy::SpinYield, JobSystem::WaitStrategy::Block
+		}) {
+			JobHandle job;
+			for (int32 i = 0; i < 50; i += 1) {
+				job = system.AddJob(IncreaseCounter, &data, sizeof(data));
+			}
+			system.WaitJob(job, strategy);
+			CHECK(job.IsFinished());
+		}
+
+		// Nested waits deeper than the help limit still finish.
+		AtomicValue<int32> nested{ 0 };
+		NestedData nestedData{ &system, &nested, JobSystem::MaxWaitHelpDepth + 2 };
+		system.WaitJob(system.AddJob(WaitNested, &nestedData, sizeof(nestedData)));
+		CHECK(nested.Get() == JobSystem::MaxWaitHelpDepth + 3);
+
+		system.Stop();
+		CHECK(counter.Get() == 200);
+	}
+
+	TEST_CASE("JobSystem blocked waiters") {
+		using Clock = std::chrono::steady_clock;
+
+		for (auto mode : { JobSystem::SchedulingMode::SharedQueue, JobSystem::SchedulingMode::WorkStealing }) {
+			JobSystem system{ 1, mode };
+			system.Start();
+
+			// The only worker blocks in a wait on J, whose input W can only run on that worker.
+			// P runs on this thread once the worker has given up helping, and releases W into the exclusive queue.
+			AtomicValue<int32> counter{ 0 };
+			CounterData data{ &counter };
+			JobHandle p = system.CreateJob(IncreaseCounter, &data, sizeof(data));
+			JobHandle w = system.CreateJob(IncreaseCounter, &data, sizeof(data), Job::Preference::Window);
+			JobHandle j = system.CreateJob(IncreaseCounter, &data, sizeof(data));
+			system.AddDependency(w, p);
+			system.AddDependency(j, w);
+			system.Submit(j);
+			system.Submit(w);
+
+			AtomicValue<bool> started{ false };
+			JobHandle a = system.AddJob([&system, &started, j]() {
+				started.Set(true);
+				system.WaitJob(j);
+			});
+			while (!started.Get()) {
+				std::this_thread::yield();
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(50));
+			system.Submit(p);
+			system.WaitJob(p);
+
+			auto deadline = Clock::now() + std::chrono::seconds(10);
+			while (!a.IsFinished() && Clock::now() < deadline) {
+				std::this_thread::yield();
+			}
+			CHECK(a.IsFinished());
+			CHECK(counter.Get() == 3);
+
+			// Nested waits deeper than the help limit with nobody else helping.
+			AtomicValue<int32> nested{ 0 };
+			NestedData nestedData{ &system, &nested, JobSystem::MaxWaitHelpDepth + 2 };
+			JobHandle outer = system.AddJob(WaitNested, &nestedData, sizeof(nestedData));
+			deadline = Clock::now() + std::chrono::seconds(10);
+			while (!outer.IsFinished() && Clock::now() < deadline) {
+				std::this_thread::yield();
+			}
+			CHECK(nested.Get() == JobSystem::MaxWaitHelpDepth + 3);
+
+			system.Stop();
+		}
+	}
+
+	TEST_CASE("JobSystem job pool") {
+		JobSystem system{ 1 };
+		system.Start();
+
+		AtomicValue<int32> counter{ 0 };
+		CounterData data{ &counter };
+		JobHandle first = system.AddJob(IncreaseCounter, &data, sizeof(data));
+		system.WaitJob(first);
+
+		// Jobs are recycled once finished, one chunk serves any number of jobs run one after another.
+		constexpr int32 rounds = JobPool::ChunkJobCount * 10;
+		for (int32 i = 0; i < rounds; i += 1) {
+			system.WaitJob(system.AddJob(IncreaseCounter, &data, sizeof(data)));
+		}
+		CHECK(counter.Get() == rounds + 1);
+		CHECK(system.GetJobPool().GetChunkCount() == 1);
+
+		// The first slot has been reused many times, the old handle still reads as finished.
+		CHECK(first.IsFinished());
+		int32 lateOrder = -1;
+		AtomicValue<int32> sequence{ 0 };
+		OrderData late{ &sequence, &lateOrder };
+		system.WaitJob(system.AddContinuation(first, RecordOrder, &late, sizeof(late)));
+		CHECK(lateOrder == 0);
+
+		// Spawning from workers settles too.
+		RunSpawnRounds(system, 8, 50);
+		RunSpawnRounds(system, 8, 50);
+		int32 warm = system.GetJobPool().GetCapacity();
+		for (int32 i = 0; i < 20; i += 1) {
+			RunSpawnRounds(system, 8, 50);
+		}
+		CHECK(system.GetJobPool().GetCapacity() == warm);
+
+		system.Stop();
+	}
+
+	TEST_CASE("JobSystem callable jobs") {
+		JobSystem system{ 2 };
+		system.Start();
+
+		// Small callables live in the job.
+		AtomicValue<int32> counter{ 0 };
+		AtomicValue<int32> alive{ 0 };
+		{
+			LifeCounter life{ &alive };
+			JobHandle job;
+			for (int32 i = 0; i < 100; i += 1) {
+				job = system.AddJob([&counter, life]() {
+					counter.Add(1);
+				});
+			}
+			system.WaitJob(job);
+		}
+		WaitForCounter(counter, 100);
+		CHECK(counter.Get() == 100);
+
+		// Large ones spill into pooled blocks, the biggest ones into plain allocations.
+		int64 payload[32];
+		int64 hugePayload[400];
+		for (int32 i = 0; i < 400; i += 1) {
+			hugePayload[i] = i;
+			if (i < 32) {
+				payload[i] = i;
+			}
+		}
+		AtomicValue<int32> sum{ 0 };
+		LifeCounter life{ &alive };
+		JobHandle large = system.AddJob([payload, life, &sum]() {
+			int32 result = 0;
+			for (int64 value : payload) {
+				result += static_cast<int32>(value);
+			}
+			sum.Add(result);
+		});
+		JobHandle huge = system.AddJob([hugePayload, &sum]() {
+			int32 result = 0;
+			for (int64 value : hugePayload) {
+				result += static_cast<int32>(value);
+			}
+			sum.Add(result);
+		});
+		system.WaitJob(large);
+		system.WaitJob(huge);
+		CHECK(sum.Get() == 31 * 32 / 2 + 399 * 400 / 2);
+
+		// Results flow back through futures.
+		JobFuture<int32> answer = system.AddJob([]() {
+			return 42;
+		});
+		JobFuture<String> text = system.AddJob([payload]() {
+			return String::Format(STRING_LITERAL("{0}"), payload[31]);
+		});
+		CHECK(answer.IsValid());
+		CHECK(answer.Get() == 42);
+		CHECK(text.Get() == STRING_LITERAL("31"));
+		CHECK(text.IsFinished());
+
+		// Dropping a future early is fine.
+		{
+			JobFuture<String> dropped = system.AddJob([]() {
+				return String(STRING_LITERAL("dropped"));
+			});
+			JobFuture<String> moved = Memory::Move(dropped);
+			CHECK(!dropped.IsValid());
+			system.WaitJob(moved.GetHandle());
+		}
+
+		// Continuations take callables too.
+		int32 order = 0;
+		JobFuture<int32> first = system.AddJob([&order]() {
+			order = 1;
+			return order;
+		});
+		system.WaitJob(system.AddContinuation(first.GetHandle(), [&order]() {
+			order *= 10;
+		}));
+		CHECK(order == 10);
+
+		system.Stop();
+		// Only the local copy outside the jobs is still alive.
+		CHECK(alive.Get() == 1);
+	}
+
+	TEST_CASE("JobSystem priorities") {
+		constexpr Job::Priority lanes[] = { Job::Priority::Background, Job::Priority::Normal, Job::Priority::Critical };
+
+		JobSystem system{ 1 };
+		system.SetStarvationLimit(0);
+		system.Start();
+
+		// Keep the only worker busy while the lanes fill up.
+		AtomicValue<bool> started{ false };
+		AtomicValue<bool> gate{ false };
+		auto block = [&system, &started, &gate]() {
+			started.Set(false);
+			system.AddJob([&started, &gate]() {
+				started.Set(true);
+				while (!gate.Get()) {
+					std::this_thread::yield();
+				}
+			});
+			while (!started.Get()) {
+				std::this_thread::yield();
+			}
+		};
+
+		block();
+		AtomicValue<int32> sequence{ 0 };
+		int32 order[30];
+		OrderData data[30];
+		JobHandle handles[30];
+		for (int32 i = 0; i < 30; i += 1) {
+			data[i] = OrderData{ &sequence, order + i };
+			handles[i] = system.AddJob(RecordOrder, data + i, sizeof(OrderData), Job::Preference::Null, lanes[i % 3]);
+		}
+		gate.Set(true);
+		for (auto job : handles) {
+			system.WaitJob(job, JobSystem::WaitStrategy::Block);
+		}
+		// Every critical job runs before every normal one, and every normal one before every background one.
+		bool ordered = true;
+		for (int32 i = 0; i < 30; i += 1) {
+			for (int32 j = 0; j < 30; j += 1) {
+				if (lanes[i % 3] < lanes[j % 3]) {
+					ordered = ordered && order[i] < order[j];
+				}
+			}
+		}
+		CHECK(ordered);
+
+		// A background job behind a flood of critical ones still gets a turn.
+		system.SetStarvationLimit(4);
+		CHECK(system.GetStarvationLimit() == 4);
+		gate.Set(false);
+		block();
+		sequence.Set(0);
+		int32 backgroundOrder = -1;
+		OrderData backgroundData{ &sequence, &backgroundOrder };
+		JobHandle background = system.AddJob(RecordOrder, &backgroundData, sizeof(backgroundData), Job::Preference::Null, Job::Priority::Background);
+		for (int32 i = 0; i < 20; i += 1) {
+			handles[i] = system.AddJob(RecordOrder, data + i, sizeof(OrderData), Job::Preference::Null, Job::Priority::Critical);
+		}
+		gate.Set(true);
+		system.WaitJob(background, JobSystem::WaitStrategy::Block);
+		for (int32 i = 0; i < 20; i += 1) {
+			system.WaitJob(handles[i], JobSystem::WaitStrategy::Block);
+		}
+		CHECK(backgroundOrder <= 4);
+
+		system.Stop();
+	}
+
+	TEST_CASE("JobSystem frame deadline") {
+		using Clock = JobSystem::Clock;
+		JobSystem system{ 1 };
+		system.Start();
+
+		AtomicValue<int32> counter{ 0 };
+		CounterData data{ &counter };
+
+		// Background jobs wait while the next frame is near.
+		system.SetFrameDeadlineMargin(std::chrono::seconds(20));
+		system.SetFrameDeadline(Clock::now() + std::chrono::seconds(10));
+		CHECK(system.IsNearFrameDeadline());
+		JobHandle background = system.AddJob(IncreaseCounter, &data, sizeof(data), Job::Preference::Null, Job::Priority::Background);
+		JobHandle normal = system.AddJob(IncreaseCounter, &data, sizeof(data));
+		system.WaitJob(normal, JobSystem::WaitStrategy::Block);
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		CHECK(!background.IsFinished());
+
+		system.ClearFrameDeadline();
+		CHECK(!system.IsNearFrameDeadline());
+		system.WaitJob(background, JobSystem::WaitStrategy::Block);
+
+		// Once the deadline passes, held back jobs run without anyone waking the workers.
+		system.SetFrameDeadline(Clock::now() + std::chrono::milliseconds(50));
+		background = system.AddJob(IncreaseCounter, &data, sizeof(data), Job::Preference::Null, Job::Priority::Background);
+		system.WaitJob(background, JobSystem::WaitStrategy::Block);
+		CHECK(!system.IsNearFrameDeadline());
+		CHECK(counter.Get() == 3);
+
+		system.Stop();
+	}
+
+	TEST_CASE("JobSystem config") {
+		SUBCASE("Unpinned by default") {
+			JobSystem system{ 2 };
+			CHECK(system.GetWorkerCpu(0) == -1);
+			CHECK(system.GetWorkerCpu(1) == -1);
+			CHECK(system.GetWorkerNumaNode(1) == 0);
+		}
+		SUBCASE("Pinned workers") {
+			JobSystem::Config config{};
+			config.workerCount = 3;
+			config.pinThreads = true;
+			config.cpus.Add(0);
+			config.numaAware = true;
+			config.threadName = u8"Test Worker";
+			JobSystem system{ config };
+			CHECK(system.GetWorkerCount() == 3);
+			for (int32 i = 0; i < 3; i += 1) {
+				CHECK(system.GetWorkerCpu(i) == 0);
+				CHECK(system.GetWorkerNumaNode(i) == ThreadUtil::GetCpuNumaNode(0));
+			}
+
+			system.Start();
+			RunSpawnRounds(system, 4, 32);
+			system.Stop();
+		}
+		CHECK(ThreadUtil::GetNumaNodeCount() >= 1);
+	}
+
+	TEST_CASE("Fiber") {
+		PingPong data{};
+		data.main = Fiber::ConvertThread();
+		Fiber other{ RunPingPong, &data, 64 * 1024 };
+		data.other = &other;
+		CHECK(other.GetStackSize() == 64 * 1024);
+
+		for (int32 i = 0; i < 3; i += 1) {
+			Fiber::Switch(data.main, data.other);
+			CHECK(data.steps == i + 1);
+		}
+		Fiber::RevertThread(data.main);
+	}
+
+	TEST_CASE("JobSystem fibers") {
+		// One worker has to switch between fibers, more let them resume on other threads.
+		for (int32 workerCount : { 1, 3 }) {
+			JobSystem system{ workerCount, JobSystem::SchedulingMode::WorkStealing, JobSystem::ExecutionMode::Fiber };
+			CHECK(system.GetExecutionMode() == JobSystem::ExecutionMode::Fiber);
+			system.Start();
+
+			// Far deeper than the help limit while this thread sleeps.
+			// Every level suspends and the worker moves on to the child.
+			constexpr int32 depth = JobSystem::MaxWaitHelpDepth * 4;
+			AtomicValue<int32> nested{ 0 };
+			NestedData nestedData{ &system, &nested, depth };
+			system.WaitJob(system.AddJob(WaitNested, &nestedData, sizeof(nestedData)), JobSystem::WaitStrategy::Block);
+			CHECK(nested.Get() == depth + 1);
+
+			// Suspended fibers are reused.
+			int32 fibers = system.GetFiberCount();
+			CHECK(fibers >= depth + 1);
+			nested.Set(0);
+			system.WaitJob(system.AddJob(WaitNested, &nestedData, sizeof(nestedData)), JobSystem::WaitStrategy::Block);
+			CHECK(nested.Get() == depth + 1);
+			CHECK(system.GetFiberCount() <= fibers + workerCount);
+
+			// Parallel loops and futures inside fiber jobs.
+			constexpr int32 count = 1000;
+			List<int32> visits(count);
+			for (int32 i = 0; i < count; i += 1) {
+				visits.Add(0);
+			}
+			ParallelData data{ &system, visits.GetRawElementPtr(), count };
+			system.WaitJob(system.AddJob(RunNestedParallel, &data, sizeof(data)), JobSystem::WaitStrategy::Block);
+			bool visited = true;
+			for (int32 value : visits) {
+				visited = visited && value == 1;
+			}
+			CHECK(visited);
+
+			JobFuture<int32> sum = system.AddJob([&system]() {
+				JobFuture<int32> left = system.AddJob([]() {
+					return 20;
+				});
+				JobFuture<int32> right = system.AddJob([]() {
+					return 22;
+				});
+				return left.Get() + right.Get();
+			});
+			CHECK(sum.Get(JobSystem::WaitStrategy::Block) == 42);
+
+			RunSpawnRounds(system, 8, 50);
+			system.Stop();
+		}
+	}
+
+	TEST_CASE("JobSystem parallel loops") {
+		for (auto mode : { JobSystem::SchedulingMode::SharedQueue, JobSystem::SchedulingMode::WorkStealing }) {
+			JobSystem system{ 2, mode };
+			system.Start();
+
+			// Every index is visited exactly once, whatever the grain.
+			constexpr int32 count = 10000;
+			List<int32> visits(count);
+			for (int32 i = 0; i < count; i += 1) {
+				visits.Add(0);
+			}
+			int32* raw = visits.GetRawElementPtr();
+			for (int32 grain : { 0, 1, 64, count * 2 }) {
+				system.ParallelFor(0, count, grain, [raw](int32 begin, int32 end) {
+					for (int32 i = begin; i < end; i += 1) {
+						raw[i] += 1;
+					}
+				});
+			}
+			system.ParallelForEach(visits, 0, [](int32& value) {
+				value += 1;
+			});
+			bool allVisited = true;
+			for (int32 value : visits) {
+				allVisited = allVisited && value == 5;
+			}
+			CHECK(allVisited);
+
+			// Empty ranges never call back.
+			bool called = false;
+			system.ParallelFor(5, 5, 0, [&called](int32, int32) {
+				called = true;
+			});
+			CHECK(!called);
+
+			// Offset range, fixed pieces combined in order.
+			int64 sum = system.ParallelReduce(100, 100 + count, 33, (int64)0, [](int32 begin, int32 end) {
+				int64 result = 0;
+				for (int32 i = begin; i < end; i += 1) {
+					result += i;
+				}
+				return result;
+			}, [](int64 left, int64 right) {
+				return left + right;
+			});
+			CHECK(sum == (int64)count * (100 + 100 + count - 1) / 2);
+			CHECK(system.ParallelReduce(0, 0, 0, 42, [](int32, int32) { return 0; }, [](int32 a, int32 b) { return a + b; }) == 42);
+
+			// Floating point results do not depend on the scheduling.
+			auto floatSum = [&system]() {
+				return system.ParallelReduce(0, count, 0, 0.0f, [](int32 begin, int32 end) {
+					float result = 0.0f;
+					for (int32 i = begin; i < end; i += 1) {
+						result += ParallelWork(i);
+					}
+					return result;
+				}, [](float left, float right) {
+					return left + right;
+				});
+			};
+			float first = floatSum();
+			CHECK(floatSum() == first);
+
+			// Parallel loops inside jobs.
+			List<int32> nested(count);
+			for (int32 i = 0; i < count; i += 1) {
+				nested.Add(0);
+			}
+			ParallelData data{ &system, nested.GetRawElementPtr(), count };
+			system.WaitJob(system.AddJob(RunNestedParallel, &data, sizeof(data)));
+			bool nestedVisited = true;
+			for (int32 value : nested) {
+				nestedVisited = nestedVisited && value == 1;
+			}
+			CHECK(nestedVisited);
+
+			system.Stop();
+		}
+	}
+}
+
+TEST_SUITE("Benchmark" * doctest::skip()) {
+	TEST_CASE("JobSystem scheduling modes") {
+		using Clock = std::chrono::steady_clock;
+		constexpr int32 spawners = 64;
+		constexpr int32 children = 1000;
+		int32 hardware = ThreadUtil::GetHardwareThreadCount();
+
+		for (auto mode : { JobSystem::SchedulingMode::SharedQueue, JobSystem::SchedulingMode::WorkStealing }) {
+			JobSystem system{ hardware, mode };
+			system.Start();
+			// Warm up the queues.
+			RunSpawnRounds(system, spawners, children);
+
+			auto start = Clock::now();
+			RunSpawnRounds(system, spawners, children);
+			double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+			system.Stop();
+
+			INFO_MSG(String::Format(
+				STRING_LITERAL("{0}: {1} workers, {2:.0f} jobs/s, {3} pooled jobs"),
+				mode == JobSystem::SchedulingMode::SharedQueue ? STRING_LITERAL("SharedQueue") : STRING_LITERAL("WorkStealing"),
+				system.GetWorkerCount(), spawners * (children + 1) / seconds, system.GetJobPool().GetCapacity()
+			).GetRawArray());
+		}
+	}
+
+	TEST_CASE("JobSystem parallel loop scaling") {
+		using Clock = std::chrono::steady_clock;
+		constexpr int32 count = 1 << 20;
+		List<float> values(count);
+		for (int32 i = 0; i < count; i += 1) {
+			values.Add(0.0f);
+		}
+		float* raw = values.GetRawElementPtr();
+
+		double baseline = 0;
+		int32 hardware = ThreadUtil::GetHardwareThreadCount();
+		for (int32 workers = 1; workers <= hardware; workers += 1) {
+			JobSystem system{ workers };
+			system.Start();
+			auto run = [&system, raw]() {
+				system.ParallelFor(0, count, 0, [raw](int32 begin, int32 end) {
+					for (int32 i = begin; i < end; i += 1) {
+						raw[i] = ParallelWork(i);
+					}
+				});
+			};
+			// Warm up the pool and the caches.
+			run();
+
+			auto start = Clock::now();
+			for (int32 i = 0; i < 10; i += 1) {
+				run();
+			}
+			double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+			system.Stop();
+
+			if (workers == 1) {
+				baseline = seconds;
+			}
+			INFO_MSG(String::Format(
+				STRING_LITERAL("ParallelFor: {0} workers, {1:.2f} ms per loop, {2:.2f}x"),
+				workers, seconds * 100, baseline / seconds
+			).GetRawArray());
+		}
+	}
+}
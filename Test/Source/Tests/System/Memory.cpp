@@ -2,7 +2,28 @@
 #include "Engine/System/Memory/Memory.h"
 #include "Engine/System/Memory/SharedPtr.h"
 #include "Engine/System/Memory/CopyOnWrite.h"
+#include "Engine/System/Memory/SizeClassAllocator.h"
+#include "Engine/System/Memory/FrameArena.h"
+#include "Engine/System/Memory/MemoryResource.h"
+#include "Engine/System/Memory/MemoryTracker.h"
+#include "Engine/System/Collection/List.h"
+#include "Engine/System/String.h"
 #include "MemoryObject.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#if defined(_WIN32)
+#	include "Engine/Platform/Windows/BetterWindows.h"
+#	include <psapi.h>
+#elif defined(__linux__)
+#	include <cstdio>
+#	include <unistd.h>
+#endif
+#if defined(__GLIBC__)
+#	include <malloc.h>
+#endif
 using namespace Engine;
 
 class Base {
@@ -11,8 +32,86 @@ class Base {
 class Derived :public Base {
 
 };
+struct alignas(128) AlignedObject {
+	int32 value = 0;
+};
+
+struct TrackedBlock {
+	int64* block;
+	std::source_location location;
+};
+// MEMNEW a block and tell the location it is counted toward.
+TrackedBlock NewTrackedBlock(int64 value) {
+	return TrackedBlock{ MEMNEW(int64(value)), std::source_location::current() };
+}
+
+namespace {
+	/// @brief Sizes of a mixed small object workload, fixed so runs compare.
+	sizeint GetChurnSize(uint32& seed) {
+		seed = seed * 1664525u + 1013904223u;
+		uint32 bucket = (seed >> 24) % 16;
+		return bucket < 12 ? 16 + (seed >> 8) % 112 : 128 + (seed >> 8) % 2048;
+	}
+
+	/// @brief Get the bytes of the process resident in memory, 0 where it is not known.
+	sizeint GetResidentSize() {
+#if defined(_WIN32)
+		PROCESS_MEMORY_COUNTERS counters{};
+		if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+			return counters.WorkingSetSize;
+		}
+		return 0;
+#elif defined(__linux__)
+		std::FILE* file = std::fopen("/proc/self/statm", "r");
+		if (file == nullptr) {
+			return 0;
+		}
+		unsigned long total = 0, resident = 0;
+		int32 read = std::fscanf(file, "%lu %lu", &total, &resident);
+		std::fclose(file);
+		return read == 2 ? static_cast<sizeint>(resident) * static_cast<sizeint>(sysconf(_SC_PAGESIZE)) : 0;
+#else
+		return 0;
+#endif
+	}
+
+	struct ChurnFootprint {
+		/// @brief Bytes requested by the live blocks at the end of the churn.
+		sizeint liveSize = 0;
+		/// @brief Resident bytes at the end of the churn, blocks still live.
+		sizeint residentSize = 0;
+	};
+
+	/// @brief Keep a window of live blocks, replacing a random one each step.
+	template<typename A, typename D>
+	ChurnFootprint RunChurn(int32 steps, A allocate, D deallocate) {
+		constexpr int32 window = 1024;
+		void* live[window] = {};
+		sizeint sizes[window] = {};
+		uint32 seed = 12345;
+		for (int32 i = 0; i < steps; i += 1) {
+			int32 slot = (seed >> 4) % window;
+			if (live[slot] != nullptr) {
+				deallocate(live[slot]);
+			}
+			sizes[slot] = GetChurnSize(seed);
+			live[slot] = allocate(sizes[slot]);
+			*(byte*)live[slot] = 1;
+		}
 
-TEST_SUITE("Memory"){
+		ChurnFootprint footprint{};
+		footprint.residentSize = GetResidentSize();
+		for (int32 i = 0; i < window; i += 1) {
+			footprint.liveSize += sizes[i];
+			if (live[i] != nullptr) {
+				deallocate(live[i]);
+			}
+		}
+		return footprint;
+	}
+}
+
+TEST_SUITE("Memory") {
 	TEST_CASE("Necessary destruction check") {
 		CHECK(!Memory::IsDestructionNeeded<int>());
 		CHECK(Memory::IsDestructionNeeded<MemoryObject>());
@@ -52,6 +151,26 @@ TEST_SUITE("Memory"){
 		SharedPtr<Base> b{ d };
 	}
 
+	TEST_CASE("Over-aligned types") {
+		void* block = Memory::AllocateAligned(100, 256);
+		CHECK(((uintptr_t)block % 256) == 0);
+		Memory::DeallocateAligned(block);
+
+		List<AlignedObject*> objects{};
+		for (int32 i = 0; i < 16; i += 1) {
+			AlignedObject* object = MEMNEW(AlignedObject{ i });
+			CHECK(((uintptr_t)object % alignof(AlignedObject)) == 0);
+			objects.Add(object);
+		}
+		for (int32 i = 0; i < 16; i += 1) {
+			CHECK(objects.Get(i)->value == i);
+			MEMDEL(objects.Get(i));
+		}
+
+		SharedPtr<AlignedObject> shared = SharedPtr<AlignedObject>::Create();
+		CHECK(((uintptr_t)shared.GetRaw() % alignof(AlignedObject)) == 0);
+	}
+
 	TEST_CASE("CopyOnWrite") {
 		using Type = CopyOnWrite<MemoryObject>;
 		Type a = Type::Create();
@@ -74,4 +193,387 @@ TEST_SUITE("Memory"){
 		CHECK(!b.IsExclusive());
 		CHECK(c.IsExclusive());
 	}
-}
\ No newline at end of file
+
+	TEST_CASE("Size classes") {
+		CHECK(SizeClassAllocator::GetSizeClass(1) == 0);
+		CHECK(SizeClassAllocator::GetSizeClass(16) == 0);
+		CHECK(SizeClassAllocator::GetSizeClass(17) == 1);
+		CHECK(SizeClassAllocator::GetSizeClass(SizeClassAllocator::MaxSmallSize) == SizeClassAllocator::SizeClassCount - 1);
+		CHECK(SizeClassAllocator::GetSizeClass(SizeClassAllocator::MaxSmallSize + 1) == -1);
+
+		// Every size maps to the smallest class holding it.
+		for (sizeint size = 1; size <= SizeClassAllocator::MaxSmallSize; size += 7) {
+			int32 sizeClass = SizeClassAllocator::GetSizeClass(size);
+			CHECK(SizeClassAllocator::GetClassSize(sizeClass) >= size);
+			if (sizeClass > 0) {
+				CHECK(SizeClassAllocator::GetClassSize(sizeClass - 1) < size);
+			}
+		}
+	}
+
+	TEST_CASE("Allocator blocks") {
+		SUBCASE("Alignment and usable size") {
+			for (sizeint size : { 1, 24, 200, 5000, 16384, 100000 }) {
+				void* block = Memory::Allocate(size);
+				CHECK(((uintptr_t)block % SizeClassAllocator::Alignment) == 0);
+				std::memset(block, 0xab, size);
+				Memory::Deallocate(block);
+			}
+		}
+		SUBCASE("Reallocate keeps the content") {
+			byte* block = (byte*)SizeClassAllocator::Allocate(8);
+			for (int32 i = 0; i < 8; i += 1) {
+				block[i] = (byte)i;
+			}
+			for (sizeint size : { 12, 100, 3000, 40000, 64, 4 }) {
+				block = (byte*)SizeClassAllocator::Reallocate(block, size);
+				for (int32 i = 0; i < 4; i += 1) {
+					CHECK(block[i] == (byte)i);
+				}
+			}
+			SizeClassAllocator::Deallocate(block);
+		}
+		SUBCASE("Blocks are recycled") {
+			void* first = SizeClassAllocator::Allocate(48);
+			SizeClassAllocator::Deallocate(first);
+			void* second = SizeClassAllocator::Allocate(40);
+			CHECK(first == second);
+			SizeClassAllocator::Deallocate(second);
+		}
+		SUBCASE("Freeing on another thread") {
+			constexpr int32 count = 1000;
+			List<void*> blocks(count);
+			for (int32 i = 0; i < count; i += 1) {
+				blocks.Add(SizeClassAllocator::Allocate(32 + i % 200));
+			}
+			std::thread other([&blocks]() {
+				for (void* block : blocks) {
+					SizeClassAllocator::Deallocate(block);
+				}
+			});
+			other.join();
+
+			// The other thread gave its cache back on exit, so this one can reuse them.
+			sizeint reserved = SizeClassAllocator::GetReservedSize();
+			for (int32 i = 0; i < count; i += 1) {
+				blocks.Set(i, SizeClassAllocator::Allocate(32 + i % 200));
+			}
+			CHECK(SizeClassAllocator::GetReservedSize() == reserved);
+			for (void* block : blocks) {
+				SizeClassAllocator::Deallocate(block);
+			}
+		}
+	}
+
+	TEST_CASE("Frame arena") {
+		SUBCASE("Blocks survive until their frame is rewound") {
+			FrameArena arena{ 2, 1024 };
+			int32* first = (int32*)arena.Allocate(sizeof(int32));
+			*first = 42;
+			CHECK(((uintptr_t)first % FrameArena::Alignment) == 0);
+			CHECK(((uintptr_t)arena.Allocate(8, 64) % 64) == 0);
+			CHECK(arena.GetUsedSize() > 0);
+
+			arena.AdvanceFrame();
+			CHECK(arena.GetUsedSize() == 0);
+			CHECK(*first == 42);
+			arena.Allocate(sizeof(int32));
+
+			// Back to the first set of pages.
+			arena.AdvanceFrame();
+			CHECK(arena.GetFrameIndex() == 2);
+			CHECK(arena.Allocate(sizeof(int32)) == first);
+		}
+		SUBCASE("Pages are kept from frame to frame") {
+			FrameArena arena{ 1, 1024 };
+			for (int32 i = 0; i < 64; i += 1) {
+				arena.Allocate(100);
+			}
+			arena.Allocate(5000);
+			sizeint reserved = arena.GetReservedSize();
+			for (int32 frame = 0; frame < 4; frame += 1) {
+				arena.AdvanceFrame();
+				for (int32 i = 0; i < 64; i += 1) {
+					arena.Allocate(100);
+				}
+				arena.Allocate(5000);
+			}
+			CHECK(arena.GetReservedSize() == reserved);
+		}
+		SUBCASE("Allocating from several threads") {
+			FrameArena arena{ 2, 4096 };
+			constexpr int32 perThread = 2000;
+			int32* blocks[2][perThread] = {};
+			auto fill = [&arena, &blocks](int32 thread) {
+				for (int32 i = 0; i < perThread; i += 1) {
+					blocks[thread][i] = (int32*)arena.Allocate(sizeof(int32));
+					*blocks[thread][i] = thread * perThread + i;
+				}
+			};
+			std::thread other(fill, 1);
+			fill(0);
+			other.join();
+			for (int32 thread = 0; thread < 2; thread += 1) {
+				for (int32 i = 0; i < perThread; i += 1) {
+					CHECK(*blocks[thread][i] == thread * perThread + i);
+				}
+			}
+		}
+		SUBCASE("Blocks are tagged with the frame they were bumped from") {
+			FrameArena arena{ 2, 1024 };
+			uint64 index = 99;
+			arena.Allocate(sizeof(int32), FrameArena::Alignment, &index);
+			arena.AdvanceFrame();
+			CHECK(index == 0);
+			CHECK(arena.IsFrameAlive(index));
+			arena.AdvanceFrame();
+			CHECK(!arena.IsFrameAlive(index));
+		}
+		SUBCASE("Allocating while the frame advances") {
+			// Only the oldest frame is rewound, blocks of a frame still alive are never handed out again.
+			FrameArena arena{ 2, 4096 };
+			constexpr int32 count = 20000;
+			struct Block {
+				int32* data;
+				uint64 frameIndex;
+			};
+			UniquePtr<Block[]> storage = UniquePtr<Block[]>::Create(count);
+			Block* blocks = storage.GetRaw();
+			std::atomic<int32> progress{ 0 };
+			std::thread worker([&arena, blocks, &progress]() {
+				for (int32 i = 0; i < count; i += 1) {
+					blocks[i].data = (int32*)arena.Allocate(sizeof(int32), FrameArena::Alignment, &blocks[i].frameIndex);
+					*blocks[i].data = i;
+					progress.store(i + 1, std::memory_order_release);
+				}
+			});
+			while (progress.load(std::memory_order_acquire) < count / 3) {}
+			arena.AdvanceFrame();
+			while (progress.load(std::memory_order_acquire) < count * 2 / 3) {}
+			arena.AdvanceFrame();
+			worker.join();
+
+			for (int32 i = 0; i < count; i += 1) {
+				if (arena.IsFrameAlive(blocks[i].frameIndex)) {
+					CHECK(*blocks[i].data == i);
+				}
+			}
+		}
+		SUBCASE("Transient containers") {
+			// Without an active arena transient strings hold plain heap strings.
+			TransientString outside = String::FormatTransient(STRL("Node{0}"), 7);
+			CHECK(outside == STRL("Node7"));
+			CHECK(outside.IsAlive());
+
+			FrameArena arena{};
+			FrameArena::SetCurrent(&arena);
+			TransientString inside = String::FormatTransient(STRL("Node{0}"), 8);
+			CHECK(inside == STRL("Node8"));
+			CHECK(inside.GetCount() == 5);
+			String kept = inside.ToString();
+			// The chars are gone once the arena has rewound their frame, the copy stays.
+			arena.AdvanceFrame();
+			// Made after the advance, so the string belongs to the new frame.
+			TransientString later = String::CreateTransient(u8"Later", 5);
+			CHECK(inside.IsAlive());
+			arena.AdvanceFrame();
+			CHECK(!inside.IsAlive());
+			CHECK(later.IsAlive());
+			CHECK(later == STRL("Later"));
+			CHECK(kept == STRL("Node8"));
+
+			TransientList<int32> list{};
+			for (int32 i = 0; i < 100; i += 1) {
+				list.Add(i);
+			}
+			CHECK(list.GetCount() == 100);
+			CHECK(list.Get(99) == 99);
+			TransientList<int32> copy = list;
+			CHECK(copy.Get(50) == 50);
+			FrameArena::SetCurrent(nullptr);
+		}
+	}
+
+	TEST_CASE("Memory resources") {
+		SUBCASE("Buffer resource") {
+			InlineBufferResource<256> buffer{};
+			byte* first = (byte*)buffer.Allocate(10);
+			CHECK(buffer.IsOwned(first));
+			CHECK(buffer.GetUsedSize() == 16);
+
+			// The newest block grows in place and rolls back when freed.
+			byte* second = (byte*)buffer.Allocate(32);
+			CHECK(buffer.Reallocate(second, 32, 64) == second);
+			CHECK(buffer.GetUsedSize() == 80);
+			buffer.Deallocate(second);
+			CHECK(buffer.GetUsedSize() == 16);
+
+			// Full, the rest comes from upstream.
+			byte* large = (byte*)buffer.Allocate(1024);
+			CHECK(!buffer.IsOwned(large));
+			buffer.Deallocate(large);
+
+			buffer.Reset();
+			CHECK(buffer.GetUsedSize() == 0);
+		}
+		SUBCASE("Containers keep their resource") {
+			InlineBufferResource<1024> buffer{};
+			List<int32, ResourceAllocator> list{};
+			{
+				MemoryResource::Scope scope(&buffer);
+				CHECK(MemoryResource::GetCurrent() == &buffer);
+				for (int32 i = 0; i < 16; i += 1) {
+					list.Add(i);
+				}
+				CHECK(buffer.IsOwned(list.GetRawElementPtr()));
+			}
+			CHECK(MemoryResource::GetCurrent() == MemoryResource::GetHeap());
+
+			// Growing past the buffer after the scope still goes through it, then upstream.
+			for (int32 i = 16; i < 1000; i += 1) {
+				list.Add(i);
+			}
+			CHECK(ResourceAllocator::GetResource(list.GetRawElementPtr()) == &buffer);
+			CHECK(!buffer.IsOwned(list.GetRawElementPtr()));
+			CHECK(list.Get(999) == 999);
+			CHECK(list.Get(3) == 3);
+		}
+	}
+
+	TEST_CASE("Memory tracking") {
+		if (!MemoryTracker::IsEnabled()) {
+			CHECK(MemoryTracker::GetStatistics().allocationCount == 0);
+			CHECK(MemoryTracker::GetSites().GetCount() == 0);
+			return;
+		}
+
+		auto findSite = [](uint32 line, MemoryTracker::Site& result) {
+			List<MemoryTracker::Site> sites = MemoryTracker::GetSites();
+			for (int32 i = 0; i < sites.GetCount(); i += 1) {
+				MemoryTracker::Site site = sites.Get(i);
+				if (site.line == line && std::strstr(site.file, "Memory.cpp") != nullptr) {
+					result = site;
+					return true;
+				}
+			}
+			return false;
+		};
+
+		MemoryTracker::Statistics before = MemoryTracker::GetStatistics();
+		int64* blocks[10] = {};
+		uint32 line = 0;
+		for (int32 i = 0; i < 10; i += 1) {
+			TrackedBlock tracked = NewTrackedBlock(i);
+			blocks[i] = tracked.block;
+			line = tracked.location.line();
+		}
+		MemoryTracker::Statistics during = MemoryTracker::GetStatistics();
+		CHECK(during.allocationCount >= before.allocationCount + 10);
+		CHECK(during.peakLiveBytes >= during.liveBytes);
+
+		MemoryTracker::Site site{};
+		REQUIRE(findSite(line, site));
+		CHECK(site.liveCount == 10);
+		CHECK(site.liveBytes == 10 * sizeof(int64));
+
+		// Growing a block counts against its first site.
+		void* grown = Memory::Allocate(16);
+		grown = Memory::Reallocate(grown, 4096);
+		MemoryTracker::AdvanceFrame();
+		CHECK(MemoryTracker::GetStatistics().lastFrameAllocationCount >= 11);
+		CHECK(MemoryTracker::GetStatistics().lastFrameBytes >= 4096);
+		Memory::Deallocate(grown);
+
+		for (int32 i = 0; i < 10; i += 1) {
+			MEMDEL(blocks[i]);
+		}
+		REQUIRE(findSite(line, site));
+		CHECK(site.liveCount == 0);
+		CHECK(site.liveBytes == 0);
+		CHECK(site.allocationCount == 10);
+		CHECK(site.lastFrameAllocationCount == 10);
+
+		// Container storage counts toward the scope around it.
+		uint32 scopeLine = 0;
+		{
+			MemoryScope scope{};
+			scopeLine = scope.GetLocation().line();
+			List<int64> list{};
+			for (int32 i = 0; i < 100; i += 1) {
+				list.Add(i);
+			}
+			// The list of sites made by findSite() is in the scope as well.
+			REQUIRE(findSite(scopeLine, site));
+			CHECK(site.liveCount >= 1);
+			CHECK(site.liveBytes >= 100 * sizeof(int64));
+		}
+		REQUIRE(findSite(scopeLine, site));
+		CHECK(site.liveCount == 0);
+		CHECK(site.allocationCount >= 1);
+
+		String report = MemoryTracker::GetReport();
+		CHECK(report.GetCount() > 0);
+	}
+}
+
+TEST_SUITE("Benchmark" * doctest::skip()) {
+	TEST_CASE("Memory allocation") {
+		using Clock = std::chrono::steady_clock;
+		constexpr int32 steps = 4000000;
+
+		auto measure = [](auto&& run) {
+			// Warm up, then time.
+			run(steps / 4);
+			auto start = Clock::now();
+			run(steps);
+			return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / steps;
+		};
+		// Resident growth from before the warm up to the end of the timed churn, the fragmentation left by each allocator.
+		auto measureChurn = [&](auto allocate, auto deallocate, ChurnFootprint& footprint) {
+			sizeint before = GetResidentSize();
+			double time = measure([&](int32 count) {
+				footprint = RunChurn(count, allocate, deallocate);
+			});
+			footprint.residentSize = footprint.residentSize > before ? footprint.residentSize - before : 0;
+			return time;
+		};
+		ChurnFootprint systemFootprint{}, engineFootprint{};
+		double system = measureChurn([](sizeint size) { return std::malloc(size); }, [](void* ptr) { std::free(ptr); }, systemFootprint);
+#if defined(__GLIBC__)
+		// Give the free malloc memory back, so the engine churn grows the resident set on its own.
+		malloc_trim(0);
+#endif
+		double engine = measureChurn([](sizeint size) { return Memory::Allocate(size); }, [](void* ptr) { Memory::Deallocate(ptr); }, engineFootprint);
+		double containers = measure([](int32 count) {
+			for (int32 i = 0; i < count / 64; i += 1) {
+				List<String> names{};
+				for (int32 j = 0; j < 16; j += 1) {
+					names.Add(String::Format(STRL("Node {0} of a long enough name"), j));
+				}
+				int32* numbers = MEMNEWARR(int32, 64);
+				MEMDELARR(numbers);
+			}
+		});
+
+		double arena = measure([](int32 count) {
+			FrameArena frames{};
+			uint32 seed = 12345;
+			for (int32 i = 0; i < count; i += 1) {
+				if (i % 4096 == 0) {
+					frames.AdvanceFrame();
+				}
+				*(byte*)frames.Allocate(GetChurnSize(seed)) = 1;
+			}
+		});
+		INFO_MSG(String::Format(STRL("FrameArena: {0:.1f} ns/op"), arena).GetRawArray());
+
+		INFO_MSG(String::Format(
+			STRL("malloc churn: {0:.1f} ns/op, Memory churn: {1:.1f} ns/op, {2:.0f} ns per List<String> round, {3} KiB reserved in size classes"),
+			system, engine, containers * 64, SizeClassAllocator::GetReservedSize() / 1024
+		).GetRawArray());
+		INFO_MSG(String::Format(
+			STRL("Churn footprint, {0} KiB live: malloc grew the resident set by {1} KiB, Memory by {2} KiB"),
+			engineFootprint.liveSize / 1024, systemFootprint.residentSize / 1024, engineFootprint.residentSize / 1024
+		).GetRawArray());
+	}
+}
@@ -1,5 +1,12 @@
 #include "doctest.h"
 #include "Engine/System/Object/Object.h"
+#include "Engine/System/Memory/ObjectPool.h"
+#include "Engine/System/Memory/MemoryTracker.h"
+#include "Engine/System/Memory/IntrusivePtr.h"
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
 
 using namespace Engine;
 
@@ -32,6 +39,29 @@ public:
 	int32 value = 0;
 };
 
+class PooledObject :public ReferencedObject {
+	REFLECTION_CLASS(::PooledObject, ::Engine::ReferencedObject) {}
+	OBJECT_POOLED(::PooledObject)
+
+public:
+	PooledObject(int32 value = 0) :value(value) {}
+	int32 value;
+};
+
+class PooledObjectLarge :public PooledObject {
+	REFLECTION_CLASS(::PooledObjectLarge, ::PooledObject) {}
+
+public:
+	int64 extra[8] = {};
+};
+
+class PlainObject :public ReferencedObject {
+	REFLECTION_CLASS(::PlainObject, ::Engine::ReferencedObject) {}
+
+public:
+	int32 value = 0;
+};
+
 TEST_CASE("Object") {
 	String signame = STRL("TestSignal");
 	String recvname = STRL("OnTestSignal");
@@ -80,3 +110,182 @@ TEST_CASE("Object") {
 	CHECK(hd2->value == 3);
 	CHECK(hd3->value == 3 + 3 + 10 - 5 - 1 + 10 - 5);
 }
+
+TEST_CASE("Object pool") {
+	ObjectPool& pool = ObjectPool::Get<PooledObject>();
+	CHECK(pool.GetName() == STRL("::PooledObject"));
+	CHECK(pool.GetSlotSize() >= sizeof(PooledObject));
+	List<ObjectPool*> pools = ObjectPool::GetPools();
+	bool registered = false;
+	for (int32 i = 0; i < pools.GetCount(); i += 1) {
+		registered = registered || pools.Get(i) == &pool;
+	}
+	CHECK(registered);
+	int32 baseCount = pool.GetUsedCount();
+
+	SUBCASE("Slots are carved in order and recycled") {
+		PooledObject* objects[16] = {};
+		for (int32 i = 0; i < 16; i += 1) {
+			objects[i] = MEMNEW(PooledObject(i));
+			CHECK(pool.IsOwned(objects[i]));
+		}
+		CHECK(pool.GetUsedCount() == baseCount + 16);
+		CHECK(pool.GetPeakUsedCount() >= baseCount + 16);
+		CHECK(Object::IsInstanceValid(objects[3]->GetInstanceId()));
+
+		PooledObject* freed = objects[7];
+		MEMDEL(objects[7]);
+		CHECK(pool.GetUsedCount() == baseCount + 15);
+		objects[7] = MEMNEW(PooledObject(7));
+		CHECK(objects[7] == freed);
+
+		for (int32 i = 0; i < 16; i += 1) {
+			CHECK(objects[i]->value == i);
+			// Deleting through the base class still gives the slot back.
+			ReferencedObject* base = objects[i];
+			MEMDEL(base);
+		}
+		CHECK(pool.GetUsedCount() == baseCount);
+	}
+	SUBCASE("Slots are tracked") {
+		if (MemoryTracker::IsEnabled()) {
+			auto create = []() {
+				return std::pair{ MEMNEW(PooledObject()), std::source_location::current() };
+			};
+			auto findSite = [](const std::source_location& location, MemoryTracker::Site& result) {
+				List<MemoryTracker::Site> sites = MemoryTracker::GetSites();
+				for (int32 i = 0; i < sites.GetCount(); i += 1) {
+					if (sites.Get(i).line == location.line() && std::strcmp(sites.Get(i).file, location.file_name()) == 0) {
+						result = sites.Get(i);
+						return true;
+					}
+				}
+				return false;
+			};
+
+			auto [object, location] = create();
+			CHECK(pool.IsOwned(object));
+			MemoryTracker::Site site{};
+			REQUIRE(findSite(location, site));
+			CHECK(site.liveCount == 1);
+			CHECK(site.liveBytes == sizeof(PooledObject));
+			MEMDEL(object);
+			REQUIRE(findSite(location, site));
+			CHECK(site.liveCount == 0);
+		}
+	}
+	SUBCASE("Larger derived classes go to the heap") {
+		PooledObjectLarge* large = MEMNEW(PooledObjectLarge());
+		CHECK(!pool.IsOwned(large));
+		CHECK(pool.GetUsedCount() == baseCount);
+		MEMDEL(large);
+		CHECK(pool.GetUsedCount() == baseCount);
+	}
+	SUBCASE("Smart pointers") {
+		{
+			IntrusivePtr<PooledObject> ptr = IntrusivePtr<PooledObject>::Create(5);
+			CHECK(pool.GetUsedCount() == baseCount + 1);
+			CHECK(ptr->value == 5);
+		}
+		CHECK(pool.GetUsedCount() == baseCount);
+	}
+	SUBCASE("Spawning from several threads") {
+		auto spawn = []() {
+			PooledObject* objects[64] = {};
+			for (int32 round = 0; round < 200; round += 1) {
+				for (int32 i = 0; i < 64; i += 1) {
+					objects[i] = MEMNEW(PooledObject(i));
+				}
+				for (int32 i = 0; i < 64; i += 1) {
+					CHECK(objects[i]->value == i);
+					MEMDEL(objects[i]);
+				}
+			}
+		};
+		std::thread other(spawn);
+		spawn();
+		other.join();
+		CHECK(pool.GetUsedCount() == baseCount);
+		CHECK(pool.GetSlotCount() >= 128);
+	}
+}
+
+TEST_CASE("Object lookup from several threads") {
+	constexpr int32 threadCount = 4;
+	constexpr int32 rounds = 250;
+	constexpr int32 count = 1000;
+
+	// A million objects created, looked up and destroyed while the other threads do the same.
+	std::atomic<int32> failures{ 0 };
+	auto spawn = [&failures]() {
+		List<PlainObject*> objects(count);
+		List<InstanceId> ids(count);
+		for (int32 round = 0; round < rounds; round += 1) {
+			objects.Clear();
+			ids.Clear();
+			for (int32 i = 0; i < count; i += 1) {
+				PlainObject* object = MEMNEW(PlainObject());
+				objects.Add(object);
+				ids.Add(object->GetInstanceId());
+			}
+			for (int32 i = 0; i < count; i += 1) {
+				if (Object::GetInstance(ids.Get(i)) != objects.Get(i) || !Object::IsInstanceValid(ids.Get(i))) {
+					failures.fetch_add(1, std::memory_order_relaxed);
+				}
+			}
+			for (int32 i = 0; i < count; i += 1) {
+				MEMDEL(objects.Get(i));
+				if (Object::GetInstance(ids.Get(i)) != nullptr || Object::IsInstanceValid(ids.Get(i))) {
+					failures.fetch_add(1, std::memory_order_relaxed);
+				}
+			}
+		}
+	};
+	std::thread others[threadCount - 1];
+	for (auto& other : others) {
+		other = std::thread(spawn);
+	}
+	spawn();
+	for (auto& other : others) {
+		other.join();
+	}
+	CHECK(failures.load() == 0);
+}
+
+TEST_SUITE("Benchmark" * doctest::skip()) {
+	TEST_CASE("Object pool spawning") {
+		constexpr int32 count = 4096;
+		constexpr int32 rounds = 100;
+		auto measure = [](auto spawn) {
+			auto start = std::chrono::steady_clock::now();
+			for (int32 round = 0; round < rounds; round += 1) {
+				spawn();
+			}
+			auto duration = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+			return duration / (static_cast<double>(count) * rounds);
+		};
+
+		static PlainObject* plain[count];
+		double heap = measure([]() {
+			for (int32 i = 0; i < count; i += 1) {
+				plain[i] = MEMNEW(PlainObject());
+			}
+			for (int32 i = 0; i < count; i += 1) {
+				MEMDEL(plain[i]);
+			}
+		});
+		static PooledObject* pooled[count];
+		double pool = measure([]() {
+			for (int32 i = 0; i < count; i += 1) {
+				pooled[i] = MEMNEW(PooledObject());
+			}
+			for (int32 i = 0; i < count; i += 1) {
+				MEMDEL(pooled[i]);
+			}
+		});
+		INFO_MSG(String::Format(
+			STRL("Spawn and despawn, heap: {0:.1f} ns/object, pool: {1:.1f} ns/object, {2} slabs"),
+			heap, pool, ObjectPool::Get<PooledObject>().GetSlabCount()
+		).GetRawArray());
+	}
+}
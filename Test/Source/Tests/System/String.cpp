@@ -75,4 +75,22 @@ TEST_SUITE("String") {
 		CHECK(target.EndsWith(STRING_LITERAL("准备就绪！")));
 		CHECK(!target.EndsWith(STRING_LITERAL("跟我比划比划")));
 	}
-}
\ No newline at end of file
+	TEST_CASE("Hash codes") {
+		String whole = STRING_LITERAL("Hello World!");
+		String part = whole.Substring(6, 5);
+		String copy = String(u8"World");
+		std::u8string_view view = u8"World";
+
+		// Cached or not, equal text hashes the same.
+		CHECK(part.GetHashCode() == copy.GetHashCode());
+		CHECK(copy.GetHashCode() == String::GetHashCode(view));
+		CHECK(copy.GetHashCode() == copy.GetHashCode());
+		CHECK(whole.GetHashCode() == String::GetHashCode(u8"Hello World!"));
+		CHECK(String::GetEmpty().GetHashCode() == String::GetHashCode(u8""));
+
+		CHECK(part == view);
+		CHECK(copy == view);
+		CHECK(!(whole == view));
+		CHECK(copy == u8"World");
+	}
+}
@@ -0,0 +1,175 @@
+#include "doctest.h"
+#include "Engine/System/Thread/Task.h"
+#include "Engine/System/String.h"
+#include <chrono>
+#include <thread>
+
+using namespace Engine;
+
+namespace {
+	Task<int32> CountLeaves(int32 depth) {
+		if (depth == 0) {
+			co_return 1;
+		}
+		int32 left = co_await CountLeaves(depth - 1);
+		int32 right = co_await CountLeaves(depth - 1);
+		co_return left + right;
+	}
+
+	Task<String> JoinWords() {
+		String first = co_await []() -> Task<String> {
+			co_return String(STRL("Paws"));
+		}();
+		co_return first + STRL("Engine");
+	}
+
+	Task<void> IncreaseOnLanes(AtomicValue<int32>* counter) {
+		counter->Add(1);
+		co_await Await::Schedule(Job::Priority::Background);
+		counter->Add(1);
+		co_await Await::Schedule(Job::Priority::Critical);
+		counter->Add(1);
+	}
+
+	Task<int32> WaitFrames(AtomicValue<int32>* stage) {
+		stage->Set(1);
+		co_await Await::NextFrame();
+		stage->Set(2);
+		co_await Await::NextFrame();
+		stage->Set(3);
+		co_return 2;
+	}
+
+	Task<int32> ReadLength(FileSystem* fs, String path) {
+		Await::FileData file = co_await Await::ReadFile(*fs, path);
+		if (file.result != ResultCode::OK) {
+			co_return -1;
+		}
+		co_return file.bytes.GetCount();
+	}
+
+	void WaitForValue(AtomicValue<int32>& value, int32 expected) {
+		while (value.Get() != expected) {
+			std::this_thread::yield();
+		}
+	}
+}
+
+TEST_SUITE("Thread") {
+	TEST_CASE("Task") {
+		JobSystem system{ 2 };
+		system.Start();
+
+		SUBCASE("Awaiting tasks") {
+			Task<int32> task = CountLeaves(6);
+			task.Start(system);
+			CHECK(task.Get() == 64);
+			CHECK(task.IsFinished());
+		}
+		SUBCASE("Move-only work on results") {
+			Task<String> task = JoinWords();
+			task.Start(system);
+			CHECK(task.Get() == STRL("PawsEngine"));
+		}
+		SUBCASE("Switching lanes") {
+			AtomicValue<int32> counter{ 0 };
+			Task<void> task = IncreaseOnLanes(&counter);
+			task.Start(system, Job::Priority::Normal);
+			task.Wait();
+			CHECK(counter.Get() == 3);
+		}
+		SUBCASE("Many started tasks") {
+			Task<int32> tasks[32];
+			for (int32 i = 0; i < 32; i += 1) {
+				tasks[i] = CountLeaves(i % 5);
+			}
+			for (auto& task : tasks) {
+				task.Start(system);
+			}
+			int32 total = 0;
+			for (auto& task : tasks) {
+				total += task.Get();
+			}
+			CHECK(total == 1 * 7 + 2 * 7 + 4 * 6 + 8 * 6 + 16 * 6);
+		}
+
+		system.Stop();
+	}
+
+	TEST_CASE("Task next frame") {
+		JobSystem system{ 1 };
+		system.Start();
+
+		AtomicValue<int32> stage{ 0 };
+		Task<int32> task = WaitFrames(&stage);
+		task.Start(system);
+		WaitForValue(stage, 1);
+
+		// Nothing moves without a frame.
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		CHECK(stage.Get() == 1);
+
+		int32 frames = 0;
+		while (!task.IsFinished()) {
+			system.AdvanceFrame();
+			frames += 1;
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		CHECK(frames >= 2);
+		CHECK(stage.Get() == 3);
+		CHECK(task.Get() == 2);
+
+		system.Stop();
+	}
+
+	TEST_CASE("Task file read") {
+		FileSystem fs;
+		String path = STRL("file://TaskFileTest.txt");
+		{
+			IntrusivePtr<FileStream> file;
+			REQUIRE(fs.TryOpenFile(path, FileSystem::OpenMode::WriteTruncate, file) == ResultCode::OK);
+			file->WriteText(STRL("0123456789"));
+			file->Close();
+		}
+
+		JobSystem system{ 2 };
+		system.Start();
+
+		Task<int32> existing = ReadLength(&fs, path);
+		Task<int32> missing = ReadLength(&fs, STRL("file://TaskFileTestMissing.txt"));
+		existing.Start(system);
+		missing.Start(system);
+		CHECK(existing.Get() == 10);
+		CHECK(missing.Get() == -1);
+
+		system.Stop();
+		fs.RemoveFile(path);
+	}
+
+	TEST_CASE("Task frame allocator") {
+		JobSystem system{ 2 };
+		system.Start();
+
+		auto runRound = [&system]() {
+			Task<int32> tasks[16];
+			for (int32 i = 0; i < 16; i += 1) {
+				tasks[i] = CountLeaves(4);
+				tasks[i].Start(system);
+			}
+			for (auto& task : tasks) {
+				CHECK(task.Get() == 16);
+			}
+		};
+
+		runRound();
+		int32 warm = TaskFrameAllocator::GetChunkCount();
+		CHECK(warm > 0);
+		for (int32 i = 0; i < 16; i += 1) {
+			runRound();
+		}
+		// Frames freed on the workers flow back through the shared lists, the pool stops growing once warm.
+		CHECK(TaskFrameAllocator::GetChunkCount() <= warm + 2);
+
+		system.Stop();
+	}
+}